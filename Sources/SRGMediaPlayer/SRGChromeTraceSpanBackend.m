@@ -0,0 +1,126 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGChromeTraceSpanBackend.h"
+
+#import <pthread.h>
+#import <string.h>
+#import <time.h>
+
+@interface SRGChromeTraceSpanBackend ()
+
+@property (nonatomic) NSURL *fileURL;
+@property (nonatomic) dispatch_queue_t queue;
+
+@end
+
+@implementation SRGChromeTraceSpanBackend {
+@private
+    // Only accessed on the queue
+    FILE *_file;
+    NSUInteger _eventCount;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithFileURL:(NSURL *)fileURL
+{
+    if (self = [super init]) {
+        _file = fopen(fileURL.fileSystemRepresentation, "w");
+        if (! _file) {
+            return nil;
+        }
+        fputs("[", _file);
+        
+        self.fileURL = fileURL;
+        self.queue = dispatch_queue_create("ch.srgssr.SRGMediaPlayer.chromeTrace", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self closeFile];
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    NSString *fileName = [NSString stringWithFormat:@"SRGMediaPlayer-%@.json", NSUUID.UUID.UUIDString];
+    return [self initWithFileURL:[NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:fileName]]];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark File
+
+- (void)close
+{
+    dispatch_sync(self.queue, ^{
+        [self closeFile];
+    });
+}
+
+- (void)closeFile
+{
+    if (! _file) {
+        return;
+    }
+    
+    fputs("\n]\n", _file);
+    fclose(_file);
+    _file = NULL;
+}
+
+#pragma mark Events
+
+- (void)writeEventWithPhase:(char)phase name:(const char *)name identifier:(uint64_t)identifier
+{
+    uint64_t timestamp = clock_gettime_nsec_np(CLOCK_UPTIME_RAW) / NSEC_PER_USEC;
+    uint64_t threadIdentifier = 0;
+    pthread_threadid_np(NULL, &threadIdentifier);
+    
+    // The name is only written later, copy it so that it does not need to outlive the call
+    char *nameCopy = strdup(name);
+    
+    dispatch_async(self.queue, ^{
+        if (! self->_file) {
+            free(nameCopy);
+            return;
+        }
+        
+        // Events are separated by commas, so that the file is valid JSON once completed
+        fputs((self->_eventCount == 0) ? "\n" : ",\n", self->_file);
+        self->_eventCount += 1;
+        
+        fputs("{\"name\":\"", self->_file);
+        for (const char *character = nameCopy; *character != '\0'; ++character) {
+            if (*character == '"' || *character == '\\') {
+                fputc('\\', self->_file);
+            }
+            fputc(*character, self->_file);
+        }
+        fprintf(self->_file, "\",\"cat\":\"SRGMediaPlayer\",\"ph\":\"%c\",\"id\":%llu,\"ts\":%llu,\"pid\":%d,\"tid\":%llu}",
+                phase, identifier, timestamp, getpid(), threadIdentifier);
+        free(nameCopy);
+    });
+}
+
+#pragma mark SRGMediaPlayerSpanBackend protocol
+
+- (void)beginSpanWithName:(const char *)name identifier:(uint64_t)identifier
+{
+    [self writeEventWithPhase:'b' name:name identifier:identifier];
+}
+
+- (void)endSpanWithName:(const char *)name identifier:(uint64_t)identifier
+{
+    [self writeEventWithPhase:'e' name:name identifier:identifier];
+}
+
+@end
@@ -0,0 +1,21 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMark.h"
+#import "SRGMarkValue.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGMark (Private)
+
+/**
+ *  The mark as a plain value.
+ */
+@property (nonatomic, readonly) SRGMarkValue value;
+
+@end
+
+NS_ASSUME_NONNULL_END
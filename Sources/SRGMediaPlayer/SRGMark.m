@@ -4,13 +4,16 @@
 //  License information is available from the LICENSE file.
 //
 
-#import "SRGMark.h"
+#import "SRGMark+Private.h"
 
 #import "SRGMediaPlayerController+Private.h"
 
-@interface SRGMark ()
+@interface SRGMark () {
+@private
+    SRGMarkValue _value;
+}
 
-@property (nonatomic) CMTime time;
+@property (nonatomic, readonly) CMTime time;
 @property (nonatomic) NSDate *date;
 
 @end
@@ -40,17 +43,29 @@
 {
     if (self = [super init]) {
         if (date) {
-            self.time = kCMTimeZero;
             self.date = date;
+            _value = (SRGMarkValue){ kCMTimeZero, date.timeIntervalSinceReferenceDate, SRGMarkValueFlagDate };
         }
         else {
-            self.time = CMTIME_IS_VALID(time) ? time : kCMTimeZero;
             self.date = nil;
+            _value = (SRGMarkValue){ CMTIME_IS_VALID(time) ? time : kCMTimeZero, 0., SRGMarkValueFlagNone };
         }
     }
     return self;
 }
 
+#pragma mark Getters and setters
+
+- (CMTime)time
+{
+    return _value.time;
+}
+
+- (SRGMarkValue)value
+{
+    return _value;
+}
+
 #pragma mark Time conversions
 
 - (CMTime)timeForMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
@@ -72,22 +87,12 @@
     }
     
     SRGMark *otherMark = object;
-    if (self.date) {
-        return [self.date isEqualToDate:otherMark.date];
-    }
-    else {
-        return CMTIME_COMPARE_INLINE(self.time, ==, otherMark.time);
-    }
+    return SRGMarkValueEqual(_value, otherMark->_value);
 }
 
 - (NSUInteger)hash
 {
-    if (self.date) {
-        return self.date.hash;
-    }
-    else {
-        return @(CMTimeGetSeconds(self.time)).hash;
-    }
+    return SRGMarkValueHash(_value);
 }
 
 #pragma mark Description
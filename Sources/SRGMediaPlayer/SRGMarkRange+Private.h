@@ -0,0 +1,21 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMarkRange.h"
+#import "SRGMarkValue.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGMarkRange (Private)
+
+/**
+ *  The mark range as a plain value.
+ */
+@property (nonatomic, readonly) SRGMarkRangeValue value;
+
+@end
+
+NS_ASSUME_NONNULL_END
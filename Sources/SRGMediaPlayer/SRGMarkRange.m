@@ -4,11 +4,15 @@
 //  License information is available from the LICENSE file.
 //
 
-#import "SRGMarkRange.h"
+#import "SRGMarkRange+Private.h"
 
+#import "SRGMark+Private.h"
 #import "SRGMediaPlayerController+Private.h"
 
-@interface SRGMarkRange ()
+@interface SRGMarkRange () {
+@private
+    SRGMarkRangeValue _value;
+}
 
 @property (nonatomic) SRGMark *fromMark;
 @property (nonatomic) SRGMark *toMark;
@@ -31,10 +35,18 @@
     if (self = [super init]) {
         self.fromMark = fromMark;
         self.toMark = toMark;
+        _value = (SRGMarkRangeValue){ fromMark.value, toMark.value };
     }
     return self;
 }
 
+#pragma mark Getters and setters
+
+- (SRGMarkRangeValue)value
+{
+    return _value;
+}
+
 #pragma mark Time conversions
 
 - (CMTimeRange)timeRangeForMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
@@ -58,12 +70,12 @@
     }
     
     SRGMarkRange *otherMarkRange = object;
-    return [self.fromMark isEqual:otherMarkRange.fromMark] && [self.toMark isEqual:otherMarkRange.toMark];
+    return SRGMarkRangeValueEqual(_value, otherMarkRange->_value);
 }
 
 - (NSUInteger)hash
 {
-    return [NSString stringWithFormat:@"%@_%@", @(self.fromMark.hash), @(self.toMark.hash)].hash;
+    return SRGMarkRangeValueHash(_value);
 }
 
 #pragma mark Description
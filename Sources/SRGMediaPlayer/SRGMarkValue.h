@@ -0,0 +1,118 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import CoreMedia;
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Mark value flags.
+ */
+typedef NS_OPTIONS(uint8_t, SRGMarkValueFlags) {
+    SRGMarkValueFlagNone = 0,
+    SRGMarkValueFlagDate = 1 << 0          // The mark is a date mark.
+};
+
+/**
+ *  Plain value representation of a mark, either a time or a date (stored as a time interval since the reference date).
+ */
+typedef struct {
+    CMTime time;                                        // Time, `kCMTimeZero` for date marks.
+    NSTimeInterval timeIntervalSinceReferenceDate;      // Date, for date marks only.
+    SRGMarkValueFlags flags;
+} SRGMarkValue;
+
+/**
+ *  Plain value representation of a mark range.
+ */
+typedef struct {
+    SRGMarkValue fromValue;
+    SRGMarkValue toValue;
+} SRGMarkRangeValue;
+
+/**
+ *  Return `YES` iff the mark value is a date mark.
+ */
+NS_INLINE BOOL SRGMarkValueIsDate(SRGMarkValue markValue)
+{
+    return (markValue.flags & SRGMarkValueFlagDate) != 0;
+}
+
+/**
+ *  Return `YES` iff the mark range value has at least one date mark.
+ */
+NS_INLINE BOOL SRGMarkRangeValueHasDate(SRGMarkRangeValue markRangeValue)
+{
+    return SRGMarkValueIsDate(markRangeValue.fromValue) || SRGMarkValueIsDate(markRangeValue.toValue);
+}
+
+/**
+ *  Return `YES` iff both mark values are equal. Time marks are compared numerically, independently of their timescale.
+ */
+NS_INLINE BOOL SRGMarkValueEqual(SRGMarkValue markValue1, SRGMarkValue markValue2)
+{
+    if (SRGMarkValueIsDate(markValue1) != SRGMarkValueIsDate(markValue2)) {
+        return NO;
+    }
+    else if (SRGMarkValueIsDate(markValue1)) {
+        return markValue1.timeIntervalSinceReferenceDate == markValue2.timeIntervalSinceReferenceDate;
+    }
+    else {
+        return CMTIME_COMPARE_INLINE(markValue1.time, ==, markValue2.time);
+    }
+}
+
+/**
+ *  Hash a double, consistently with floating-point equality.
+ */
+NS_INLINE NSUInteger SRGMarkValueHashDouble(double value)
+{
+    // Ensure -0 and +0 hash to the same value
+    if (value == 0.) {
+        return 0;
+    }
+    
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    bits ^= bits >> 33;
+    bits *= 0xff51afd7ed558ccdULL;
+    bits ^= bits >> 33;
+    return (NSUInteger)bits;
+}
+
+/**
+ *  Return a hash consistent with `SRGMarkValueEqual`.
+ */
+NS_INLINE NSUInteger SRGMarkValueHash(SRGMarkValue markValue)
+{
+    if (SRGMarkValueIsDate(markValue)) {
+        return SRGMarkValueHashDouble(markValue.timeIntervalSinceReferenceDate) ^ SRGMarkValueFlagDate;
+    }
+    else {
+        return SRGMarkValueHashDouble(CMTimeGetSeconds(markValue.time));
+    }
+}
+
+/**
+ *  Return `YES` iff both mark range values are equal.
+ */
+NS_INLINE BOOL SRGMarkRangeValueEqual(SRGMarkRangeValue markRangeValue1, SRGMarkRangeValue markRangeValue2)
+{
+    return SRGMarkValueEqual(markRangeValue1.fromValue, markRangeValue2.fromValue) && SRGMarkValueEqual(markRangeValue1.toValue, markRangeValue2.toValue);
+}
+
+/**
+ *  Return a hash consistent with `SRGMarkRangeValueEqual`.
+ */
+NS_INLINE NSUInteger SRGMarkRangeValueHash(SRGMarkRangeValue markRangeValue)
+{
+    NSUInteger fromHash = SRGMarkValueHash(markRangeValue.fromValue);
+    NSUInteger toHash = SRGMarkValueHash(markRangeValue.toValue);
+    return (fromHash * 31) ^ toHash;
+}
+
+NS_ASSUME_NONNULL_END
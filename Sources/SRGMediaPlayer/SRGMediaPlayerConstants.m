@@ -24,9 +24,17 @@ NSString * const SRGMediaPlayerSubtitleTrackDidChangeNotification = @"SRGMediaPl
 NSString * const SRGMediaPlayerSegmentDidStartNotification = @"SRGMediaPlayerSegmentDidStartNotification";
 NSString * const SRGMediaPlayerSegmentDidEndNotification = @"SRGMediaPlayerSegmentDidEndNotification";
 
+NSString * const SRGMediaPlayerChildSegmentDidStartNotification = @"SRGMediaPlayerChildSegmentDidStartNotification";
+NSString * const SRGMediaPlayerChildSegmentDidEndNotification = @"SRGMediaPlayerChildSegmentDidEndNotification";
+
 NSString * const SRGMediaPlayerWillSkipBlockedSegmentNotification = @"SRGMediaPlayerWillSkipBlockedSegmentNotification";
 NSString * const SRGMediaPlayerDidSkipBlockedSegmentNotification = @"SRGMediaPlayerDidSkipBlockedSegmentNotification";
 
+NSString * const SRGMediaPlayerSegmentsDidChangeNotification = @"SRGMediaPlayerSegmentsDidChangeNotification";
+NSString * const SRGMediaPlayerVisibleSegmentsDidChangeNotification = @"SRGMediaPlayerVisibleSegmentsDidChangeNotification";
+
+NSString * const SRGMediaPlayerPropertiesDidChangeNotification = @"SRGMediaPlayerPropertiesDidChangeNotification";
+
 NSString * const SRGMediaPlayerPlaybackStateKey = @"SRGMediaPlayerPlaybackState";
 NSString * const SRGMediaPlayerPreviousPlaybackStateKey = @"SRGMediaPlayerPreviousPlaybackState";
 NSString * const SRGMediaPlayerPreviousContentURLKey = @"SRGMediaPlayerPreviousContentURL";
@@ -44,8 +52,12 @@ NSString * const SRGMediaPlayerSeekDateKey = @"SRGMediaPlayerSeekDate";
 
 NSString * const SRGMediaPlayerSegmentKey = @"SRGMediaPlayerSegment";
 
+NSString * const SRGMediaPlayerSkippedSegmentsKey = @"SRGMediaPlayerSkippedSegments";
+
 NSString * const SRGMediaPlayerSelectedKey = @"SRGMediaPlayerSelected";
 
+NSString * const SRGMediaPlayerParentSegmentKey = @"SRGMediaPlayerParentSegment";
+
 NSString * const SRGMediaPlayerPreviousSegmentKey = @"SRGMediaPlayerPreviousSegment";
 
 NSString * const SRGMediaPlayerNextSegmentKey = @"SRGMediaPlayerNextSegment";
@@ -54,6 +66,15 @@ NSString * const SRGMediaPlayerInterruptionKey = @"SRGMediaPlayerInterruption";
 NSString * const SRGMediaPlayerSelectionKey = @"SRGMediaPlayerSelection";
 NSString * const SRGMediaPlayerSelectionReasonKey = @"SRGMediaPlayerSelectionReason";
 
+NSString * const SRGMediaPlayerInsertedIndexesKey = @"SRGMediaPlayerInsertedIndexes";
+NSString * const SRGMediaPlayerRemovedIndexesKey = @"SRGMediaPlayerRemovedIndexes";
+NSString * const SRGMediaPlayerUpdatedIndexesKey = @"SRGMediaPlayerUpdatedIndexes";
+NSString * const SRGMediaPlayerMovedIndexesKey = @"SRGMediaPlayerMovedIndexes";
+
+NSString * const SRGMediaPlayerChangedPropertiesKey = @"SRGMediaPlayerChangedProperties";
+NSString * const SRGMediaPlayerPreviousValuesKey = @"SRGMediaPlayerPreviousValues";
+NSString * const SRGMediaPlayerValuesKey = @"SRGMediaPlayerValues";
+
 NSString * const SRGMediaPlayerTrackKey = @"SRGMediaPlayerTrack";
 NSString * const SRGMediaPlayerPreviousTrackKey = @"SRGMediaPlayerPreviousTrack";
 
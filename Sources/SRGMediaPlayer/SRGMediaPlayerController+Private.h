@@ -65,6 +65,38 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (CMTimeRange)streamTimeRangeForMarkRange:(SRGMarkRange *)markRange;
 
+/**
+ *  Return the time range corresponding to a segment, in the stream reference frame. Ranges of loaded segments are
+ *  resolved once per segment list and reference date, and cached until one of these changes.
+ *
+ *  @discussion Segments which have not been loaded into the controller are resolved on the fly.
+ */
+- (CMTimeRange)streamTimeRangeForSegment:(id<SRGSegment>)segment;
+
+/**
+ *  Return the index of the specified segment (compared by identity) in `visibleSegments`, in constant time. Return
+ *  `NSNotFound` if the segment is not visible.
+ */
+- (NSUInteger)visibleIndexForSegment:(nullable id<SRGSegment>)segment;
+
+/**
+ *  Seek to a position while scrubbing. Unlike `-seekToPosition:withCompletionHandler:`, which supersedes any seek being
+ *  made, scrubbing seeks are coalesced so that at most one seek is in flight and one is pending. Intermediate targets
+ *  are dropped, their completion handlers being called with `finished` set to `NO`.
+ */
+- (void)scrubToPosition:(nullable SRGPosition *)position withCompletionHandler:(nullable void (^)(BOOL finished))completionHandler;
+
+/**
+ *  Apply the stall recovery policy, as done when playback stays stalled for longer than `stallRecoveryDelay`.
+ */
+- (void)recoverFromStall;
+
+/**
+ *  Restore the peak bitrate lowered by stall recovery, as done once playback is stable again. Does nothing if the
+ *  peak bitrate was not lowered.
+ */
+- (void)restorePreferredPeakBitRate;
+
 @end
 
 NS_ASSUME_NONNULL_END
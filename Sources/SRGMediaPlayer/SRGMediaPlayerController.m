@@ -14,14 +14,25 @@
 #import "NSBundle+SRGMediaPlayer.h"
 #import "NSTimer+SRGMediaPlayer.h"
 #import "SRGActivityGestureRecognizer.h"
+#import "SRGMark+Private.h"
+#import "SRGMarkRange+Private.h"
 #import "SRGMediaAccessibility.h"
 #import "SRGMediaPlayerError.h"
 #import "SRGMediaPlayerLogger.h"
+#import "SRGMediaPlayerSnapshot+Private.h"
+#import "SRGMediaPlayerSpans+Private.h"
 #import "SRGMediaPlayerView.h"
 #import "SRGMediaPlayerView+Private.h"
-#import "SRGPeriodicTimeObserver.h"
+#import "SRGPlaybackClock.h"
+#import "SRGPlaybackInformation.h"
+#import "SRGPlaybackMetricsCollector.h"
+#import "SRGPlaybackStateMachine.h"
+#import "SRGPlaybackTrace.h"
 #import "SRGPlayer.h"
-#import "SRGSegment+Private.h"
+#import "SRGSeekScheduler.h"
+#import "SRGSegmentDiff.h"
+#import "SRGSegmentIndex.h"
+#import "SRGTimeDateMapping.h"
 #import "SRGTimePosition.h"
 #import "UIDevice+SRGMediaPlayer.h"
 #import "UIScreen+SRGMediaPlayer.h"
@@ -41,10 +52,39 @@ static CMTime SRGSafeStartSeekOffset(void)
     return [AVAudioSession srg_isBluetoothHeadsetActive] ? CMTimeMakeWithSeconds(0.3, NSEC_PER_SEC) : SRGSafeSeekOffset();
 }
 
+// Boundary time observers might be called slightly before the boundary is actually reached
+static CMTime SRGBoundaryTimeTolerance(void)
+{
+    return CMTimeMakeWithSeconds(0.05, NSEC_PER_SEC);
+}
+
+// Stream date samples deviating from the time / date mapping by less than this tolerance are ignored
+static NSTimeInterval const SRGTimeDateMappingTolerance = 0.5;
+
+// The stream date is briefly misaligned with the playhead after a seek. Samples are only taken once this delay has
+// elapsed since the last seek ended
+static NSTimeInterval const SRGTimeDateMappingSeekSettleDelay = 1.;
+
+// A peak bitrate lowered by stall recovery is restored once playback has not stalled again for this delay
+static NSTimeInterval const SRGPeakBitRateRestorationDelay = 30.;
+
+// Playback information is refreshed more frequently when playback is closer than this distance to a segment boundary
+// or to the live tolerance threshold, so that associated changes are reported with minimal delay
+static NSTimeInterval const SRGRefreshBoostDistance = 2.;
+
+// Offset after the end of on-demand streams at which playback is considered to have continued past the end
+static CMTime SRGEndBoundaryOffset(void)
+{
+    return CMTimeMakeWithSeconds(0.1, NSEC_PER_SEC);
+}
+
 static NSError *SRGMediaPlayerControllerError(NSError *underlyingError);
 static NSString *SRGMediaPlayerControllerNameForPlaybackState(SRGMediaPlayerPlaybackState playbackState);
 static NSString *SRGMediaPlayerControllerNameForMediaType(SRGMediaPlayerMediaType mediaType);
 static NSString *SRGMediaPlayerControllerNameForStreamType(SRGMediaPlayerStreamType streamType);
+static NSString *SRGMediaPlayerControllerNameForRefreshFrequency(SRGMediaPlayerRefreshFrequency refreshFrequency);
+static NSTimeInterval SRGMediaPlayerControllerRefreshInterval(SRGMediaPlayerRefreshFrequency refreshFrequency);
+static NSString *SRGMediaPlayerControllerKeyForProperty(SRGMediaPlayerProperties property);
 
 static SRGTimePosition *SRGMediaPlayerControllerPositionInTimeRange(SRGTimePosition *timePosition, CMTimeRange timeRange, CMTime startOffset, CMTime endOffset);
 
@@ -61,6 +101,12 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
     CMTimeRange _timeRange;
     SRGMediaPlayerStreamType _streamType;
     BOOL _live;
+    SRGSegmentTransition _pendingSegmentTransition;
+    NSUInteger _lastSeekSequenceNumber;
+    BOOL _playbackProgressed;
+    NSUInteger _traceCapacity;
+    SRGPlaybackTrace *_trace;
+    CMTimeRange _tracedSeekableTimeRange;
 }
 
 @property (nonatomic) SRGPlayer *player;
@@ -82,20 +128,36 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
 
 @property (nonatomic) NSArray<id<SRGSegment>> *loadedSegments;
 @property (nonatomic) NSArray<id<SRGSegment>> *visibleSegments;
+@property (nonatomic) NSMapTable<id<SRGSegment>, NSNumber *> *visibleSegmentIndexes;
+@property (nonatomic) SRGSegmentIndex *segmentIndex;
 
-@property (nonatomic) NSMutableDictionary<NSString *, SRGPeriodicTimeObserver *> *periodicTimeObservers;
-@property (nonatomic) id playerPeriodicTimeObserver;        // AVPlayer time observer, needs to be retained according to the documentation
+@property (nonatomic) SRGPlaybackClock *playbackClock;
+@property (nonatomic) id playerBoundaryTimeObserver;        // AVPlayer time observer, needs to be retained according to the documentation
+@property (nonatomic, weak) AVPlayer *playerBoundaryTimeObserverPlayer;  // Player the boundary observer was registered with
 @property (nonatomic, weak) id controllerPeriodicTimeObserver;
+@property (nonatomic) SRGMediaPlayerRefreshFrequency refreshFrequency;
+@property (nonatomic) NSTimeInterval lastRefreshSystemUptime;
+@property (nonatomic, getter=isApplicationInBackground) BOOL applicationInBackground;
 
 @property (nonatomic) SRGMediaPlayerMediaType mediaType;
 @property (nonatomic, getter=isTimeRangeCached) BOOL playbackInformationCached;
 
-@property (nonatomic) CMTime referenceTime;
-@property (nonatomic) NSDate *referenceDate;
+@property (nonatomic) SRGTimeDateMapping *timeDateMapping;
+
+@property (nonatomic) SRGMediaPlayerProperties pendingChangedProperties;
+@property (nonatomic) NSMutableDictionary<NSNumber *, id> *pendingPreviousValues;
 
-@property (nonatomic) NSTimer *stallDetectionTimer;
-@property (nonatomic) CMTime lastPlaybackTime;
-@property (nonatomic) NSDate *lastStallDetectionDate;
+@property (nonatomic) SRGMediaPlayerStallRecoveryPolicy stallRecoveryPolicy;
+@property (nonatomic) NSTimeInterval stallRecoveryDelay;
+@property (nonatomic) NSTimer *stallRecoveryTimer;
+@property (nonatomic) NSNumber *originalPreferredPeakBitRate;           // Set while lowered by stall recovery
+@property (nonatomic) NSTimer *peakBitRateRestorationTimer;
+@property (nonatomic) NSDate *lastStallStartDate;
+@property (nonatomic) NSDate *lastStallEndDate;
+
+@property (nonatomic) SRGPlaybackMetricsCollector *metricsCollector;
+
+@property (nonatomic) SRGSeekScheduler *seekScheduler;
 
 // Saved values supplied when playback is started
 @property (nonatomic, weak) id<SRGSegment> initialTargetSegment;
@@ -103,10 +165,20 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
 
 @property (nonatomic, weak) id<SRGSegment> previousSegment;
 @property (nonatomic, weak) id<SRGSegment> currentSegment;
+@property SRGMediaPlayerSnapshot *snapshot;                         // Atomic, can be read from any thread
+@property (nonatomic, weak) id<SRGSegment> currentChildSegment;
 
 @property (nonatomic, weak) id<SRGSegment> targetSegment;           // Will be nilled when reached
 @property (nonatomic) SRGMediaPlayerSelectionReason selectionReason;
 
+// Immutable, replaced on registration and removal so that delivery can enumerate them in place
+@property (nonatomic) NSArray<void (^)(SRGSegmentTransition)> *segmentTransitionObservers;
+@property (nonatomic) NSArray<NSNumber *> *segmentTransitionObserverTokens;
+@property (nonatomic) NSUInteger lastSegmentTransitionObserverToken;
+@property (nonatomic) id<SRGSegment> pendingTransitionPreviousSegment;      // Retained until the pending transition is delivered
+@property (nonatomic) id<SRGSegment> pendingTransitionSegment;              // Retained until the pending transition is delivered
+@property (nonatomic, getter=isSegmentTransitionDeliveryScheduled) BOOL segmentTransitionDeliveryScheduled;
+
 @property (nonatomic, getter=isPictureInPictureEnabled) BOOL pictureInPictureEnabled API_AVAILABLE(ios(9.0), tvos(14.0));
 @property (nonatomic) AVPictureInPictureController *pictureInPictureController API_AVAILABLE(ios(9.0), tvos(14.0));
 @property (nonatomic, copy) void (^pictureInPictureControllerCreationBlock)(AVPictureInPictureController *pictureInPictureController) API_AVAILABLE(ios(9.0), tvos(14.0));
@@ -149,9 +221,18 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
         self.endTolerance = SRGMediaPlayerDefaultEndTolerance;
         self.endToleranceRatio = SRGMediaPlayerDefaultEndToleranceRatio;
         
-        self.periodicTimeObservers = [NSMutableDictionary dictionary];
+        self.playbackClock = [[SRGPlaybackClock alloc] init];
+        self.segmentTransitionObservers = @[];
+        self.segmentTransitionObserverTokens = @[];
+        self.pendingPreviousValues = [NSMutableDictionary dictionary];
+        
+        self.stallRecoveryPolicy = SRGMediaPlayerStallRecoveryPolicyNudge;
+        self.stallRecoveryDelay = SRGMediaPlayerDefaultStallRecoveryDelay;
         
-        self.lastPlaybackTime = kCMTimeIndefinite;
+        self.metricsCollector = [[SRGPlaybackMetricsCollector alloc] init];
+        self.seekScheduler = [[SRGSeekScheduler alloc] init];
+        
+        [self publishSnapshot];
     }
     return self;
 }
@@ -159,6 +240,8 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
 - (void)dealloc
 {
     [self reset];
+    
+    SRGPlaybackTraceDestroy(_trace);
 }
 
 #pragma mark Getters and setters
@@ -174,13 +257,10 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
         [_player removeObserver:self keyPath:@keypath(_player.rate)];
         [_player removeObserver:self keyPath:@keypath(_player.externalPlaybackActive)];
         [_player removeObserver:self keyPath:@keypath(_player.currentItem.presentationSize)];
+        [_player removeObserver:self keyPath:@keypath(_player.timeControlStatus)];
+        [_player removeObserver:self keyPath:@keypath(_player.currentItem.playbackBufferEmpty)];
         
-        [NSNotificationCenter.defaultCenter removeObserver:self
-                                                      name:AVPlayerItemDidPlayToEndTimeNotification
-                                                    object:_player.currentItem];
-        [NSNotificationCenter.defaultCenter removeObserver:self
-                                                      name:AVPlayerItemFailedToPlayToEndTimeNotification
-                                                    object:_player.currentItem];
+        [self unregisterNotificationsForPlayerItem:_player.currentItem];
         [NSNotificationCenter.defaultCenter removeObserver:self
                                                       name:UIApplicationDidEnterBackgroundNotification
                                                     object:nil];
@@ -206,8 +286,11 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
             @strongify(self) @strongify(player)
             
             AVPlayerItem *playerItem = player.currentItem;
+            [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeItemStatus, .value = (uint32_t)playerItem.status }];
+            
             if (playerItem.status == AVPlayerItemStatusReadyToPlay) {
                 [self updatePlaybackInformationForPlayer:player];
+                [self recordFirstFrameForPlayer:player];
                 
                 // Playback start. Use received start parameters, do not update the playback state yet, wait until the
                 // completion handler has been executed (since it might immediately start playback)
@@ -228,9 +311,7 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
                         
                         // If the state of the player was not changed in the completion handler (still preparing), update
                         // it
-                        if (self.playbackState == SRGMediaPlayerPlaybackStatePreparing) {
-                            [self setPlaybackState:(player.rate == 0.f) ? SRGMediaPlayerPlaybackStatePaused : SRGMediaPlayerPlaybackStatePlaying withUserInfo:nil];
-                        }
+                        [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeStartCompleted forPlayer:player atEnd:NO];
                     };
                     
                     SRGTimePosition *startTimePosition = [self timePositionForPosition:self.startPosition inSegment:self.targetSegment applyEndTolerance:YES];
@@ -258,6 +339,7 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
             @strongify(self) @strongify(player)
             
             AVPlayerItem *playerItem = player.currentItem;
+            [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeRate, .rate = player.rate }];
             
             // Only respond to rate changes when the item is ready to play 
             if (playerItem.status != AVPlayerItemStatusReadyToPlay) {
@@ -267,18 +349,11 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
             CMTime currentTime = playerItem.currentTime;
             CMTimeRange timeRange = self.timeRange;
             
-            // Update the playback state immediately, except when reaching the end or seeking. Non-streamed medias will namely reach the paused state right before
-            // the item end notification is received. We can eliminate this pause by checking if we are at the end or not. Also update the state for
-            // live streams (empty range)
-            if (self.playbackState != SRGMediaPlayerPlaybackStateEnded
-                     && self.playbackState != SRGMediaPlayerPlaybackStateSeeking
-                     && (CMTIMERANGE_IS_EMPTY(timeRange) || CMTIME_COMPARE_INLINE(currentTime, !=, CMTimeRangeGetEnd(timeRange)))) {
-                [self setPlaybackState:(player.rate == 0.f) ? SRGMediaPlayerPlaybackStatePaused : SRGMediaPlayerPlaybackStatePlaying withUserInfo:nil];
-            }
-            // Playback restarted after it ended (see -play and -pause)
-            else if (self.playbackState == SRGMediaPlayerPlaybackStateEnded && player.rate != 0.f) {
-                [self setPlaybackState:SRGMediaPlayerPlaybackStatePlaying withUserInfo:nil];
-            }
+            // Non-streamed medias will reach the paused state right before the item end notification is received. We can
+            // eliminate this pause by checking if we are at the end or not (never the case for live streams, whose range is
+            // empty)
+            BOOL atEnd = ! CMTIMERANGE_IS_EMPTY(timeRange) && CMTIME_COMPARE_INLINE(currentTime, ==, CMTimeRangeGetEnd(timeRange));
+            [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeRateChanged forPlayer:player atEnd:atEnd];
         }];
         
         [player srg_addMainThreadObserver:self keyPath:@keypath(player.externalPlaybackActive) options:0 block:^(MAKVONotification *notification) {
@@ -308,14 +383,17 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
             [self updateMediaTypeForPlayerItem:playerItem];
         }];
         
-        [NSNotificationCenter.defaultCenter addObserver:self
-                                               selector:@selector(srg_mediaPlayerController_playerItemDidPlayToEndTime:)
-                                                   name:AVPlayerItemDidPlayToEndTimeNotification
-                                                 object:player.currentItem];
-        [NSNotificationCenter.defaultCenter addObserver:self
-                                               selector:@selector(srg_mediaPlayerController_playerItemFailedToPlayToEndTime:)
-                                                   name:AVPlayerItemFailedToPlayToEndTimeNotification
-                                                 object:player.currentItem];
+        [player srg_addMainThreadObserver:self keyPath:@keypath(player.timeControlStatus) options:0 block:^(MAKVONotification * _Nonnull notification) {
+            @strongify(self) @strongify(player)
+            [self updateStallStatusForPlayer:player];
+        }];
+        
+        [player srg_addMainThreadObserver:self keyPath:@keypath(player.currentItem.playbackBufferEmpty) options:0 block:^(MAKVONotification * _Nonnull notification) {
+            @strongify(self) @strongify(player)
+            [self updateStallStatusForPlayer:player];
+        }];
+        
+        [self registerNotificationsForPlayerItem:player.currentItem];
         [NSNotificationCenter.defaultCenter addObserver:self
                                                selector:@selector(srg_mediaPlayerController_applicationDidEnterBackground:)
                                                    name:UIApplicationDidEnterBackgroundNotification
@@ -329,10 +407,16 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
     }
 }
 
-- (void)setStallDetectionTimer:(NSTimer *)stallDetectionTimer
+- (void)setStallRecoveryTimer:(NSTimer *)stallRecoveryTimer
 {
-    [_stallDetectionTimer invalidate];
-    _stallDetectionTimer = stallDetectionTimer;
+    [_stallRecoveryTimer invalidate];
+    _stallRecoveryTimer = stallRecoveryTimer;
+}
+
+- (void)setPeakBitRateRestorationTimer:(NSTimer *)peakBitRateRestorationTimer
+{
+    [_peakBitRateRestorationTimer invalidate];
+    _peakBitRateRestorationTimer = peakBitRateRestorationTimer;
 }
 
 - (AVPlayerLayer *)playerLayer
@@ -360,12 +444,17 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
         [fullUserInfo addEntriesFromDictionary:userInfo];
     }
     
+    [self willChangeProperties:SRGMediaPlayerPropertyPlaybackState];
+    
     [self willChangeValueForKey:@keypath(self.playbackState)];
     _playbackState = playbackState;
     [self didChangeValueForKey:@keypath(self.playbackState)];
     
-    [self updateStallDetectionTimerForPlaybackState:playbackState];
+    [self updateStallRecoveryForPlaybackState:playbackState previousPlaybackState:previousPlaybackState];
+    [self updateMetricsForPlaybackState:playbackState previousPlaybackState:previousPlaybackState];
     [self updateSegmentStatusForPlaybackState:playbackState previousPlaybackState:previousPlaybackState time:self.currentTime];
+    [self updateRefreshFrequencyForPlayer:self.player];
+    [self publishSnapshot];
     
     [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerPlaybackStateDidChangeNotification
                                                       object:self
@@ -380,6 +469,8 @@ static AVMediaSelectionOption *SRGMediaPlayerControllerSubtitleForcedLanguageOpt
         return;
     }
     
+    [self willChangeProperties:SRGMediaPlayerPropertyMediaType];
+    
     [self willChangeValueForKey:@keypath(self.mediaType)];
     _mediaType = mediaType;
     [self didChangeValueForKey:@keypath(self.mediaType)];
@@ -395,6 +486,21 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     BOOL liveChange = (live != _live);
     BOOL effectivePlaybackRateChange = (effectivePlaybackRate != _effectivePlaybackRate);
     
+    SRGMediaPlayerProperties changedProperties = 0;
+    if (timeRangeChange) {
+        changedProperties |= SRGMediaPlayerPropertyTimeRange;
+    }
+    if (streamTypeChange) {
+        changedProperties |= SRGMediaPlayerPropertyStreamType;
+    }
+    if (liveChange) {
+        changedProperties |= SRGMediaPlayerPropertyLive;
+    }
+    if (effectivePlaybackRateChange) {
+        changedProperties |= SRGMediaPlayerPropertyEffectivePlaybackRate;
+    }
+    [self willChangeProperties:changedProperties];
+    
     if (timeRangeChange) {
         [self willChangeValueForKey:@keypath(self.timeRange)];
     }
@@ -415,6 +521,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     
     if (timeRangeChange) {
         [self didChangeValueForKey:@keypath(self.timeRange)];
+        [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeTimeRange, .timeRange = { CMTimeGetSeconds(timeRange.start), CMTimeGetSeconds(timeRange.duration) } }];
     }
     if (streamTypeChange) {
         [self didChangeValueForKey:@keypath(self.streamType)];
@@ -425,6 +532,13 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     if (effectivePlaybackRateChange) {
         [self didChangeValueForKey:@keypath(self.effectivePlaybackRate)];
     }
+    
+    // The end of on-demand streams is observed with a boundary
+    if ((timeRangeChange && streamType == SRGMediaPlayerStreamTypeOnDemand) || streamTypeChange) {
+        [self updateBoundaryTimeObserverForPlayer:self.player];
+    }
+    
+    [self publishSnapshot];
 }
 
 - (CMTimeRange)timeRange
@@ -442,6 +556,12 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     return _live;
 }
 
+- (void)setCurrentSegment:(id<SRGSegment>)currentSegment
+{
+    _currentSegment = currentSegment;
+    [self publishSnapshot];
+}
+
 - (NSArray<id<SRGSegment>> *)segments
 {
     return self.loadedSegments;
@@ -455,55 +575,133 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 
 - (void)setLoadedSegments:(NSArray<id<SRGSegment>> *)segments
 {
+    NSArray<id<SRGSegment>> *previousSegments = _loadedSegments ?: @[];
+    NSArray<id<SRGSegment>> *previousVisibleSegments = self.visibleSegments ?: @[];
+    
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:previousSegments segments:segments ?: @[]];
+    
+    // Only update if a segment equivalent to the previous one was found (segment transition processing will update
+    // the previous segment otherwise). Same for target and current segments.
     if (segments && self.previousSegment) {
-        NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(id<SRGSegment> _Nonnull segment, NSDictionary<NSString *, id> *_Nullable bindings) {
-            return SRGMediaPlayerAreEqualSegments(segment, self.previousSegment);
-        }];
-        
-        // Only update if a segment equivalent to the previous one was found (segment transition processing will update
-        // the previous segment otherwise)
-        id<SRGSegment> segment = [segments filteredArrayUsingPredicate:predicate].firstObject;
+        id<SRGSegment> segment = [segmentDiff segmentEqualToSegment:self.previousSegment];
         if (segment) {
             self.previousSegment = segment;
         }
     }
     if (segments && self.targetSegment) {
-        NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(id<SRGSegment> _Nonnull segment, NSDictionary<NSString *, id> *_Nullable bindings) {
-            return SRGMediaPlayerAreEqualSegments(segment, self.targetSegment);
-        }];
-        
-        // Similar to comment above
-        id<SRGSegment> segment = [segments filteredArrayUsingPredicate:predicate].firstObject;
+        id<SRGSegment> segment = [segmentDiff segmentEqualToSegment:self.targetSegment];
         if (segment) {
             self.targetSegment = segment;
         }
     }
     if (segments && self.currentSegment) {
-        NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(id<SRGSegment> _Nonnull segment, NSDictionary<NSString *, id> *_Nullable bindings) {
-            return SRGMediaPlayerAreEqualSegments(segment, self.currentSegment);
-        }];
-        
-        // Similar to comment above
-        id<SRGSegment> segment = [segments filteredArrayUsingPredicate:predicate].firstObject;
+        id<SRGSegment> segment = [segmentDiff segmentEqualToSegment:self.currentSegment];
         if (segment) {
             self.currentSegment = segment;
         }
     }
     
     _loadedSegments = segments;
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSegments, .value = (uint32_t)segments.count }];
+    
+    [self reloadVisibleSegments];
+    [self reloadSegmentIndex];
+    
+    if (segmentDiff.hasChanges) {
+        [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerSegmentsDidChangeNotification
+                                                          object:self
+                                                        userInfo:segmentDiff.userInfo];
+        
+        SRGSegmentDiff *visibleSegmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:previousVisibleSegments segments:self.visibleSegments ?: @[]];
+        if (visibleSegmentDiff.hasChanges) {
+            [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerVisibleSegmentsDidChangeNotification
+                                                              object:self
+                                                            userInfo:visibleSegmentDiff.userInfo];
+        }
+    }
+}
+
+// Resolve and index segment time ranges. Since resolved ranges only depend on the segment list and on the reference
+// date / time pair, they are only calculated again when one of these changes.
+- (void)reloadSegmentIndex
+{
+    self.segmentIndex = [self segmentIndexForSegments:self.loadedSegments ?: @[] parentTimeRanges:nil];
+    [self updateBoundaryTimeObserverForPlayer:self.player];
+}
+
+// Build the index for the specified segments and, recursively, for their children. If provided, parent time ranges
+// (in the same order as the segments) are used to clip segment time ranges.
+- (SRGSegmentIndex *)segmentIndexForSegments:(NSArray<id<SRGSegment>> *)segments parentTimeRanges:(NSArray<NSValue *> *)parentTimeRanges
+{
+    NSMutableArray<NSValue *> *timeRanges = [NSMutableArray arrayWithCapacity:segments.count];
+    NSMutableArray<id<SRGSegment>> *childSegments = [NSMutableArray array];
+    NSMutableArray<NSValue *> *childParentTimeRanges = [NSMutableArray array];
+    
+    [segments enumerateObjectsUsingBlock:^(id<SRGSegment> _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
+        CMTimeRange timeRange = [self streamTimeRangeForMarkRange:segment.srg_markRange];
+        if (parentTimeRanges) {
+            timeRange = CMTimeRangeGetIntersection(timeRange, parentTimeRanges[idx].CMTimeRangeValue);
+        }
+        
+        NSValue *timeRangeValue = [NSValue valueWithCMTimeRange:timeRange];
+        [timeRanges addObject:timeRangeValue];
+        
+        if ([segment respondsToSelector:@selector(srg_childSegments)]) {
+            for (id<SRGSegment> childSegment in segment.srg_childSegments) {
+                [childSegments addObject:childSegment];
+                [childParentTimeRanges addObject:timeRangeValue];
+            }
+        }
+    }];
+    
+    SRGSegmentIndex *childSegmentIndex = (childSegments.count != 0) ? [self segmentIndexForSegments:childSegments.copy parentTimeRanges:childParentTimeRanges.copy] : nil;
+    return [[SRGSegmentIndex alloc] initWithSegments:segments timeRanges:timeRanges.copy childSegmentIndex:childSegmentIndex];
+}
+
+- (void)reloadSegmentIndexForReferenceChange
+{
+    // Time-based segment ranges do not depend on the reference
+    if (self.segmentIndex.dateDependent) {
+        [self reloadSegmentIndex];
+    }
+}
+
+// Build the visible segment list, as well as the reverse mapping from visible segments to their index in this list
+- (void)reloadVisibleSegments
+{
+    NSArray<id<SRGSegment>> *segments = self.loadedSegments;
+    if (! segments) {
+        self.visibleSegments = nil;
+        self.visibleSegmentIndexes = nil;
+        return;
+    }
+    
+    NSMutableArray<id<SRGSegment>> *visibleSegments = [NSMutableArray arrayWithCapacity:segments.count];
+    NSMapTable<id<SRGSegment>, NSNumber *> *visibleSegmentIndexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality | NSPointerFunctionsStrongMemory
+                                                                                         valueOptions:NSPointerFunctionsStrongMemory];
+    for (id<SRGSegment> segment in segments) {
+        if (segment.srg_hidden) {
+            continue;
+        }
+        
+        if (! [visibleSegmentIndexes objectForKey:segment]) {
+            [visibleSegmentIndexes setObject:@(visibleSegments.count) forKey:segment];
+        }
+        [visibleSegments addObject:segment];
+    }
     
-    // Reset the cached visible segment list
-    _visibleSegments = nil;
+    self.visibleSegments = visibleSegments.copy;
+    self.visibleSegmentIndexes = visibleSegmentIndexes;
 }
 
-- (NSArray<id<SRGSegment>> *)visibleSegments
+- (NSUInteger)visibleIndexForSegment:(id<SRGSegment>)segment
 {
-    // Cached for faster access
-    if (! _visibleSegments) {
-        NSPredicate *predicate = [NSPredicate predicateWithFormat:@"srg_hidden == NO"];
-        _visibleSegments = [self.segments filteredArrayUsingPredicate:predicate];
+    if (! segment) {
+        return NSNotFound;
     }
-    return _visibleSegments;
+    
+    NSNumber *index = [self.visibleSegmentIndexes objectForKey:segment];
+    return index ? index.unsignedIntegerValue : NSNotFound;
 }
 
 // Called when installing the view by binding it in a storyboard or xib
@@ -529,63 +727,66 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 {
     view.delegate = self;
     
-    if (@available(iOS 9, tvOS 14, *)) {
-        @weakify(self)
-        [view srg_addMainThreadObserver:self keyPath:@keypath(view.readyForDisplay) options:0 block:^(MAKVONotification * _Nonnull notification) {
-            @strongify(self)
+    @weakify(self)
+    [view srg_addMainThreadObserver:self keyPath:@keypath(view.readyForDisplay) options:0 block:^(MAKVONotification * _Nonnull notification) {
+        @strongify(self)
+        [self recordFirstFrameForPlayer:self.player];
+        if (@available(iOS 9, tvOS 14, *)) {
             [self updatePictureInPictureForView:view];
-        }];
+        }
+    }];
+    
+    if (@available(iOS 9, tvOS 14, *)) {
         [self updatePictureInPictureForView:view];
     }
     
     [self attachPlayer:self.player toView:view];
 }
 
-- (CMTimeRange)timeRangeForPlayerItem:(AVPlayerItem *)playerItem
+- (SRGPlaybackInformationInput)playbackInformationInputForPlayer:(AVPlayer *)player
 {
-    if (playerItem.status != AVPlayerItemStatusReadyToPlay) {
-        return kCMTimeRangeInvalid;
-    }
-    
-    NSValue *firstSeekableTimeRangeValue = playerItem.seekableTimeRanges.firstObject;
-    NSValue *lastSeekableTimeRangeValue = playerItem.seekableTimeRanges.lastObject;
-    
-    CMTimeRange firstSeekableTimeRange = firstSeekableTimeRangeValue.CMTimeRangeValue;
-    CMTimeRange lastSeekableTimeRange = lastSeekableTimeRangeValue.CMTimeRangeValue;
+    SRGPlaybackInformationInput input = SRGPlaybackInformationInputForPlayerItem(player.currentItem);
     
-    if (! firstSeekableTimeRangeValue || CMTIMERANGE_IS_INVALID(firstSeekableTimeRange)
-            || ! lastSeekableTimeRangeValue || CMTIMERANGE_IS_INVALID(lastSeekableTimeRange)) {
-        return (playerItem.loadedTimeRanges.count != 0) ? kCMTimeRangeZero : kCMTimeRangeInvalid;
-    }
-    
-    CMTimeRange timeRange = CMTimeRangeFromTimeToTime(firstSeekableTimeRange.start, CMTimeRangeGetEnd(lastSeekableTimeRange));
-    
-    // DVR window size too small. Check that we the stream is not an on-demand one first, of course
-    if (CMTIME_IS_INDEFINITE(playerItem.duration) && CMTimeGetSeconds(timeRange.duration) < self.minimumDVRWindowLength) {
-        return CMTimeRangeMake(timeRange.start, kCMTimeZero);
-    }
-    else {
-        return timeRange;
-    }
+    // Seek status is captured along with the current time and date, so that both can be consistently related
+    NSTimeInterval seekEndSystemUptime = self.player.seekEndSystemUptime;
+    input.seeking = ! CMTIME_IS_INDEFINITE(self.seekTargetTime);
+    input.seekElapsedTime = (seekEndSystemUptime != 0.) ? NSProcessInfo.processInfo.systemUptime - seekEndSystemUptime : DBL_MAX;
+    input.minimumDVRWindowLength = self.minimumDVRWindowLength;
+    input.liveTolerance = self.liveTolerance;
+    input.playbackRate = self.playbackRate;
+    input.effectivePlaybackRate = _effectivePlaybackRate;
+    input.cached = self.playbackInformationCached;
+    input.cachedTimeRange = self.timeRange;
+    input.cachedStreamType = self.streamType;
+    return input;
 }
 
+// Capturing the input (seekable and loaded time ranges, current date) is what costs most, and must be made on the main
+// thread as AVFoundation requires. Computing playback information from it is cheap, and therefore made inline.
 - (void)updatePlaybackInformationForPlayer:(AVPlayer *)player
 {
-    AVPlayerItem *playerItem = player.currentItem;
+    SRGMediaPlayerSpanScope("updatePlaybackInformation");
     
-    [self updateMediaTypeForPlayerItem:playerItem];
+    SRGPlaybackInformationInput input = [self playbackInformationInputForPlayer:player];
+    [self traceSeekableTimeRangeWithInput:input];
+    [self applyPlaybackInformation:SRGPlaybackInformationMake(input) withInput:input forPlayer:player];
+}
+
+- (void)applyPlaybackInformation:(SRGPlaybackInformation)playbackInformation withInput:(SRGPlaybackInformationInput)input forPlayer:(AVPlayer *)player
+{
+    [self updateMediaTypeForPlayerItem:player.currentItem];
+    
+    CMTimeRange timeRange = playbackInformation.timeRange;
+    SRGMediaPlayerStreamType streamType = playbackInformation.streamType;
+    float effectivePlaybackRate = playbackInformation.effectivePlaybackRate;
     
-    CMTimeRange timeRange = self.playbackInformationCached ? self.timeRange : [self timeRangeForPlayerItem:playerItem];
-    SRGMediaPlayerStreamType streamType = self.playbackInformationCached ? self.streamType : [self streamTypeForPlayerItem:playerItem timeRange:timeRange];
-    BOOL live = [self isNearLiveEdgeForPlayerItem:playerItem tolerance:self.liveTolerance timeRange:timeRange streamType:streamType];
-    float effectivePlaybackRate = [self effectivePlaybackRateForPlayerItem:playerItem timeRange:timeRange streamType:streamType];
+    [self updateReferenceWithInput:input timeRange:timeRange streamType:streamType];
     
-    [self updateReferenceForPlayerItem:playerItem timeRange:timeRange streamType:streamType];
-    [self setTimeRange:timeRange streamType:streamType live:live effectivePlaybackRate:effectivePlaybackRate];
+    [self setTimeRange:timeRange streamType:streamType live:playbackInformation.live effectivePlaybackRate:effectivePlaybackRate];
     
     // On-demand time ranges are cached because they might become unreliable in some situations (e.g. when AirPlay is
     // connected or disconnected)
-    if (SRG_CMTIME_IS_DEFINITE(playerItem.duration) && SRG_CMTIMERANGE_IS_NOT_EMPTY(timeRange)) {
+    if (SRG_CMTIME_IS_DEFINITE(input.duration) && SRG_CMTIMERANGE_IS_NOT_EMPTY(timeRange)) {
         self.playbackInformationCached = YES;
     }
     
@@ -624,97 +825,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     self.mediaType = CGSizeEqualToSize(presentationSizeValue.CGSizeValue, CGSizeZero) ? SRGMediaPlayerMediaTypeAudio : SRGMediaPlayerMediaTypeVideo;
 }
 
-- (SRGMediaPlayerStreamType)streamTypeForPlayerItem:(AVPlayerItem *)playerItem timeRange:(CMTimeRange)timeRange
-{
-    if (CMTIMERANGE_IS_INVALID(timeRange)) {
-        return SRGMediaPlayerStreamTypeUnknown;
-    }
-    
-    if (CMTIMERANGE_IS_EMPTY(timeRange)) {
-        return SRGMediaPlayerStreamTypeLive;
-    }
-    else {
-        CMTime duration = playerItem.duration;
-        
-        if (CMTIME_IS_INDEFINITE(duration)) {
-            return SRGMediaPlayerStreamTypeDVR;
-        }
-        else if (CMTIME_COMPARE_INLINE(duration, !=, kCMTimeZero)) {
-            return SRGMediaPlayerStreamTypeOnDemand;
-        }
-        else {
-            return SRGMediaPlayerStreamTypeLive;
-        }
-    }
-}
-
-/**
- *  Calculate the effective playback rate. This is required for DVR streams which require the rate to be adjusted near
- *  the live edge to avoid playback issues (playing in the future is not possible) as chunks are added near the live
- *  edge. This method also delivers correct effective playback rates for on-demand and livestreams without DVR.
- *
- *  For a DVR livestreams this method adjusts the playback rate differently depending on where the playhead position
- *  currently is, as follows:
- *
- *
- *                               Restore to desired rate                                 Limit to 1 at most
- *
- *                                 ◀──────────────────                                   ──────────────────▶
- *
- *    ┌─────────────────────────────────────┬────────────────────────────────────────────────────┬───────────────────────────────┐
- *    │                                     │                                                    │                               │
- *    │           Desired rate              │                  Keep current rate                 │         Max rate = 1          │
- *    │                                     │                                                    │                               │
- *    └─────────────────────────────────────┼────────────────────────────────────────────────────┼───────────────────────────────┤
- *                                          │                                                    │                               │
- *
- *                                 kLiveEdgeTolerance +                                   kLiveEdgeTolerance                    Live
- *                                  self.liveTolerance                                                                          edge
- *
- */
-- (float)effectivePlaybackRateForPlayerItem:(AVPlayerItem *)playerItem timeRange:(CMTimeRange)timeRange streamType:(SRGMediaPlayerStreamType)streamType
-{
-    static const NSTimeInterval kLiveEdgeTolerance = 5.;
-    
-    if (streamType == SRGMediaPlayerStreamTypeLive) {
-        return 1.f;
-    }
-    // When the distance from the live edge is below some tolerance we want the effective playback rate to be at most 1,
-    // as larger values would make playback fail when reaching the edge.
-    else if ([self isNearLiveEdgeForPlayerItem:playerItem tolerance:kLiveEdgeTolerance timeRange:timeRange streamType:streamType]) {
-        return fminf(self.playbackRate, 1.f);
-    }
-    // Conversely the playback rate can be restored to the intended rate when getting away from the live edge, but this
-    // cannot happen using the same tolerance as when nearing the edge. Chunks being periodically added would otherwise make
-    // the effective playback rate oscillate between the intended value and 1, which would be awkward. By adding the live
-    // tolerance (which should be larger than a multiple of the chunk size) to the live edge tolerance we obtain a tolerance
-    // at which the desired playback rate can be reliably applied.
-    else if (! [self isNearLiveEdgeForPlayerItem:playerItem tolerance:kLiveEdgeTolerance + self.liveTolerance timeRange:timeRange streamType:streamType]) {
-        return self.playbackRate;
-    }
-    // In between both tolerances, and if fast playback speed is desired, we keep the current effective playback rate. This
-    // ensures the optimal effective playback rate is applied, whether we are nearing the edge or getting away from it.
-    else {
-        return (self.playbackRate > 1.f && _effectivePlaybackRate == 1.f) ? _effectivePlaybackRate : self.playbackRate;
-    }
-}
-
-- (BOOL)isNearLiveEdgeForPlayerItem:(AVPlayerItem *)playerItem tolerance:(NSTimeInterval)tolerance timeRange:(CMTimeRange)timeRange streamType:(SRGMediaPlayerStreamType)streamType
-{
-    NSAssert(tolerance >= 0., @"The tolerance must be >= 0");
-    
-    if (streamType == SRGMediaPlayerStreamTypeLive) {
-        return YES;
-    }
-    else if (streamType == SRGMediaPlayerStreamTypeDVR) {
-        return CMTimeGetSeconds(CMTimeSubtract(CMTimeRangeGetEnd(timeRange), playerItem.currentTime)) < tolerance;
-    }
-    else {
-        return NO;
-    }
-}
-
-- (void)updateReferenceForPlayerItem:(AVPlayerItem *)playerItem timeRange:(CMTimeRange)timeRange streamType:(SRGMediaPlayerStreamType)streamType
+- (void)updateReferenceWithInput:(SRGPlaybackInformationInput)input timeRange:(CMTimeRange)timeRange streamType:(SRGMediaPlayerStreamType)streamType
 {
     // We store synchronized current date and playhead position information for livestreams and update both regularly at the
     // same time. When seeking, these two values might namely be briefly misaligned when read from the player item directly
@@ -723,36 +834,57 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     // If the stream does not embed date information, we use the current date as reference date, mapped to the end of
     // the DVR window. This is less accurate or might be completely incorrect, especially if stream and device clocks are
     // entirely different, but this is the best we can do.
+    //
+    // Streams with embedded timestamps are sampled regularly to build a piecewise time / date mapping, so that discontinuities
+    // and clock drift are accounted for. Samples are only taken outside seeks, once the stream date has settled, and
+    // only retained if they deviate from the current mapping.
     if (streamType == SRGMediaPlayerStreamTypeDVR || streamType == SRGMediaPlayerStreamTypeLive) {
-        // Cache the date only once for stable values:
-        //  - Streams without embedded timestamps: Eliminates end window oscillations because of chunks being added and removed.
-        //  - Streams with embedded timestamps: Avoid discontinuities when the player is seeking.
-        if (! self.referenceDate) {
-            NSDate *currentDate = playerItem.currentDate;
-            if (currentDate) {
-                self.referenceDate = currentDate;
-                self.referenceTime = playerItem.currentTime;
+        if (! self.timeDateMapping) {
+            self.timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:SRGTimeDateMappingTolerance];
+        }
+        
+        BOOL changed = NO;
+        
+        if (! isnan(input.currentTimeIntervalSinceReferenceDate)) {
+            if (! input.seeking && input.seekElapsedTime >= SRGTimeDateMappingSeekSettleDelay) {
+                changed = [self.timeDateMapping addSampleWithTime:input.currentTime timeIntervalSinceReferenceDate:input.currentTimeIntervalSinceReferenceDate];
+                if (changed) {
+                    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeDateSample, .dateSample = { CMTimeGetSeconds(input.currentTime), input.currentTimeIntervalSinceReferenceDate } }];
+                }
             }
-            else {
-                NSDate *referenceDate = NSDate.date;
-                
-                NSValue *streamOffsetValue = self.userInfo[SRGMediaPlayerUserInfoStreamOffsetKey];
-                if (streamOffsetValue) {
-                    CMTime streamOffset = streamOffsetValue.CMTimeValue;
-                    if (CMTIME_IS_VALID(streamOffset)) {
-                        CMTime positiveStreamOffset = CMTimeMaximum(streamOffset, kCMTimeZero);
-                        referenceDate = [referenceDate dateByAddingTimeInterval:-CMTimeGetSeconds(positiveStreamOffset)];
-                    }
+        }
+        // Use the device date only once for stable values (eliminates end window oscillations because of chunks being
+        // added and removed)
+        else if (self.timeDateMapping.count == 0) {
+            NSDate *referenceDate = NSDate.date;
+            
+            NSValue *streamOffsetValue = self.userInfo[SRGMediaPlayerUserInfoStreamOffsetKey];
+            if (streamOffsetValue) {
+                CMTime streamOffset = streamOffsetValue.CMTimeValue;
+                if (CMTIME_IS_VALID(streamOffset)) {
+                    CMTime positiveStreamOffset = CMTimeMaximum(streamOffset, kCMTimeZero);
+                    referenceDate = [referenceDate dateByAddingTimeInterval:-CMTimeGetSeconds(positiveStreamOffset)];
                 }
-                
-                self.referenceDate = referenceDate;
-                self.referenceTime = CMTimeRangeGetEnd(timeRange);
+            }
+            
+            changed = [self.timeDateMapping addSampleWithTime:CMTimeRangeGetEnd(timeRange) timeIntervalSinceReferenceDate:referenceDate.timeIntervalSinceReferenceDate];
+            if (changed) {
+                [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeDateSample, .dateSample = { CMTimeGetSeconds(CMTimeRangeGetEnd(timeRange)), referenceDate.timeIntervalSinceReferenceDate } }];
             }
         }
+        
+        // Samples which have left the DVR window are not needed anymore (the mapping itself is unchanged within the window)
+        if (CMTIMERANGE_IS_VALID(timeRange)) {
+            [self.timeDateMapping removeSamplesBeforeTime:timeRange.start];
+        }
+        
+        if (changed) {
+            [self reloadSegmentIndexForReferenceChange];
+        }
     }
-    else {
-        self.referenceDate = nil;
-        self.referenceTime = kCMTimeIndefinite;
+    else if (self.timeDateMapping) {
+        self.timeDateMapping = nil;
+        [self reloadSegmentIndexForReferenceChange];
     }
 }
 
@@ -968,44 +1100,56 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 
 - (CMTime)streamTimeForMark:(SRGMark *)mark withTimeOrigin:(CMTime)time
 {
-    if (mark.date) {
-        return [self streamTimeForDate:mark.date];
+    return [self streamTimeForMarkValue:mark.value withTimeOrigin:time];
+}
+
+- (CMTime)streamTimeForMarkValue:(SRGMarkValue)markValue withTimeOrigin:(CMTime)time
+{
+    if (SRGMarkValueIsDate(markValue)) {
+        CMTime streamTime = [self.timeDateMapping timeForTimeIntervalSinceReferenceDate:markValue.timeIntervalSinceReferenceDate];
+        return CMTIME_IS_VALID(streamTime) ? streamTime : kCMTimeZero;
     }
     else {
-        CMTime relativeTime = [mark timeForMediaPlayerController:nil];
-        return CMTimeAdd(time, relativeTime);
+        return CMTimeAdd(time, markValue.time);
     }
 }
 
 - (CMTimeRange)streamTimeRangeForMarkRange:(SRGMarkRange *)markRange
 {
-    CMTime fromTime = [self streamTimeForMark:markRange.fromMark withTimeOrigin:kCMTimeZero];
-    CMTime toTime = [self streamTimeForMark:markRange.toMark withTimeOrigin:kCMTimeZero];
+    SRGMarkRangeValue markRangeValue = markRange.value;
+    CMTime fromTime = [self streamTimeForMarkValue:markRangeValue.fromValue withTimeOrigin:kCMTimeZero];
+    CMTime toTime = [self streamTimeForMarkValue:markRangeValue.toValue withTimeOrigin:kCMTimeZero];
     return CMTimeRangeFromTimeToTime(fromTime, toTime);
 }
 
-- (CMTime)streamTimeForDate:(NSDate *)date
+- (CMTimeRange)streamTimeRangeForSegment:(id<SRGSegment>)segment
 {
-    if (date && self.referenceDate) {
-        NSTimeInterval offset = [date timeIntervalSinceDate:self.referenceDate];
-        return CMTimeAdd(self.referenceTime, CMTimeMakeWithSeconds(offset, NSEC_PER_SEC));
+    CMTimeRange timeRange = [self.segmentIndex timeRangeForSegment:segment];
+    if (CMTIMERANGE_IS_VALID(timeRange)) {
+        return timeRange;
     }
     else {
-        return kCMTimeZero;
+        return [self streamTimeRangeForMarkRange:segment.srg_markRange];
     }
 }
 
-- (NSDate *)streamDateForTime:(CMTime)time
+- (CMTime)streamTimeForDate:(NSDate *)date
 {
-    if (self.referenceDate) {
-        NSTimeInterval offset = CMTimeGetSeconds(CMTimeSubtract(time, self.referenceTime));
-        return [self.referenceDate dateByAddingTimeInterval:offset];
+    if (date && self.timeDateMapping) {
+        CMTime streamTime = [self.timeDateMapping timeForTimeIntervalSinceReferenceDate:date.timeIntervalSinceReferenceDate];
+        return CMTIME_IS_VALID(streamTime) ? streamTime : kCMTimeZero;
     }
     else {
-        return nil;
+        return kCMTimeZero;
     }
 }
 
+- (NSDate *)streamDateForTime:(CMTime)time
+{
+    NSTimeInterval timeInterval = [self.timeDateMapping timeIntervalSinceReferenceDateForTime:time];
+    return ! isnan(timeInterval) ? [NSDate dateWithTimeIntervalSinceReferenceDate:timeInterval] : nil;
+}
+
 - (SRGTimePosition *)timePositionForPosition:(SRGPosition *)position inSegment:(id<SRGSegment>)segment applyEndTolerance:(BOOL)applyEndTolerance
 {
     if (! segment) {
@@ -1035,7 +1179,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     }
     else {
         // Convert to a time in the stream reference frame.
-        CMTimeRange segmentTimeRange = [self streamTimeRangeForMarkRange:segment.srg_markRange];
+        CMTimeRange segmentTimeRange = [self streamTimeRangeForSegment:segment];
         CMTime time = [self streamTimeForMark:position.mark withTimeOrigin:segmentTimeRange.start];
         
         // Return the beginning if the desired position is above tolerance settings.
@@ -1120,7 +1264,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 
 - (void)seekToPosition:(SRGPosition *)position withCompletionHandler:(void (^)(BOOL))completionHandler
 {
-    [self seekToPosition:position inTargetSegment:nil withCompletionHandler:completionHandler];
+    [self seekToPosition:position inTargetSegment:nil coalesced:NO withCompletionHandler:completionHandler];
 }
 
 - (void)reset
@@ -1261,7 +1405,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
         return;
     }
     
-    [self seekToPosition:position inTargetSegment:segment withCompletionHandler:completionHandler];
+    [self seekToPosition:position inTargetSegment:segment coalesced:NO withCompletionHandler:completionHandler];
 }
 
 - (id<SRGSegment>)selectedSegment
@@ -1279,6 +1423,8 @@ effectivePlaybackRate:(float)effectivePlaybackRate
                      userInfo:(NSDictionary *)userInfo
             completionHandler:(void (^)(void))completionHandler
 {
+    SRGMediaPlayerSpanScope("prepareToPlay");
+    
     NSAssert(URLAsset || URL, @"A URL asset or URL must be provided");
     NSAssert(! targetSegment || [segments containsObject:targetSegment], @"Segment must be valid");
     
@@ -1336,10 +1482,18 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     
     // Notify the state change last. If clients repond to the preparing state change notification, the state need to
     // be fully consistent first.
-    [self setPlaybackState:SRGMediaPlayerPlaybackStatePreparing withUserInfo:nil];
+    [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypePrepare forPlayer:self.player atEnd:NO];
 }
 
-- (void)seekToPosition:(SRGPosition *)position inTargetSegment:(id<SRGSegment>)targetSegment withCompletionHandler:(void (^)(BOOL))completionHandler
+- (void)scrubToPosition:(SRGPosition *)position withCompletionHandler:(void (^)(BOOL))completionHandler
+{
+    [self seekToPosition:position inTargetSegment:nil coalesced:YES withCompletionHandler:completionHandler];
+}
+
+- (void)seekToPosition:(SRGPosition *)position
+       inTargetSegment:(id<SRGSegment>)targetSegment
+             coalesced:(BOOL)coalesced
+ withCompletionHandler:(void (^)(BOOL))completionHandler
 {
     NSAssert(! targetSegment || [self.segments containsObject:targetSegment], @"Target segment must be valid if provided");
     
@@ -1367,9 +1521,27 @@ effectivePlaybackRate:(float)effectivePlaybackRate
         //
         // To be able to reset the state no matter the last seek finished, we use a special category method which keeps count
         // of the count of seek requests still pending.
-        [self.player seekToTime:timePosition.time toleranceBefore:timePosition.toleranceBefore toleranceAfter:timePosition.toleranceAfter notify:YES completionHandler:^(BOOL finished) {
-            completionHandler ? completionHandler(finished) : nil;
-        }];
+        //
+        // Scrubbing seeks are coalesced so that rapid sequences do not pile up seeks which would be superseded anyway.
+        // Intermediate targets are dropped, their completion handlers being called with `NO`. Other seeks immediately
+        // supersede any seek being made.
+        @weakify(self)
+        SRGSeekSchedulerSeek seek = ^(void (^seekCompletionHandler)(BOOL)) {
+            @strongify(self)
+            if (self.player) {
+                [self.player seekToTime:timePosition.time toleranceBefore:timePosition.toleranceBefore toleranceAfter:timePosition.toleranceAfter notify:YES completionHandler:seekCompletionHandler];
+            }
+            else {
+                seekCompletionHandler(NO);
+            }
+        };
+        
+        if (coalesced) {
+            [self.seekScheduler scheduleSeek:seek withCompletionHandler:completionHandler];
+        }
+        else {
+            [self.seekScheduler performSeekImmediately:seek withCompletionHandler:completionHandler];
+        }
     }
     else {
         [self skipBlockedSegment:segment withCompletionHandler:completionHandler];
@@ -1382,6 +1554,13 @@ effectivePlaybackRate:(float)effectivePlaybackRate
         [self stopPictureInPicture];
     }
     
+    // Deliver transitions which might have been held by a pending seek
+    [self deliverPendingSegmentTransition];
+    
+    [self.seekScheduler reset];
+    _lastSeekSequenceNumber = 0;
+    _playbackProgressed = NO;
+    
     NSMutableDictionary *fullUserInfo = userInfo.mutableCopy ?: [NSMutableDictionary dictionary];
     
     // Only reset if needed (this would otherwise lazily instantiate the view again and create potential issues)
@@ -1398,6 +1577,9 @@ effectivePlaybackRate:(float)effectivePlaybackRate
             fullUserInfo[SRGMediaPlayerPreviousSelectedSegmentKey] = self.currentSegment;
         }
         
+        // Keep player metrics available after the player has been released
+        [self updateMetricsCollectorWithPlayer:self.player];
+        
         if (releasePlayer) {
             self.player = nil;
         }
@@ -1407,8 +1589,10 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     
     self.mediaType = SRGMediaPlayerMediaTypeUnknown;
     
-    self.referenceTime = kCMTimeIndefinite;
-    self.referenceDate = nil;
+    self.timeDateMapping = nil;
+    
+    // Date-based segment ranges cannot be resolved anymore
+    [self reloadSegmentIndexForReferenceChange];
     
     [self setTimeRange:kCMTimeRangeInvalid streamType:SRGMediaPlayerStreamTypeUnknown live:NO effectivePlaybackRate:self.playbackRate];
     
@@ -1416,6 +1600,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     
     self.previousSegment = nil;
     self.currentSegment = nil;
+    self.currentChildSegment = nil;
     self.targetSegment = nil;
     
     self.startPosition = nil;
@@ -1423,8 +1608,11 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     
     self.presentationSizeValue = nil;
     
-    self.lastPlaybackTime = kCMTimeIndefinite;
-    self.lastStallDetectionDate = nil;
+    self.lastStallStartDate = nil;
+    self.lastStallEndDate = nil;
+    
+    self.originalPreferredPeakBitRate = nil;
+    self.peakBitRateRestorationTimer = nil;
     
     [self updateTracksForPlayer:nil];
     
@@ -1438,7 +1626,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     }
     
     // Emit the notification once all state has been reset
-    [self setPlaybackState:SRGMediaPlayerPlaybackStateIdle withUserInfo:fullUserInfo.copy];
+    [self handlePlaybackEvent:SRGPlaybackStateMachineEventMake(SRGPlaybackStateMachineEventTypeReset, false, false) withUserInfo:fullUserInfo.copy];
 }
 
 #pragma mark Configuration
@@ -1493,6 +1681,8 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 
 - (void)reloadMediaConfiguration
 {
+    SRGMediaPlayerSpanScope("reloadMediaConfiguration");
+    
     AVPlayerItem *playerItem = self.player.currentItem;
     AVAsset *asset = playerItem.asset;
     
@@ -1538,83 +1728,345 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     [self updateTracksForPlayer:self.player];
 }
 
-#pragma mark Stall detection
+#pragma mark Playback state machine
 
-- (void)updateStallDetectionTimerForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
+// Playback state transitions are described by a platform-independent state machine, fed with events received from
+// the player
+- (void)handlePlaybackEvent:(SRGPlaybackStateMachineEvent)event withUserInfo:(NSDictionary *)userInfo
 {
-    if (playbackState == SRGMediaPlayerPlaybackStatePlaying) {
-        @weakify(self)
-        self.stallDetectionTimer = [NSTimer srgmediaplayer_timerWithTimeInterval:1. repeats:YES block:^(NSTimer * _Nonnull timer) {
-            @strongify(self)
-            
-            AVPlayerItem *playerItem = self.player.currentItem;
-            CMTime currentTime = playerItem.currentTime;
-            
-            if (self.playbackState == SRGMediaPlayerPlaybackStatePlaying) {
-                // Playing but playhead position not actually moving. Stalled
-                if (CMTIME_COMPARE_INLINE(self.lastPlaybackTime, ==, currentTime)) {
-                    [self setPlaybackState:SRGMediaPlayerPlaybackStateStalled withUserInfo:nil];
-                    self.lastStallDetectionDate = NSDate.date;
-                }
-                else {
-                    self.lastPlaybackTime = currentTime;
-                }
-            }
-            else if (self.playbackState == SRGMediaPlayerPlaybackStateStalled) {
-                // Stalled but we detect the playhead position has moved. Not stalled anymore
-                if (CMTIME_COMPARE_INLINE(self.lastPlaybackTime, !=, currentTime)) {
-                    [self setPlaybackState:SRGMediaPlayerPlaybackStatePlaying withUserInfo:nil];
-                    self.lastStallDetectionDate = nil;
-                }
-                else if ([NSDate.date timeIntervalSinceDate:self.lastStallDetectionDate] >= 5.) {
-                    [self.player playImmediatelyAtRate:self.effectivePlaybackRate];
-                }
-            }
-        }];
-    }
-    else if (playbackState != SRGMediaPlayerPlaybackStateStalled) {
-        self.stallDetectionTimer = nil;
-    }
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeStateMachineEvent, .event = event }];
+    
+    SRGPlaybackStateMachineState state = SRGPlaybackStateMachineNextState((SRGPlaybackStateMachineState)self.playbackState, event);
+    [self setPlaybackState:(SRGMediaPlayerPlaybackState)state withUserInfo:userInfo];
 }
 
-#pragma mark Segments
+- (void)handlePlaybackEventWithType:(SRGPlaybackStateMachineEventType)type forPlayer:(AVPlayer *)player atEnd:(BOOL)atEnd
+{
+    [self handlePlaybackEvent:SRGPlaybackStateMachineEventMake(type, player.rate != 0.f, atEnd) withUserInfo:nil];
+}
 
-- (void)updateSegmentStatusForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
-                      previousPlaybackState:(SRGMediaPlayerPlaybackState)previousPlaybackState
-                                       time:(CMTime)time
+#pragma mark Tracing
+
+- (void)setTraceCapacity:(NSUInteger)traceCapacity
 {
-    if (CMTIME_IS_INVALID(time)) {
+    if (traceCapacity == _traceCapacity) {
         return;
     }
     
-    // Only update when relevant
-    if (playbackState != SRGMediaPlayerPlaybackStatePaused && playbackState != SRGMediaPlayerPlaybackStatePlaying
-            && playbackState != SRGMediaPlayerPlaybackStateEnded) {
-        return;
+    SRGPlaybackTraceDestroy(_trace);
+    _trace = (traceCapacity != 0) ? SRGPlaybackTraceCreate(traceCapacity, (SRGPlaybackStateMachineState)self.playbackState) : NULL;
+    _traceCapacity = _trace ? traceCapacity : 0;
+    _tracedSeekableTimeRange = kCMTimeRangeInvalid;
+}
+
+- (NSUInteger)traceCapacity
+{
+    return _traceCapacity;
+}
+
+- (NSData *)traceData
+{
+    if (! _trace) {
+        return nil;
     }
     
-    if (self.targetSegment) {
-        [self processTransitionToSegment:self.targetSegment selected:YES interrupted:YES];
-        self.targetSegment = nil;
-    }
-    else {
-        id<SRGSegment> segment = [self segmentForTime:time];
-        BOOL interrupted = (previousPlaybackState == SRGMediaPlayerPlaybackStateSeeking);
-        [self processTransitionToSegment:segment selected:NO interrupted:interrupted];
+    NSMutableData *traceData = [NSMutableData dataWithLength:SRGPlaybackTraceByteCount(_trace)];
+    SRGPlaybackTraceCopyBytes(_trace, traceData.mutableBytes, traceData.length);
+    return traceData.copy;
+}
+
+- (void)traceRecord:(SRGPlaybackTraceRecord)record
+{
+    if (! _trace) {
+        return;
     }
+    
+    record.timestamp = clock_gettime_nsec_np(CLOCK_UPTIME_RAW);
+    SRGPlaybackTraceAppend(_trace, &record);
 }
 
-// Emit correct notifications for transitions (selected = NO for normal playback, YES if the segment has been selected)
-// and seek over blocked segments. interrupted is set to NO if playback
-- (void)processTransitionToSegment:(id<SRGSegment>)segment selected:(BOOL)selected interrupted:(BOOL)interrupted
+// Seekable time ranges are captured on each refresh, only record them when they change
+- (void)traceSeekableTimeRangeWithInput:(SRGPlaybackInformationInput)input
 {
-    // No segment transition. Nothing to do
-    if (segment == self.previousSegment && ! selected) {
+    if (! _trace) {
         return;
     }
     
-    CMTime lastPlaybackTime = CMTIME_IS_INDEFINITE(self.seekStartTime) ? self.currentTime : self.seekStartTime;
-    NSDate *lastPlaybackDate = [self streamDateForTime:lastPlaybackTime];
+    CMTimeRange seekableTimeRange = CMTIMERANGE_IS_VALID(input.firstSeekableTimeRange) ? CMTimeRangeFromTimeToTime(input.firstSeekableTimeRange.start, CMTimeRangeGetEnd(input.lastSeekableTimeRange)) : kCMTimeRangeInvalid;
+    if (CMTimeRangeEqual(seekableTimeRange, _tracedSeekableTimeRange)) {
+        return;
+    }
+    
+    _tracedSeekableTimeRange = seekableTimeRange;
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSeekableTimeRange, .timeRange = { CMTimeGetSeconds(seekableTimeRange.start), CMTimeGetSeconds(seekableTimeRange.duration) } }];
+}
+
+#pragma mark Stall detection
+
+// Stalls are detected when the player waits for more data to be buffered while playing, and end when playback actually
+// resumes
+- (void)updateStallStatusForPlayer:(AVPlayer *)player
+{
+    AVPlayerItem *playerItem = player.currentItem;
+    if (playerItem.status != AVPlayerItemStatusReadyToPlay) {
+        return;
+    }
+    
+    // The player also waits to minimize stalls while buffering after playback starts or resumes, or after a seek. Only
+    // consider waiting as a stall once playback has actually progressed since.
+    if (player.timeControlStatus == AVPlayerTimeControlStatusPlaying) {
+        _playbackProgressed = YES;
+        [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeStallEnded forPlayer:player atEnd:NO];
+    }
+    else if (player.timeControlStatus == AVPlayerTimeControlStatusPaused) {
+        _playbackProgressed = NO;
+    }
+    else if (player.timeControlStatus == AVPlayerTimeControlStatusWaitingToPlayAtSpecifiedRate && _playbackProgressed
+             && ([player.reasonForWaitingToPlay isEqualToString:AVPlayerWaitingToMinimizeStallsReason] || playerItem.playbackBufferEmpty)) {
+        [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeStallDetected forPlayer:player atEnd:NO];
+    }
+}
+
+- (void)updateStallRecoveryForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState previousPlaybackState:(SRGMediaPlayerPlaybackState)previousPlaybackState
+{
+    if (playbackState == SRGMediaPlayerPlaybackStateStalled) {
+        self.lastStallStartDate = NSDate.date;
+        self.lastStallEndDate = nil;
+        
+        // Playback is not stable anymore, keep a lowered peak bitrate
+        self.peakBitRateRestorationTimer = nil;
+        
+        if (self.stallRecoveryPolicy != SRGMediaPlayerStallRecoveryPolicyWait) {
+            @weakify(self)
+            self.stallRecoveryTimer = [NSTimer srgmediaplayer_timerWithTimeInterval:self.stallRecoveryDelay repeats:YES block:^(NSTimer * _Nonnull timer) {
+                @strongify(self)
+                [self recoverFromStall];
+            }];
+        }
+    }
+    else if (previousPlaybackState == SRGMediaPlayerPlaybackStateStalled) {
+        self.lastStallEndDate = NSDate.date;
+        self.stallRecoveryTimer = nil;
+        
+        if (self.originalPreferredPeakBitRate) {
+            @weakify(self)
+            self.peakBitRateRestorationTimer = [NSTimer srgmediaplayer_timerWithTimeInterval:SRGPeakBitRateRestorationDelay repeats:NO block:^(NSTimer * _Nonnull timer) {
+                @strongify(self)
+                [self restorePreferredPeakBitRate];
+            }];
+        }
+    }
+}
+
+- (void)recoverFromStall
+{
+    SRGMediaPlayerLogDebug(@"Controller", @"Attempting stall recovery with policy %@", @(self.stallRecoveryPolicy));
+    
+    switch (self.stallRecoveryPolicy) {
+        case SRGMediaPlayerStallRecoveryPolicyNudge: {
+            [self.player playImmediatelyAtRate:self.effectivePlaybackRate];
+            break;
+        }
+        
+        case SRGMediaPlayerStallRecoveryPolicyLowerBitrate: {
+            // Cap the bitrate below the one currently played, so that a lower variant gets selected. Repeated if the
+            // stall persists.
+            AVPlayerItem *playerItem = self.player.currentItem;
+            double indicatedBitrate = playerItem.accessLog.events.lastObject.indicatedBitrate;
+            double peakBitrate = (playerItem.preferredPeakBitRate != 0.) ? fmin(playerItem.preferredPeakBitRate, indicatedBitrate) : indicatedBitrate;
+            if (peakBitrate > 0.) {
+                // Save the value set before the first recovery attempt, restored once playback is stable
+                if (! self.originalPreferredPeakBitRate) {
+                    self.originalPreferredPeakBitRate = @(playerItem.preferredPeakBitRate);
+                }
+                playerItem.preferredPeakBitRate = peakBitrate / 2.;
+            }
+            break;
+        }
+        
+        case SRGMediaPlayerStallRecoveryPolicyReload: {
+            self.stallRecoveryTimer = nil;
+            [self reloadPlayerItem];
+            break;
+        }
+        
+        default: {
+            break;
+        }
+    }
+}
+
+- (void)restorePreferredPeakBitRate
+{
+    if (! self.originalPreferredPeakBitRate) {
+        return;
+    }
+    
+    SRGMediaPlayerLogDebug(@"Controller", @"Restoring peak bitrate %@ after stall recovery", self.originalPreferredPeakBitRate);
+    
+    self.player.currentItem.preferredPeakBitRate = self.originalPreferredPeakBitRate.doubleValue;
+    self.originalPreferredPeakBitRate = nil;
+    self.peakBitRateRestorationTimer = nil;
+}
+
+// Replace the stalled item with a new one on the same player, resuming from the current position (from the live edge
+// for livestreams without DVR). Unlike a new preparation, the playback session (player, state, segments, initial values
+// and metrics) is kept.
+- (void)reloadPlayerItem
+{
+    SRGPlayer *player = self.player;
+    AVURLAsset *URLAsset = self.URLAsset.copy;
+    if (! player || ! URLAsset) {
+        return;
+    }
+    
+    SRGPosition *position = (self.streamType != SRGMediaPlayerStreamTypeLive) ? [SRGPosition positionAtTime:player.currentTime] : SRGPosition.defaultPosition;
+    
+    [self.seekScheduler reset];
+    
+    // Item metrics are accumulated over all items played during the session
+    [self updateMetricsCollectorWithPlayer:player];
+    [self.metricsCollector startItem];
+    
+    // Resume with the start mechanism, which only affects the playback state while preparing
+    self.startPosition = position;
+    
+    @weakify(self)
+    self.startCompletionHandler = ^{
+        @strongify(self)
+        [self play];
+    };
+    
+    AVPlayerItem *playerItem = [AVPlayerItem playerItemWithAsset:URLAsset];
+    playerItem.textStyleRules = self.textStyleRules;
+    
+    // Item key-value observations are made through the player and follow the item change automatically
+    [self unregisterNotificationsForPlayerItem:player.currentItem];
+    [player replaceCurrentItemWithPlayerItem:playerItem];
+    [self registerNotificationsForPlayerItem:playerItem];
+    
+    [URLAsset loadValuesAsynchronouslyForKeys:@[ @keypath(URLAsset.availableMediaCharacteristicsWithMediaSelectionOptions) ] completionHandler:^{
+        @strongify(self)
+        
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [self reloadMediaConfiguration];
+        });
+    }];
+}
+
+#pragma mark Metrics
+
+- (SRGMediaPlayerMetrics *)metrics
+{
+    if (self.player) {
+        [self updateMetricsCollectorWithPlayer:self.player];
+    }
+    return [self.metricsCollector metricsAtTime:NSProcessInfo.processInfo.systemUptime];
+}
+
+// The view might already be ready for display when a new item is played (e.g. views without player layer are always
+// ready), in which case its readiness does not change. The first frame is therefore recorded once the item is ready
+// to play and the view ready for display, whichever comes last.
+- (void)recordFirstFrameForPlayer:(AVPlayer *)player
+{
+    if (player.currentItem.status == AVPlayerItemStatusReadyToPlay && _view.readyForDisplay) {
+        [self.metricsCollector recordFirstFrameAtTime:NSProcessInfo.processInfo.systemUptime];
+    }
+}
+
+- (void)updateMetricsCollectorWithPlayer:(SRGPlayer *)player
+{
+    AVPlayerItem *playerItem = player.currentItem;
+    [self.metricsCollector updateWithAccessLog:playerItem.accessLog errorLog:playerItem.errorLog];
+    
+    SRGPlayerSeekStatistics seekStatistics = player.seekStatistics;
+    [self.metricsCollector updateWithSeekStatistics:&seekStatistics];
+}
+
+- (void)updateMetricsForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState previousPlaybackState:(SRGMediaPlayerPlaybackState)previousPlaybackState
+{
+    NSTimeInterval time = NSProcessInfo.processInfo.systemUptime;
+    
+    if (playbackState == SRGMediaPlayerPlaybackStatePreparing) {
+        [self.metricsCollector startSessionAtTime:time];
+        return;
+    }
+    
+    BOOL playable = (playbackState == SRGMediaPlayerPlaybackStatePlaying || playbackState == SRGMediaPlayerPlaybackStatePaused);
+    if (previousPlaybackState == SRGMediaPlayerPlaybackStatePreparing && playable) {
+        [self.metricsCollector recordReadyToPlayAtTime:time];
+    }
+    
+    if (playbackState == SRGMediaPlayerPlaybackStateStalled) {
+        [self.metricsCollector recordStallStartAtTime:time];
+    }
+    else if (previousPlaybackState == SRGMediaPlayerPlaybackStateStalled) {
+        [self.metricsCollector recordStallEndAtTime:time];
+    }
+    
+    // Seeks interrupted when playback is stopped are not measured (the next session discards them)
+    if (playbackState == SRGMediaPlayerPlaybackStateSeeking) {
+        [self.metricsCollector recordSeekStartAtTime:time];
+    }
+    else if (previousPlaybackState == SRGMediaPlayerPlaybackStateSeeking && playbackState != SRGMediaPlayerPlaybackStateIdle) {
+        [self.metricsCollector recordSeekEndAtTime:time];
+    }
+}
+
+#pragma mark Segments
+
+- (void)updateSegmentStatusForPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
+                      previousPlaybackState:(SRGMediaPlayerPlaybackState)previousPlaybackState
+                                       time:(CMTime)time
+{
+    if (CMTIME_IS_INVALID(time)) {
+        return;
+    }
+    
+    // Only update when relevant
+    if (playbackState != SRGMediaPlayerPlaybackStatePaused && playbackState != SRGMediaPlayerPlaybackStatePlaying
+            && playbackState != SRGMediaPlayerPlaybackStateEnded) {
+        return;
+    }
+    
+    NSArray<id<SRGSegment>> *segmentChain = [self segmentChainForTime:time];
+    BOOL interrupted = (previousPlaybackState == SRGMediaPlayerPlaybackStateSeeking);
+    
+    if (self.targetSegment) {
+        [self processTransitionToSegment:self.targetSegment selected:YES interrupted:YES];
+        self.targetSegment = nil;
+        interrupted = YES;
+    }
+    else {
+        [self processTransitionToSegment:segmentChain.firstObject selected:NO interrupted:interrupted];
+    }
+    
+    // Child segments are only played within the current segment
+    BOOL hasChildSegment = (segmentChain.count > 1 && segmentChain.firstObject == self.currentSegment);
+    [self processTransitionToChildSegment:hasChildSegment ? segmentChain.lastObject : nil interrupted:interrupted];
+}
+
+// Emit correct notifications for transitions (selected = NO for normal playback, YES if the segment has been selected)
+// and seek over blocked segments. interrupted is set to NO if playback
+- (void)processTransitionToSegment:(id<SRGSegment>)segment selected:(BOOL)selected interrupted:(BOOL)interrupted
+{
+    // No segment transition. Nothing to do
+    if (segment == self.previousSegment && ! selected) {
+        return;
+    }
+    
+    // The segment index is only looked up (linearly) when tracing
+    if (_trace) {
+        NSUInteger segmentIndex = segment ? [self.segments indexOfObject:segment] : NSNotFound;
+        [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSegmentTransition, .value = (segmentIndex != NSNotFound) ? (uint32_t)segmentIndex : UINT32_MAX }];
+    }
+    
+    CMTime lastPlaybackTime = CMTIME_IS_INDEFINITE(self.seekStartTime) ? self.currentTime : self.seekStartTime;
+    NSDate *lastPlaybackDate = [self streamDateForTime:lastPlaybackTime];
+    
+    if (self.segmentTransitionObservers.count != 0) {
+        [self recordTransitionToSegment:segment selected:selected interrupted:interrupted lastPlaybackTime:lastPlaybackTime];
+    }
     
     if (self.previousSegment && ! self.previousSegment.srg_blocked) {
         self.currentSegment = nil;
@@ -1676,43 +2128,207 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     self.previousSegment = segment;
 }
 
-- (id<SRGSegment>)segmentForTime:(CMTime)time
+#pragma mark Segment transitions
+
+- (id)addSegmentTransitionObserverUsingBlock:(void (^)(SRGSegmentTransition))block
 {
-    if (CMTIME_IS_INVALID(time)) {
+    if (! block) {
         return nil;
     }
     
-    __block id<SRGSegment> locatedSegment = nil;
-    [self.segments enumerateObjectsUsingBlock:^(id<SRGSegment>  _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
-        CMTimeRange segmentTimeRange = [self streamTimeRangeForMarkRange:segment.srg_markRange];
-        if (CMTimeRangeContainsTime(segmentTimeRange, time)) {
-            locatedSegment = segment;
-            *stop = YES;
-        }
-    }];
-    return locatedSegment;
+    // Small integers are boxed as tagged pointers, which requires no allocation
+    NSNumber *token = @(++self.lastSegmentTransitionObserverToken);
+    self.segmentTransitionObservers = [self.segmentTransitionObservers arrayByAddingObject:block];
+    self.segmentTransitionObserverTokens = [self.segmentTransitionObserverTokens arrayByAddingObject:token];
+    return token;
 }
 
-- (CMTime)seekableTimeAfterSegment:(id<SRGSegment>)segment
+- (void)removeSegmentTransitionObserver:(id)observer
 {
-    CMTimeRange segmentTimeRange = [self streamTimeRangeForMarkRange:segment.srg_markRange];
-    CMTime seekTime = CMTimeAdd(CMTimeRangeGetEnd(segmentTimeRange), SRGSafeStartSeekOffset());
-    id<SRGSegment> nextSegment = [self segmentForTime:seekTime];
-    if (nextSegment.srg_blocked && nextSegment != segment) {
-        return [self seekableTimeAfterSegment:nextSegment];
+    if (! observer) {
+        return;
+    }
+    
+    NSUInteger index = [self.segmentTransitionObserverTokens indexOfObject:observer];
+    if (index == NSNotFound) {
+        return;
+    }
+    
+    NSMutableArray<void (^)(SRGSegmentTransition)> *segmentTransitionObservers = self.segmentTransitionObservers.mutableCopy;
+    [segmentTransitionObservers removeObjectAtIndex:index];
+    self.segmentTransitionObservers = segmentTransitionObservers.copy;
+    
+    NSMutableArray<NSNumber *> *segmentTransitionObserverTokens = self.segmentTransitionObserverTokens.mutableCopy;
+    [segmentTransitionObserverTokens removeObjectAtIndex:index];
+    self.segmentTransitionObserverTokens = segmentTransitionObserverTokens.copy;
+}
+
+// Merge a transition into the pending one. The first transition of a burst determines where playback was coming from,
+// the last one where it eventually went.
+- (void)recordTransitionToSegment:(id<SRGSegment>)segment selected:(BOOL)selected interrupted:(BOOL)interrupted lastPlaybackTime:(CMTime)lastPlaybackTime
+{
+    if (_pendingSegmentTransition.transitionCount == 0) {
+        self.pendingTransitionPreviousSegment = ! self.previousSegment.srg_blocked ? self.previousSegment : nil;
+        
+        _pendingSegmentTransition.interrupted = interrupted;
+        _pendingSegmentTransition.lastPlaybackTime = lastPlaybackTime;
+        
+        _pendingSegmentTransition.lastPlaybackTimeIntervalSinceReferenceDate = self.timeDateMapping ? [self.timeDateMapping timeIntervalSinceReferenceDateForTime:lastPlaybackTime] : NAN;
     }
     else {
-        return seekTime;
+        _pendingSegmentTransition.interrupted |= interrupted;
+    }
+    
+    self.pendingTransitionSegment = ! segment.srg_blocked ? segment : nil;
+    
+    _pendingSegmentTransition.selected = selected;
+    _pendingSegmentTransition.selectionReason = selected ? self.selectionReason : 0;
+    _pendingSegmentTransition.transitionCount++;
+    
+    [self scheduleSegmentTransitionDelivery];
+}
+
+- (void)scheduleSegmentTransitionDelivery
+{
+    if (self.segmentTransitionDeliveryScheduled) {
+        return;
+    }
+    
+    self.segmentTransitionDeliveryScheduled = YES;
+    
+    @weakify(self)
+    dispatch_async(dispatch_get_main_queue(), ^{
+        @strongify(self)
+        self.segmentTransitionDeliveryScheduled = NO;
+        
+        // Hold transitions until the seek ends (delivery is scheduled again at that time)
+        if (CMTIME_IS_INDEFINITE(self.seekTargetTime)) {
+            [self deliverPendingSegmentTransition];
+        }
+    });
+}
+
+- (void)deliverPendingSegmentTransition
+{
+    if (_pendingSegmentTransition.transitionCount == 0) {
+        return;
+    }
+    
+    // Keep segments alive while observers are called
+    id<SRGSegment> previousSegment = self.pendingTransitionPreviousSegment;
+    id<SRGSegment> segment = self.pendingTransitionSegment;
+    
+    SRGSegmentTransition transition = _pendingSegmentTransition;
+    transition.previousSegment = previousSegment;
+    transition.segment = segment;
+    
+    _pendingSegmentTransition = (SRGSegmentTransition){ 0 };
+    self.pendingTransitionPreviousSegment = nil;
+    self.pendingTransitionSegment = nil;
+    
+    // Back where we started from (e.g. back and forth seeks)
+    if (previousSegment == segment && ! transition.selected) {
+        return;
+    }
+    
+    // Observers removed during delivery are still called for this transition
+    for (void (^block)(SRGSegmentTransition) in self.segmentTransitionObservers) {
+        block(transition);
     }
 }
 
-// No tolerance parameters here. When skipping blocked segments, we want to resume sharply at segment end
+// Emit notifications for transitions between the deepest child segments being played, if any
+- (void)processTransitionToChildSegment:(id<SRGSegment>)childSegment interrupted:(BOOL)interrupted
+{
+    id<SRGSegment> previousChildSegment = self.currentChildSegment;
+    if (childSegment == previousChildSegment) {
+        return;
+    }
+    
+    CMTime lastPlaybackTime = CMTIME_IS_INDEFINITE(self.seekStartTime) ? self.currentTime : self.seekStartTime;
+    
+    if (previousChildSegment) {
+        self.currentChildSegment = nil;
+        
+        NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
+        userInfo[SRGMediaPlayerSegmentKey] = previousChildSegment;
+        userInfo[SRGMediaPlayerParentSegmentKey] = [self.segmentIndex parentSegmentForSegment:previousChildSegment];
+        userInfo[SRGMediaPlayerNextSegmentKey] = childSegment;
+        userInfo[SRGMediaPlayerInterruptionKey] = @(interrupted);
+        userInfo[SRGMediaPlayerLastPlaybackTimeKey] = [NSValue valueWithCMTime:lastPlaybackTime];
+        
+        [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerChildSegmentDidEndNotification
+                                                          object:self
+                                                        userInfo:userInfo.copy];
+        
+        SRGMediaPlayerLogDebug(@"Controller", @"Child segment did end with info %@", userInfo);
+    }
+    
+    if (childSegment) {
+        self.currentChildSegment = childSegment;
+        
+        NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
+        userInfo[SRGMediaPlayerSegmentKey] = childSegment;
+        userInfo[SRGMediaPlayerParentSegmentKey] = [self.segmentIndex parentSegmentForSegment:childSegment];
+        userInfo[SRGMediaPlayerPreviousSegmentKey] = previousChildSegment;
+        userInfo[SRGMediaPlayerLastPlaybackTimeKey] = [NSValue valueWithCMTime:lastPlaybackTime];
+        
+        [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerChildSegmentDidStartNotification
+                                                          object:self
+                                                        userInfo:userInfo.copy];
+        
+        SRGMediaPlayerLogDebug(@"Controller", @"Child segment did start with info %@", userInfo);
+    }
+}
+
+- (id<SRGSegment>)segmentForTime:(CMTime)time
+{
+    SRGMediaPlayerSpanScope("segmentForTime");
+    return [self.segmentIndex segmentForTime:time];
+}
+
+- (NSArray<id<SRGSegment>> *)segmentChainForTime:(CMTime)time
+{
+    return [self.segmentIndex segmentChainForTime:time] ?: @[];
+}
+
+// Return the time range covered by the blocked run the specified blocked segment belongs to. Runs separated by less
+// than the safe seek offset are merged, as playback would otherwise resume within the next run.
+- (CMTimeRange)blockedTimeRangeForSegment:(id<SRGSegment>)segment
+{
+    CMTimeRange segmentTimeRange = [self streamTimeRangeForSegment:segment];
+    CMTimeRange blockedTimeRange = [self.segmentIndex blockedTimeRangeForTime:segmentTimeRange.start];
+    if (! CMTIMERANGE_IS_VALID(blockedTimeRange)) {
+        blockedTimeRange = segmentTimeRange;
+    }
+    
+    while (YES) {
+        CMTime seekTime = CMTimeAdd(CMTimeRangeGetEnd(blockedTimeRange), SRGSafeStartSeekOffset());
+        CMTimeRange nextBlockedTimeRange = [self.segmentIndex blockedTimeRangeForTime:seekTime];
+        if (! CMTIMERANGE_IS_VALID(nextBlockedTimeRange)) {
+            break;
+        }
+        blockedTimeRange = CMTimeRangeGetUnion(blockedTimeRange, nextBlockedTimeRange);
+    }
+    return blockedTimeRange;
+}
+
+// No tolerance parameters here. When skipping blocked segments, we want to resume sharply at segment end. Contiguous
+// blocked segments are skipped at once.
 - (void)skipBlockedSegment:(id<SRGSegment>)segment withCompletionHandler:(void (^)(BOOL finished))completionHandler
 {
     NSAssert(segment.srg_blocked, @"Expect a blocked segment");
     
+    CMTimeRange blockedTimeRange = [self blockedTimeRangeForSegment:segment];
+    
+    NSMutableArray<id<SRGSegment>> *skippedSegments = [self.segmentIndex blockedSegmentsInTimeRange:blockedTimeRange].mutableCopy;
+    if (! [skippedSegments containsObject:segment]) {
+        [skippedSegments insertObject:segment atIndex:0];
+    }
+    
     NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
     userInfo[SRGMediaPlayerSegmentKey] = segment;
+    userInfo[SRGMediaPlayerSkippedSegmentsKey] = skippedSegments.copy;
     
     CMTime currentTime = self.currentTime;
     userInfo[SRGMediaPlayerLastPlaybackTimeKey] = [NSValue valueWithCMTime:currentTime];
@@ -1722,21 +2338,21 @@ effectivePlaybackRate:(float)effectivePlaybackRate
                                                       object:self
                                                     userInfo:userInfo.copy];
     
-    SRGMediaPlayerLogDebug(@"Controller", @"Segment %@ will be skipped", segment);
+    SRGMediaPlayerLogDebug(@"Controller", @"Segments %@ will be skipped", skippedSegments);
     
     // Use low-level seek API to prevent infinite skip blocked segment recursion, but use calculation methods ensuring
     // the position is in range.
-    CMTime seekTime = [self seekableTimeAfterSegment:segment];
+    CMTime seekTime = CMTimeAdd(CMTimeRangeGetEnd(blockedTimeRange), SRGSafeStartSeekOffset());
     SRGPosition *position = [SRGPosition positionAtTime:seekTime];
     SRGTimePosition *timePosition = [self timePositionForPosition:position inSegment:nil applyEndTolerance:NO];
     [self.player seekToTime:timePosition.time toleranceBefore:timePosition.toleranceBefore toleranceAfter:timePosition.toleranceAfter notify:YES completionHandler:^(BOOL finished) {
         // Do not check the finished boolean. We want to emit the notification even if the seek is interrupted by another
-        // one (e.g. due to a contiguous blocked segment being skipped).
+        // one.
         [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerDidSkipBlockedSegmentNotification
                                                           object:self
                                                         userInfo:userInfo.copy];
         
-        SRGMediaPlayerLogDebug(@"Controller", @"Segment %@ was skipped", segment);
+        SRGMediaPlayerLogDebug(@"Controller", @"Segments %@ were skipped", skippedSegments);
         
         completionHandler ? completionHandler(finished) : nil;
     }];
@@ -1755,6 +2371,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     }
     
     self.playerViewController = playerViewController;
+    [self updateRefreshFrequencyForPlayer:self.player];
     
     // AVPlayerViewController works well (e.g. playback won't freeze in the simulator after a few seconds) only if
     // the attached player is not bound to any other layer. We therefore detach the player from the controller view.
@@ -1771,6 +2388,7 @@ effectivePlaybackRate:(float)effectivePlaybackRate
         self.playerViewController.player = nil;
     }
     self.playerViewController = nil;
+    [self updateRefreshFrequencyForPlayer:self.player];
     
     // Rebind the player
     self.view.player = self.player;
@@ -1805,6 +2423,8 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 
 - (void)updateTracksForPlayer:(AVPlayer *)player
 {
+    SRGMediaPlayerSpanScope("updateTracks");
+    
     AVMediaSelectionOption *audioOption = [self selectedOptionForPlayer:player withMediaCharacteristic:AVMediaCharacteristicAudible];
     if (audioOption != self.audioOption && ! [audioOption isEqual:self.audioOption]) {
         NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
@@ -1988,99 +2608,263 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     return @[ @0.5, @0.75, @1, @1.25, @1.5, @2 ];
 }
 
+#pragma mark Snapshot
+
+- (void)publishSnapshot
+{
+    self.snapshot = [[SRGMediaPlayerSnapshot alloc] initWithPlaybackState:self.playbackState
+                                                                     time:self.currentTime
+                                                                timeRange:self.timeRange
+                                                               streamType:self.streamType
+                                                                     live:self.live
+                                                    effectivePlaybackRate:self.effectivePlaybackRate
+                                                           currentSegment:self.currentSegment];
+}
+
+#pragma mark Property changes
+
+// Record the values of properties about to change. Changes made during the same run loop turn are reported at once
+// afterwards, compared to the values recorded for the first change.
+- (void)willChangeProperties:(SRGMediaPlayerProperties)properties
+{
+    SRGMediaPlayerProperties newProperties = properties & ~self.pendingChangedProperties;
+    if (newProperties == 0) {
+        return;
+    }
+    
+    for (SRGMediaPlayerProperties property = 1; property <= newProperties; property <<= 1) {
+        if (newProperties & property) {
+            self.pendingPreviousValues[@(property)] = [self valueForKey:SRGMediaPlayerControllerKeyForProperty(property)] ?: NSNull.null;
+        }
+    }
+    
+    BOOL scheduled = (self.pendingChangedProperties != 0);
+    self.pendingChangedProperties |= newProperties;
+    
+    if (! scheduled) {
+        @weakify(self)
+        dispatch_async(dispatch_get_main_queue(), ^{
+            @strongify(self)
+            [self postPropertiesDidChangeNotification];
+        });
+    }
+}
+
+- (void)postPropertiesDidChangeNotification
+{
+    __block SRGMediaPlayerProperties changedProperties = 0;
+    NSMutableDictionary<NSNumber *, id> *previousValues = [NSMutableDictionary dictionary];
+    NSMutableDictionary<NSNumber *, id> *values = [NSMutableDictionary dictionary];
+    
+    [self.pendingPreviousValues enumerateKeysAndObjectsUsingBlock:^(NSNumber * _Nonnull propertyNumber, id _Nonnull previousValue, BOOL * _Nonnull stop) {
+        SRGMediaPlayerProperties property = propertyNumber.unsignedIntegerValue;
+        id value = [self valueForKey:SRGMediaPlayerControllerKeyForProperty(property)] ?: NSNull.null;
+        if (! [value isEqual:previousValue]) {
+            changedProperties |= property;
+            previousValues[propertyNumber] = previousValue;
+            values[propertyNumber] = value;
+        }
+    }];
+    
+    self.pendingChangedProperties = 0;
+    [self.pendingPreviousValues removeAllObjects];
+    
+    if (changedProperties == 0) {
+        return;
+    }
+    
+    [NSNotificationCenter.defaultCenter postNotificationName:SRGMediaPlayerPropertiesDidChangeNotification
+                                                      object:self
+                                                    userInfo:@{ SRGMediaPlayerChangedPropertiesKey : @(changedProperties),
+                                                                SRGMediaPlayerPreviousValuesKey : previousValues.copy,
+                                                                SRGMediaPlayerValuesKey : values.copy }];
+}
+
 #pragma mark Time observers
 
 - (void)registerTimeObserversForPlayer:(AVPlayer *)player
 {
-    for (SRGPeriodicTimeObserver *playbackBlockRegistration in [self.periodicTimeObservers allValues]) {
-        [playbackBlockRegistration attachToMediaPlayer:player];
+    [self.playbackClock attachToPlayer:player];
+    
+    [self updateBoundaryTimeObserverForPlayer:player];
+    
+    self.applicationInBackground = (UIApplication.sharedApplication.applicationState == UIApplicationStateBackground);
+    [self updateRefreshFrequencyForPlayer:player];
+}
+
+// Playback information is refreshed periodically, at a frequency adapted to the current playback context. Refreshes
+// are suspended when nothing can change, and performed less often when no user interface is displayed.
+- (SRGMediaPlayerRefreshFrequency)refreshFrequencyForPlayer:(AVPlayer *)player
+{
+    if (! player) {
+        return SRGMediaPlayerRefreshFrequencyNone;
     }
     
-    @weakify(self)
-    self.playerPeriodicTimeObserver = [player addPeriodicTimeObserverForInterval:CMTimeMakeWithSeconds(1., NSEC_PER_SEC) queue:NULL usingBlock:^(CMTime time) {
-        @strongify(self)
+    switch (self.playbackState) {
+        case SRGMediaPlayerPlaybackStateIdle:
+        case SRGMediaPlayerPlaybackStateEnded: {
+            return SRGMediaPlayerRefreshFrequencyNone;
+            break;
+        }
         
-        [self updateSegmentStatusForPlaybackState:self.playbackState previousPlaybackState:self.playbackState time:time];
+        case SRGMediaPlayerPlaybackStatePaused: {
+            // The time range of a livestream changes even when paused
+            return (self.streamType == SRGMediaPlayerStreamTypeOnDemand) ? SRGMediaPlayerRefreshFrequencyNone : SRGMediaPlayerRefreshFrequencyLow;
+            break;
+        }
         
-        // Akamai fix: When start and end parameters are used, the subtitles track is longer than the associated truncated
-        // stream. This incorrectly prevents the player from ending playback correctly (playback continues for the subtitles).
-        // This workaround emits the missing end event instead of letting playback continue.
-        // TODO: Remove when Akamai fixed this issue
-        if (self.streamType == SRGMediaPlayerStreamTypeOnDemand && CMTIME_COMPARE_INLINE(time, >, CMTimeRangeGetEnd(self.timeRange))) {
-            [self setPlaybackState:SRGMediaPlayerPlaybackStateEnded withUserInfo:nil];
+        default: {
+            break;
         }
-    }];
+    }
     
-    self.controllerPeriodicTimeObserver = [self addPeriodicTimeObserverForInterval:CMTimeMakeWithSeconds(1., NSEC_PER_SEC) queue:NULL usingBlock:^(CMTime time) {
-        @strongify(self)
-        [self updatePlaybackInformationForPlayer:player];
-        [self updateTracksForPlayer:player];
-    }];
+    if (self.applicationInBackground || ! [self isUserInterfaceAttached]) {
+        return SRGMediaPlayerRefreshFrequencyLow;
+    }
+    
+    if (self.playbackState == SRGMediaPlayerPlaybackStatePlaying && [self isCloseToTransitionAtTime:player.currentTime]) {
+        return SRGMediaPlayerRefreshFrequencyHigh;
+    }
+    
+    return SRGMediaPlayerRefreshFrequencyNormal;
 }
 
-- (void)unregisterTimeObserversForPlayer:(AVPlayer *)player
+// Return `YES` iff the player is displayed by the controller view, by a player view controller or in picture in picture.
+// The view is not lazily instantiated.
+- (BOOL)isUserInterfaceAttached
 {
-    [player removeTimeObserver:self.playerPeriodicTimeObserver];
-    self.playerPeriodicTimeObserver = nil;
-    
-    [self removePeriodicTimeObserver:self.controllerPeriodicTimeObserver];
+    return _view.window != nil || self.playerViewController != nil || [self isPictureInPictureActive];
+}
+
+// Return `YES` iff the specified time is close to a segment boundary or to the time at which the live status changes
+- (BOOL)isCloseToTransitionAtTime:(CMTime)time
+{
+    CMTime boundaryTime = [self.segmentIndex boundaryTimeAfterTime:time];
+    if (CMTIME_IS_VALID(boundaryTime) && CMTimeGetSeconds(CMTimeSubtract(boundaryTime, time)) < SRGRefreshBoostDistance) {
+        return YES;
+    }
     
-    for (SRGPeriodicTimeObserver *periodicTimeObserver in [self.periodicTimeObservers allValues]) {
-        [periodicTimeObserver detachFromMediaPlayer];
+    if (self.streamType == SRGMediaPlayerStreamTypeDVR) {
+        NSTimeInterval liveEdgeDistance = CMTimeGetSeconds(CMTimeSubtract(CMTimeRangeGetEnd(self.timeRange), time));
+        return fabs(liveEdgeDistance - self.liveTolerance) < SRGRefreshBoostDistance;
+    }
+    else {
+        return NO;
     }
 }
 
-- (id)addPeriodicTimeObserverForInterval:(CMTime)interval queue:(dispatch_queue_t)queue usingBlock:(void (^)(CMTime time))block
+- (void)updateRefreshFrequencyForPlayer:(AVPlayer *)player
 {
-    if (! block) {
-        return nil;
+    SRGMediaPlayerRefreshFrequency refreshFrequency = [self refreshFrequencyForPlayer:player];
+    if (refreshFrequency == self.refreshFrequency) {
+        return;
     }
     
-    NSString *identifier = NSUUID.UUID.UUIDString;
-    SRGPeriodicTimeObserver *periodicTimeObserver = [self periodicTimeObserverForInterval:interval queue:queue];
-    [periodicTimeObserver setBlock:block forIdentifier:identifier];
+    [self removePeriodicTimeObserver:self.controllerPeriodicTimeObserver];
     
-    if (self.player) {
-        [periodicTimeObserver attachToMediaPlayer:self.player];
+    if (refreshFrequency != SRGMediaPlayerRefreshFrequencyNone) {
+        CMTime interval = CMTimeMakeWithSeconds(SRGMediaPlayerControllerRefreshInterval(refreshFrequency), NSEC_PER_SEC);
+        
+        @weakify(self)
+        self.controllerPeriodicTimeObserver = [self addPeriodicTimeObserverForInterval:interval queue:NULL usingBlock:^(CMTime time) {
+            @strongify(self)
+            
+            // The playback clock also executes all blocks when the seekable time ranges change, which happens regularly
+            // for paused livestreams. Throttle such refreshes at low frequency.
+            NSTimeInterval systemUptime = NSProcessInfo.processInfo.systemUptime;
+            if (self.refreshFrequency == SRGMediaPlayerRefreshFrequencyLow
+                    && systemUptime - self.lastRefreshSystemUptime < SRGMediaPlayerControllerRefreshInterval(SRGMediaPlayerRefreshFrequencyLow) / 2.) {
+                return;
+            }
+            self.lastRefreshSystemUptime = systemUptime;
+            
+            [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeTick, .time = CMTimeGetSeconds(time) }];
+            [self updatePlaybackInformationForPlayer:player];
+            [self updateTracksForPlayer:player];
+            [self updateRefreshFrequencyForPlayer:player];
+        }];
     }
     
-    // Return the opaque identifier
-    return identifier;
+    self.refreshFrequency = refreshFrequency;
+    
+    SRGMediaPlayerLogDebug(@"Controller", @"Refresh frequency did change to %@", SRGMediaPlayerControllerNameForRefreshFrequency(refreshFrequency));
 }
 
-- (void)removePeriodicTimeObserver:(id)observer
+// Segment transitions are detected at segment boundaries, as well as when the playback state changes (e.g. after a seek).
+// Boundaries must be registered again each time the segment index changes, or when the end of an on-demand stream
+// changes.
+- (void)updateBoundaryTimeObserverForPlayer:(AVPlayer *)player
 {
-    if (! observer) {
+    [self removeBoundaryTimeObserver];
+    
+    NSMutableArray<NSValue *> *boundaryTimes = self.segmentIndex.boundaryTimes.mutableCopy ?: [NSMutableArray array];
+    if (self.streamType == SRGMediaPlayerStreamTypeOnDemand && SRG_CMTIMERANGE_IS_NOT_EMPTY(self.timeRange)) {
+        [boundaryTimes addObject:[NSValue valueWithCMTime:CMTimeAdd(CMTimeRangeGetEnd(self.timeRange), SRGEndBoundaryOffset())]];
+    }
+    
+    if (! player || boundaryTimes.count == 0) {
         return;
     }
     
-    for (NSString *key in self.periodicTimeObservers.allKeys) {
-        SRGPeriodicTimeObserver *periodicTimeObserver = self.periodicTimeObservers[key];
-        if (! [periodicTimeObserver hasBlockWithIdentifier:observer]) {
-            continue;
-        }
+    @weakify(self) @weakify(player)
+    self.playerBoundaryTimeObserver = [player addBoundaryTimeObserverForTimes:boundaryTimes queue:NULL usingBlock:^{
+        @strongify(self) @strongify(player)
         
-        [periodicTimeObserver removeBlockWithIdentifier:observer];
+        // Snap to the boundary if reached slightly early, so that the segment starting at the boundary is found
+        CMTime time = player.currentTime;
+        CMTime boundaryTime = [self.segmentIndex boundaryTimeAfterTime:time];
+        if (CMTIME_IS_VALID(boundaryTime) && CMTIME_COMPARE_INLINE(CMTimeSubtract(boundaryTime, time), <=, SRGBoundaryTimeTolerance())) {
+            time = boundaryTime;
+        }
+        [self updateSegmentStatusForPlaybackState:self.playbackState previousPlaybackState:self.playbackState time:time];
         
-        // Remove the periodic time observer if not used anymore
-        if (periodicTimeObserver.registrationCount == 0) {
-            [self.periodicTimeObservers removeObjectForKey:key];
-            return;
+        // Akamai fix: When start and end parameters are used, the subtitles track is longer than the associated truncated
+        // stream. This incorrectly prevents the player from ending playback correctly (playback continues for the subtitles).
+        // This workaround emits the missing end event instead of letting playback continue.
+        // TODO: Remove when Akamai fixed this issue
+        if (self.streamType == SRGMediaPlayerStreamTypeOnDemand && CMTIME_COMPARE_INLINE(player.currentTime, >, CMTimeRangeGetEnd(self.timeRange))) {
+            [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypePlayedToEnd forPlayer:player atEnd:YES];
         }
+    }];
+    self.playerBoundaryTimeObserverPlayer = player;
+}
+
+// Observers must be removed from the player which registered them
+- (void)removeBoundaryTimeObserver
+{
+    if (self.playerBoundaryTimeObserver) {
+        [self.playerBoundaryTimeObserverPlayer removeTimeObserver:self.playerBoundaryTimeObserver];
+        self.playerBoundaryTimeObserver = nil;
+        self.playerBoundaryTimeObserverPlayer = nil;
     }
 }
 
-- (SRGPeriodicTimeObserver *)periodicTimeObserverForInterval:(CMTime)interval queue:(dispatch_queue_t)queue
+- (void)unregisterTimeObserversForPlayer:(AVPlayer *)player
+{
+    [self removeBoundaryTimeObserver];
+    
+    [self removePeriodicTimeObserver:self.controllerPeriodicTimeObserver];
+    self.refreshFrequency = SRGMediaPlayerRefreshFrequencyNone;
+    
+    [self.playbackClock detachFromPlayer];
+}
+
+- (id)addPeriodicTimeObserverForInterval:(CMTime)interval queue:(dispatch_queue_t)queue usingBlock:(void (^)(CMTime time))block
 {
-    NSString *key = [NSString stringWithFormat:@"%@-%@-%@-%@-%p", @(interval.value), @(interval.timescale), @(interval.flags), @(interval.epoch), queue];
-    SRGPeriodicTimeObserver *periodicTimeObserver = self.periodicTimeObservers[key];
+    if (! block) {
+        return nil;
+    }
     
-    if (! periodicTimeObserver) {
-        periodicTimeObserver = [[SRGPeriodicTimeObserver alloc] initWithInterval:interval queue:queue];
-        self.periodicTimeObservers[key] = periodicTimeObserver;
+    return [self.playbackClock addObserverForInterval:interval queue:queue usingBlock:block];
+}
+
+- (void)removePeriodicTimeObserver:(id)observer
+{
+    if (! observer) {
+        return;
     }
     
-    return periodicTimeObserver;
+    [self.playbackClock removeObserver:observer];
 }
 
 #pragma mark SRGMediaPlayerViewDelegate protocol
@@ -2088,13 +2872,23 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 - (void)mediaPlayerView:(SRGMediaPlayerView *)mediaPlayerView didMoveToWindow:(UIWindow *)window
 {
     [self reloadPlayerConfiguration];
+    [self updateRefreshFrequencyForPlayer:self.player];
 }
 
 #pragma mark SRGPlayerDelegate protocol
 
-- (void)player:(SRGPlayer *)player willSeekToTime:(CMTime)time
+- (void)player:(SRGPlayer *)player willSeekToTime:(CMTime)time sequenceNumber:(NSUInteger)sequenceNumber
 {
-    [self setPlaybackState:SRGMediaPlayerPlaybackStateSeeking withUserInfo:nil];
+    // Deliveries are asynchronous and might still arrive from a player which has been released
+    if (player != self.player) {
+        return;
+    }
+    
+    _lastSeekSequenceNumber = sequenceNumber;
+    _playbackProgressed = NO;
+    
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSeekStart, .time = CMTimeGetSeconds(time) }];
+    [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeSeekStarted forPlayer:player atEnd:NO];
     
     NSMutableDictionary *userInfo = [NSMutableDictionary dictionary];
     userInfo[SRGMediaPlayerSeekTimeKey] = [NSValue valueWithCMTime:time];
@@ -2109,20 +2903,86 @@ effectivePlaybackRate:(float)effectivePlaybackRate
                                                     userInfo:userInfo.copy];
 }
 
-- (void)player:(SRGPlayer *)player didSeekToTime:(CMTime)time
+- (void)player:(SRGPlayer *)player didSeekToTime:(CMTime)time sequenceNumber:(NSUInteger)sequenceNumber
 {
-    [self setPlaybackState:(player.rate == 0.f) ? SRGMediaPlayerPlaybackStatePaused : SRGMediaPlayerPlaybackStatePlaying withUserInfo:nil];
+    if (player != self.player) {
+        return;
+    }
+    
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSeekEnd, .time = CMTimeGetSeconds(time) }];
+    
+    // A more recent seek has been requested, or a coalesced seek immediately follows. Remain in the seeking state until
+    // the latest seek completes.
+    if (sequenceNumber < _lastSeekSequenceNumber || self.seekScheduler.hasPendingSeek) {
+        return;
+    }
+    
+    [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeSeekEnded forPlayer:player atEnd:NO];
+    
+    if (_pendingSegmentTransition.transitionCount != 0) {
+        [self scheduleSegmentTransitionDelivery];
+    }
 }
 
 #pragma mark Notifications
 
+- (void)registerNotificationsForPlayerItem:(AVPlayerItem *)playerItem
+{
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(srg_mediaPlayerController_playerItemDidPlayToEndTime:)
+                                               name:AVPlayerItemDidPlayToEndTimeNotification
+                                             object:playerItem];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(srg_mediaPlayerController_playerItemFailedToPlayToEndTime:)
+                                               name:AVPlayerItemFailedToPlayToEndTimeNotification
+                                             object:playerItem];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(srg_mediaPlayerController_playerItemPlaybackStalled:)
+                                               name:AVPlayerItemPlaybackStalledNotification
+                                             object:playerItem];
+    [NSNotificationCenter.defaultCenter addObserver:self
+                                           selector:@selector(srg_mediaPlayerController_playerItemTimeJumped:)
+                                               name:AVPlayerItemTimeJumpedNotification
+                                             object:playerItem];
+}
+
+- (void)unregisterNotificationsForPlayerItem:(AVPlayerItem *)playerItem
+{
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:AVPlayerItemDidPlayToEndTimeNotification
+                                                object:playerItem];
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:AVPlayerItemFailedToPlayToEndTimeNotification
+                                                object:playerItem];
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:AVPlayerItemPlaybackStalledNotification
+                                                object:playerItem];
+    [NSNotificationCenter.defaultCenter removeObserver:self
+                                                  name:AVPlayerItemTimeJumpedNotification
+                                                object:playerItem];
+}
+
+- (void)srg_mediaPlayerController_playerItemPlaybackStalled:(NSNotification *)notification
+{
+    [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypeStallDetected forPlayer:self.player atEnd:NO];
+}
+
+- (void)srg_mediaPlayerController_playerItemTimeJumped:(NSNotification *)notification
+{
+    [self updateStallStatusForPlayer:self.player];
+}
+
 - (void)srg_mediaPlayerController_playerItemDidPlayToEndTime:(NSNotification *)notification
 {
-    [self setPlaybackState:SRGMediaPlayerPlaybackStateEnded withUserInfo:nil];
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeNotification, .value = SRGPlaybackTraceNotificationPlayedToEnd }];
+    
+    [self handlePlaybackEventWithType:SRGPlaybackStateMachineEventTypePlayedToEnd forPlayer:self.player atEnd:YES];
 }
 
 - (void)srg_mediaPlayerController_playerItemFailedToPlayToEndTime:(NSNotification *)notification
 {
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeNotification, .value = SRGPlaybackTraceNotificationFailedToPlayToEnd }];
+    
     [self stopWithUserInfo:nil releasePlayer:YES];
     
     NSError *error = SRGMediaPlayerControllerError(notification.userInfo[AVPlayerItemFailedToPlayToEndTimeErrorKey]);
@@ -2135,6 +2995,8 @@ effectivePlaybackRate:(float)effectivePlaybackRate
 
 - (void)srg_mediaPlayerController_applicationDidEnterBackground:(NSNotification *)notification
 {
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeNotification, .value = SRGPlaybackTraceNotificationApplicationDidEnterBackground }];
+    
     // The video layer must be detached in the background if we want playback not to be paused automatically.
     // See https://developer.apple.com/library/archive/qa/qa1668/_index.html
     if (! self.playerViewController && ! [self isPictureInPictureActive] && ! self.player.externalPlaybackActive) {
@@ -2187,12 +3049,20 @@ effectivePlaybackRate:(float)effectivePlaybackRate
     }
     
     [self reloadPlayerConfiguration];
+    
+    self.applicationInBackground = YES;
+    [self updateRefreshFrequencyForPlayer:self.player];
 }
 
 - (void)srg_mediaPlayerController_applicationWillEnterForeground:(NSNotification *)notification
 {
+    [self traceRecord:(SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeNotification, .value = SRGPlaybackTraceNotificationApplicationWillEnterForeground }];
+    
     [self attachPlayer:self.player toView:self.view];
     [self reloadPlayerConfiguration];
+    
+    self.applicationInBackground = NO;
+    [self updateRefreshFrequencyForPlayer:self.player];
 }
 
 #pragma mark KVO
@@ -2288,6 +3158,53 @@ static NSString *SRGMediaPlayerControllerNameForStreamType(SRGMediaPlayerStreamT
     return s_names[@(streamType)] ?: @"unknown";
 }
 
+static NSString *SRGMediaPlayerControllerNameForRefreshFrequency(SRGMediaPlayerRefreshFrequency refreshFrequency)
+{
+    static NSDictionary<NSNumber *, NSString *> *s_names;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_names = @{ @(SRGMediaPlayerRefreshFrequencyLow) : @"low",
+                     @(SRGMediaPlayerRefreshFrequencyNormal) : @"normal",
+                     @(SRGMediaPlayerRefreshFrequencyHigh) : @"high" };
+    });
+    return s_names[@(refreshFrequency)] ?: @"none";
+}
+
+static NSString *SRGMediaPlayerControllerKeyForProperty(SRGMediaPlayerProperties property)
+{
+    static NSDictionary<NSNumber *, NSString *> *s_keys;
+    static dispatch_once_t s_onceToken;
+    dispatch_once(&s_onceToken, ^{
+        s_keys = @{ @(SRGMediaPlayerPropertyPlaybackState) : @keypath(SRGMediaPlayerController.new, playbackState),
+                    @(SRGMediaPlayerPropertyMediaType) : @keypath(SRGMediaPlayerController.new, mediaType),
+                    @(SRGMediaPlayerPropertyTimeRange) : @keypath(SRGMediaPlayerController.new, timeRange),
+                    @(SRGMediaPlayerPropertyStreamType) : @keypath(SRGMediaPlayerController.new, streamType),
+                    @(SRGMediaPlayerPropertyLive) : @keypath(SRGMediaPlayerController.new, live),
+                    @(SRGMediaPlayerPropertyEffectivePlaybackRate) : @keypath(SRGMediaPlayerController.new, effectivePlaybackRate) };
+    });
+    return s_keys[@(property)];
+}
+
+static NSTimeInterval SRGMediaPlayerControllerRefreshInterval(SRGMediaPlayerRefreshFrequency refreshFrequency)
+{
+    switch (refreshFrequency) {
+        case SRGMediaPlayerRefreshFrequencyLow: {
+            return 5.;
+            break;
+        }
+        
+        case SRGMediaPlayerRefreshFrequencyHigh: {
+            return 0.25;
+            break;
+        }
+        
+        default: {
+            return 1.;
+            break;
+        }
+    }
+}
+
 // Adjust position tolerance settings so that the position is guaranteed to fall within the specified time range. Offsets
 // can be provided to trim off a bit of the time range at its start and end. If the time itself lies outside the specified
 // range, it is fixed to the nearest end.
@@ -0,0 +1,21 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerHistogram.h"
+#import "SRGPlaybackHistogram.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGMediaPlayerHistogram (Private)
+
+/**
+ *  Create a histogram from a copy of the specified histogram values.
+ */
+- (instancetype)initWithHistogram:(const SRGPlaybackHistogram *)histogram;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,83 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerHistogram+Private.h"
+
+@implementation SRGMediaPlayerHistogram {
+@private
+    SRGPlaybackHistogram _histogram;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithHistogram:(const SRGPlaybackHistogram *)histogram
+{
+    if (self = [super init]) {
+        _histogram = *histogram;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    SRGPlaybackHistogram histogram = { 0 };
+    return [self initWithHistogram:&histogram];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (NSUInteger)count
+{
+    return (NSUInteger)_histogram.count;
+}
+
+- (NSTimeInterval)minimum
+{
+    return _histogram.minimum;
+}
+
+- (NSTimeInterval)maximum
+{
+    return _histogram.maximum;
+}
+
+- (NSTimeInterval)sum
+{
+    return _histogram.sum;
+}
+
+- (NSTimeInterval)mean
+{
+    return SRGPlaybackHistogramMean(&_histogram);
+}
+
+#pragma mark Percentiles
+
+- (NSTimeInterval)valueAtPercentile:(double)percentile
+{
+    return SRGPlaybackHistogramValueAtPercentile(&_histogram, percentile);
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; count = %@; minimum = %@; median = %@; p90 = %@; maximum = %@>",
+            self.class,
+            self,
+            @(self.count),
+            @(self.minimum),
+            @([self valueAtPercentile:50.]),
+            @([self valueAtPercentile:90.]),
+            @(self.maximum)];
+}
+
+@end
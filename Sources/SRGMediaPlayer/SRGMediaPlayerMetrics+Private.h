@@ -0,0 +1,32 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerMetrics.h"
+#import "SRGPlayer.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGMediaPlayerMetrics (Private)
+
+/**
+ *  Create a metrics summary with the specified values.
+ */
+- (instancetype)initWithPrepareSystemUptime:(NSTimeInterval)prepareSystemUptime
+                            startupDuration:(NSTimeInterval)startupDuration
+                         firstFrameDuration:(NSTimeInterval)firstFrameDuration
+                                 stallCount:(NSUInteger)stallCount
+                              stallDuration:(NSTimeInterval)stallDuration
+                     stallDurationHistogram:(SRGMediaPlayerHistogram *)stallDurationHistogram
+                       seekLatencyHistogram:(SRGMediaPlayerHistogram *)seekLatencyHistogram
+                             seekStatistics:(const SRGPlayerSeekStatistics *)seekStatistics
+                         bitrateSwitchCount:(NSUInteger)bitrateSwitchCount
+                           indicatedBitrate:(double)indicatedBitrate
+                     droppedVideoFrameCount:(NSUInteger)droppedVideoFrameCount
+                                 errorCount:(NSUInteger)errorCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
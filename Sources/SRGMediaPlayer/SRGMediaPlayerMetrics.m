@@ -0,0 +1,114 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerMetrics+Private.h"
+
+#import "SRGMediaPlayerHistogram+Private.h"
+
+@interface SRGMediaPlayerMetrics ()
+
+@property (nonatomic) NSTimeInterval prepareSystemUptime;
+@property (nonatomic) NSTimeInterval startupDuration;
+@property (nonatomic) NSTimeInterval firstFrameDuration;
+@property (nonatomic) NSUInteger stallCount;
+@property (nonatomic) NSTimeInterval stallDuration;
+@property (nonatomic) SRGMediaPlayerHistogram *stallDurationHistogram;
+@property (nonatomic) SRGMediaPlayerHistogram *seekLatencyHistogram;
+@property (nonatomic) SRGMediaPlayerHistogram *exactSeekLatencyHistogram;
+@property (nonatomic) SRGMediaPlayerHistogram *tolerantSeekLatencyHistogram;
+@property (nonatomic) SRGMediaPlayerHistogram *cancelledSeekDurationHistogram;
+@property (nonatomic) SRGMediaPlayerHistogram *seekDistanceHistogram;
+@property (nonatomic) NSUInteger supersededSeekCount;
+@property (nonatomic) NSUInteger bitrateSwitchCount;
+@property (nonatomic) double indicatedBitrate;
+@property (nonatomic) NSUInteger droppedVideoFrameCount;
+@property (nonatomic) NSUInteger errorCount;
+
+@end
+
+@implementation SRGMediaPlayerMetrics
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithPrepareSystemUptime:(NSTimeInterval)prepareSystemUptime
+                            startupDuration:(NSTimeInterval)startupDuration
+                         firstFrameDuration:(NSTimeInterval)firstFrameDuration
+                                 stallCount:(NSUInteger)stallCount
+                              stallDuration:(NSTimeInterval)stallDuration
+                     stallDurationHistogram:(SRGMediaPlayerHistogram *)stallDurationHistogram
+                       seekLatencyHistogram:(SRGMediaPlayerHistogram *)seekLatencyHistogram
+                             seekStatistics:(const SRGPlayerSeekStatistics *)seekStatistics
+                         bitrateSwitchCount:(NSUInteger)bitrateSwitchCount
+                           indicatedBitrate:(double)indicatedBitrate
+                     droppedVideoFrameCount:(NSUInteger)droppedVideoFrameCount
+                                 errorCount:(NSUInteger)errorCount
+{
+    if (self = [super init]) {
+        self.prepareSystemUptime = prepareSystemUptime;
+        self.startupDuration = startupDuration;
+        self.firstFrameDuration = firstFrameDuration;
+        self.stallCount = stallCount;
+        self.stallDuration = stallDuration;
+        self.stallDurationHistogram = stallDurationHistogram;
+        self.seekLatencyHistogram = seekLatencyHistogram;
+        self.exactSeekLatencyHistogram = [[SRGMediaPlayerHistogram alloc] initWithHistogram:&seekStatistics->exactLatencyHistogram];
+        self.tolerantSeekLatencyHistogram = [[SRGMediaPlayerHistogram alloc] initWithHistogram:&seekStatistics->tolerantLatencyHistogram];
+        self.cancelledSeekDurationHistogram = [[SRGMediaPlayerHistogram alloc] initWithHistogram:&seekStatistics->cancelledDurationHistogram];
+        self.seekDistanceHistogram = [[SRGMediaPlayerHistogram alloc] initWithHistogram:&seekStatistics->distanceHistogram];
+        self.supersededSeekCount = seekStatistics->supersededCount;
+        self.bitrateSwitchCount = bitrateSwitchCount;
+        self.indicatedBitrate = indicatedBitrate;
+        self.droppedVideoFrameCount = droppedVideoFrameCount;
+        self.errorCount = errorCount;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    SRGPlaybackHistogram histogram = { 0 };
+    SRGPlayerSeekStatistics seekStatistics = { 0 };
+    return [self initWithPrepareSystemUptime:NAN
+                             startupDuration:NAN
+                          firstFrameDuration:NAN
+                                  stallCount:0
+                               stallDuration:0.
+                      stallDurationHistogram:[[SRGMediaPlayerHistogram alloc] initWithHistogram:&histogram]
+                        seekLatencyHistogram:[[SRGMediaPlayerHistogram alloc] initWithHistogram:&histogram]
+                              seekStatistics:&seekStatistics
+                          bitrateSwitchCount:0
+                            indicatedBitrate:0.
+                      droppedVideoFrameCount:0
+                                  errorCount:0];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; startupDuration = %@; firstFrameDuration = %@; stallCount = %@; "
+            "stallDuration = %@; seekLatencyHistogram = %@; supersededSeekCount = %@; bitrateSwitchCount = %@; indicatedBitrate = %@; "
+            "droppedVideoFrameCount = %@; errorCount = %@>",
+            self.class,
+            self,
+            @(self.startupDuration),
+            @(self.firstFrameDuration),
+            @(self.stallCount),
+            @(self.stallDuration),
+            self.seekLatencyHistogram,
+            @(self.supersededSeekCount),
+            @(self.bitrateSwitchCount),
+            @(self.indicatedBitrate),
+            @(self.droppedVideoFrameCount),
+            @(self.errorCount)];
+}
+
+@end
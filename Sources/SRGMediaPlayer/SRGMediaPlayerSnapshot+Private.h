@@ -0,0 +1,26 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerSnapshot.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface SRGMediaPlayerSnapshot (Private)
+
+/**
+ *  Create a snapshot with the specified values, captured at the current system uptime.
+ */
+- (instancetype)initWithPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
+                                 time:(CMTime)time
+                            timeRange:(CMTimeRange)timeRange
+                           streamType:(SRGMediaPlayerStreamType)streamType
+                                 live:(BOOL)live
+                effectivePlaybackRate:(float)effectivePlaybackRate
+                       currentSegment:(nullable id<SRGSegment>)currentSegment;
+
+@end
+
+NS_ASSUME_NONNULL_END
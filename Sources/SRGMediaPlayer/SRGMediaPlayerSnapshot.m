@@ -0,0 +1,94 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerSnapshot+Private.h"
+
+@interface SRGMediaPlayerSnapshot ()
+
+@property (nonatomic) SRGMediaPlayerPlaybackState playbackState;
+@property (nonatomic) CMTime time;
+@property (nonatomic) CMTimeRange timeRange;
+@property (nonatomic) SRGMediaPlayerStreamType streamType;
+@property (nonatomic, getter=isLive) BOOL live;
+@property (nonatomic) float effectivePlaybackRate;
+@property (nonatomic) id<SRGSegment> currentSegment;
+@property (nonatomic) NSTimeInterval systemUptime;
+
+@end
+
+@implementation SRGMediaPlayerSnapshot
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithPlaybackState:(SRGMediaPlayerPlaybackState)playbackState
+                                 time:(CMTime)time
+                            timeRange:(CMTimeRange)timeRange
+                           streamType:(SRGMediaPlayerStreamType)streamType
+                                 live:(BOOL)live
+                effectivePlaybackRate:(float)effectivePlaybackRate
+                       currentSegment:(id<SRGSegment>)currentSegment
+{
+    if (self = [super init]) {
+        self.playbackState = playbackState;
+        self.time = time;
+        self.timeRange = timeRange;
+        self.streamType = streamType;
+        self.live = live;
+        self.effectivePlaybackRate = effectivePlaybackRate;
+        self.currentSegment = currentSegment;
+        self.systemUptime = NSProcessInfo.processInfo.systemUptime;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    return [self initWithPlaybackState:SRGMediaPlayerPlaybackStateIdle
+                                  time:kCMTimeZero
+                             timeRange:kCMTimeRangeInvalid
+                            streamType:SRGMediaPlayerStreamTypeUnknown
+                                  live:NO
+                 effectivePlaybackRate:1.f
+                        currentSegment:nil];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Time estimation
+
+- (CMTime)estimatedTimeAtSystemUptime:(NSTimeInterval)systemUptime
+{
+    if (self.playbackState != SRGMediaPlayerPlaybackStatePlaying || ! CMTIME_IS_NUMERIC(self.time)) {
+        return self.time;
+    }
+    
+    NSTimeInterval elapsedTimeInterval = fmax(systemUptime - self.systemUptime, 0.) * self.effectivePlaybackRate;
+    return CMTimeAdd(self.time, CMTimeMakeWithSeconds(elapsedTimeInterval, NSEC_PER_SEC));
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; playbackState = %@; time = %@; timeRange = (%@, %@); streamType = %@; "
+            "live = %@; effectivePlaybackRate = %@; currentSegment = %@; systemUptime = %@>",
+            self.class,
+            self,
+            @(self.playbackState),
+            @(CMTimeGetSeconds(self.time)),
+            @(CMTimeGetSeconds(self.timeRange.start)),
+            @(CMTimeGetSeconds(CMTimeRangeGetEnd(self.timeRange))),
+            @(self.streamType),
+            self.live ? @"YES" : @"NO",
+            @(self.effectivePlaybackRate),
+            self.currentSegment,
+            @(self.systemUptime)];
+}
+
+@end
@@ -0,0 +1,62 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerSpans.h"
+
+#import <stdatomic.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Whether a span backend has been set. Checked (with a relaxed load) before emitting spans from any thread, so that
+ *  disabled spans only cost a branch.
+ */
+OBJC_EXTERN atomic_bool SRGMediaPlayerSpansEnabled;
+
+/**
+ *  Emit span events to the current backend, if any.
+ */
+OBJC_EXTERN uint64_t SRGMediaPlayerSpanBeginWithBackend(const char *name);
+OBJC_EXTERN void SRGMediaPlayerSpanEndWithBackend(const char *name, uint64_t identifier);
+
+/**
+ *  Begin a span, returning its identifier (0 if spans are disabled).
+ */
+static inline uint64_t SRGMediaPlayerSpanBegin(const char *name)
+{
+    return __builtin_expect(atomic_load_explicit(&SRGMediaPlayerSpansEnabled, memory_order_relaxed), NO) ? SRGMediaPlayerSpanBeginWithBackend(name) : 0;
+}
+
+/**
+ *  End a span begun with `SRGMediaPlayerSpanBegin()`.
+ */
+static inline void SRGMediaPlayerSpanEnd(const char *name, uint64_t identifier)
+{
+    if (__builtin_expect(identifier != 0, 0)) {
+        SRGMediaPlayerSpanEndWithBackend(name, identifier);
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint64_t identifier;
+} SRGMediaPlayerScopedSpan;
+
+static inline void SRGMediaPlayerScopedSpanEnd(SRGMediaPlayerScopedSpan *span)
+{
+    SRGMediaPlayerSpanEnd(span->name, span->identifier);
+}
+
+#define SRGMediaPlayerSpanConcat_(a, b) a##b
+#define SRGMediaPlayerSpanConcat(a, b) SRGMediaPlayerSpanConcat_(a, b)
+
+/**
+ *  Emit a span covering the enclosing scope, ending when the scope is exited (whatever the return path).
+ */
+#define SRGMediaPlayerSpanScope(name) \
+    __attribute__((cleanup(SRGMediaPlayerScopedSpanEnd), unused)) SRGMediaPlayerScopedSpan SRGMediaPlayerSpanConcat(srg_span_, __LINE__) = { name, SRGMediaPlayerSpanBegin(name) }
+
+NS_ASSUME_NONNULL_END
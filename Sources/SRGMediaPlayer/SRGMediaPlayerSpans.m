@@ -0,0 +1,49 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerSpans+Private.h"
+
+#import <os/lock.h>
+
+atomic_bool SRGMediaPlayerSpansEnabled = false;
+
+static id<SRGMediaPlayerSpanBackend> s_backend = nil;
+static os_unfair_lock s_backendLock = OS_UNFAIR_LOCK_INIT;
+static atomic_uint_fast64_t s_lastSpanIdentifier = 0;
+
+void SRGMediaPlayerSetSpanBackend(id<SRGMediaPlayerSpanBackend> backend)
+{
+    os_unfair_lock_lock(&s_backendLock);
+    s_backend = backend;
+    atomic_store_explicit(&SRGMediaPlayerSpansEnabled, backend != nil, memory_order_relaxed);
+    os_unfair_lock_unlock(&s_backendLock);
+}
+
+id<SRGMediaPlayerSpanBackend> SRGMediaPlayerSpanBackend(void)
+{
+    os_unfair_lock_lock(&s_backendLock);
+    id<SRGMediaPlayerSpanBackend> backend = s_backend;
+    os_unfair_lock_unlock(&s_backendLock);
+    return backend;
+}
+
+uint64_t SRGMediaPlayerSpanBeginWithBackend(const char *name)
+{
+    id<SRGMediaPlayerSpanBackend> backend = SRGMediaPlayerSpanBackend();
+    if (! backend) {
+        return 0;
+    }
+    
+    uint64_t identifier = atomic_fetch_add(&s_lastSpanIdentifier, 1) + 1;
+    [backend beginSpanWithName:name identifier:identifier];
+    return identifier;
+}
+
+void SRGMediaPlayerSpanEndWithBackend(const char *name, uint64_t identifier)
+{
+    // Spans begun with a previous backend end with the current one, if any
+    [SRGMediaPlayerSpanBackend() endSpanWithName:name identifier:identifier];
+}
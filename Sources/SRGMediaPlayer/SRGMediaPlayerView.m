@@ -10,6 +10,7 @@
 #import "SRGMediaPlaybackMonoscopicView.h"
 #import "SRGMediaPlaybackFlatView.h"
 #import "SRGMediaPlaybackStereoscopicView.h"
+#import "SRGMediaPlayerSpans+Private.h"
 #import "SRGMediaPlayerView+Private.h"
 
 @import libextobjc;
@@ -114,6 +115,7 @@ static void commonInit(SRGMediaPlayerView *self);
     
     _viewMode = viewMode;
     
+    SRGMediaPlayerSpanScope("switchViewMode");
     [self updateSubviews];
 }
 
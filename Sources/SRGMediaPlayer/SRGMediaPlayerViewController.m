@@ -47,6 +47,22 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
     return nil;
 }
 
+// Compare interstitial time ranges by value, without relying on object equality
+static BOOL SRGMediaPlayerAreEqualInterstitialTimeRanges(NSArray<AVInterstitialTimeRange *> *timeRanges1, NSArray<AVInterstitialTimeRange *> *timeRanges2)
+{
+    NSUInteger count = timeRanges1.count;
+    if (count != timeRanges2.count) {
+        return NO;
+    }
+    
+    for (NSUInteger i = 0; i < count; ++i) {
+        if (! CMTimeRangeEqual(timeRanges1[i].timeRange, timeRanges2[i].timeRange)) {
+            return NO;
+        }
+    }
+    return YES;
+}
+
 /**
  *  Workaround info pane (here called "info center") not being able to adjust its layout to its content. The info pane
  *  is namely cached, thus preventing its layout from being created again. The following API provides all that is required
@@ -118,10 +134,6 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
         }];
         [self updatePlayer];
         
-        [controller addObserver:self keyPath:@keypath(controller.segments) options:0 block:^(MAKVONotification *notification) {
-            @strongify(self)
-            [self reloadData];
-        }];
         [self reloadData];
         
         [controller addObserver:self keyPath:@keypath(controller.view.playbackViewHidden) options:0 block:^(MAKVONotification *notification) {
@@ -143,6 +155,10 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
                                                selector:@selector(playbackDidFail:)
                                                    name:SRGMediaPlayerPlaybackDidFailNotification
                                                  object:controller];
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(segmentsDidChange:)
+                                                   name:SRGMediaPlayerSegmentsDidChangeNotification
+                                                 object:controller];
     }
     return self;
 }
@@ -180,7 +196,7 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
     
     [self.controller.segments enumerateObjectsUsingBlock:^(id<SRGSegment> _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
         if (segment.srg_blocked) {
-            CMTimeRange segmentTimeRange = [self.controller streamTimeRangeForMarkRange:segment.srg_markRange];
+            CMTimeRange segmentTimeRange = [self.controller streamTimeRangeForSegment:segment];
             AVInterstitialTimeRange *interstitialTimeRange = [[AVInterstitialTimeRange alloc] initWithTimeRange:segmentTimeRange];
             [interstitialTimeRanges addObject:interstitialTimeRange];
         }
@@ -189,7 +205,7 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
     // The seek bar interrupts user interaction when interstitials are reloaded. Only reload when a change has been
     // detected.
     NSArray<AVInterstitialTimeRange *> *previousInterstitialTimeRanges = playerItem.interstitialTimeRanges ?: @[];
-    if (! [interstitialTimeRanges isEqualToArray:previousInterstitialTimeRanges]) {
+    if (! SRGMediaPlayerAreEqualInterstitialTimeRanges(interstitialTimeRanges, previousInterstitialTimeRanges)) {
         playerItem.interstitialTimeRanges = interstitialTimeRanges.copy;
     }
 }
@@ -219,10 +235,7 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
 // Returns `YES` iff navigation markers have been updated.
 - (BOOL)reloadNavigationMarkers
 {
-    NSPredicate *predicate = [NSPredicate predicateWithBlock:^BOOL(id<SRGSegment> _Nullable segment, NSDictionary<NSString *,id> * _Nullable bindings) {
-        return ! segment.srg_hidden;
-    }];
-    NSArray<id<SRGSegment>> *visibleSegments = [self.controller.segments filteredArrayUsingPredicate:predicate];
+    NSArray<id<SRGSegment>> *visibleSegments = self.controller.visibleSegments;
     
     NSArray<AVTimedMetadataGroup *> *navigationMarkers = nil;
     if (visibleSegments.count != 0 && [self.delegate respondsToSelector:@selector(playerViewController:navigationMarkersForSegments:)]) {
@@ -367,6 +380,12 @@ static UIView *SRGMediaPlayerViewControllerAudioOnlySubview(UIView *view)
     [self setMediaPlayer:failedPlayer];
 }
 
+- (void)segmentsDidChange:(NSNotification *)notification
+{
+    // Only sent when the segment list actually changed
+    [self reloadData];
+}
+
 @end
 
 #if TARGET_OS_TV
@@ -0,0 +1,80 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import AVFoundation;
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A playback clock executes blocks periodically during playback of an associated player. It works like time observers
+ *  associated with an `AVPlayer`, with the following differences:
+ *    - Seekable time range updates are reported as well.
+ *    - All blocks are driven by a single native periodic time observer and a single seekable time range observation,
+ *      whatever the number of registered blocks and intervals.
+ *    - Blocks are always executed in registration order.
+ *
+ *  The clock ticks at the shortest registered interval (its resolution). Other intervals are rounded to a multiple of
+ *  the resolution, their blocks being executed every corresponding number of ticks. All blocks are executed when
+ *  playback time jumps (e.g. after a seek or when playback starts or stops), the clock phase being reset.
+ */
+@interface SRGPlaybackClock : NSObject
+
+/**
+ *  Register a block for periodic execution.
+ *
+ *  @param interval The interval at which the block must be executed.
+ *  @param queue    The serial queue onto which block should be enqueued (main queue if `NULL`).
+ *  @param block    The block to execute.
+ *
+ *  @return An opaque observer, which must be used for removal. Observers are compact integer handles which are never
+ *          reused, so that removing an observer twice is harmless. Registration and removal are made in constant time,
+ *          except when they change the clock resolution.
+ *
+ *  @discussion Blocks executed on a custom queue receive the most recent tick time. Ticks occurring while a previous
+ *              execution is still enqueued are coalesced with it.
+ */
+- (id)addObserverForInterval:(CMTime)interval queue:(nullable dispatch_queue_t)queue usingBlock:(void (^)(CMTime time))block;
+
+/**
+ *  Remove an observer (does nothing if the observer is not registered).
+ */
+- (void)removeObserver:(id)observer;
+
+/**
+ *  The number of registered observers.
+ */
+@property (nonatomic, readonly) NSUInteger observerCount;
+
+/**
+ *  The interval between two clock ticks, `kCMTimeInvalid` if no observers are registered.
+ */
+@property (nonatomic, readonly) CMTime resolution;
+
+/**
+ *  The player to which the clock has been attached, `nil` if none.
+ */
+@property (nonatomic, readonly, weak, nullable) AVPlayer *player;
+
+/**
+ *  Execute the blocks due at the specified time, as the associated player does when playing (only when its item is
+ *  ready to play). Mostly useful for testing purposes.
+ */
+- (void)tickWithTime:(CMTime)time;
+
+/**
+ *  Attach to a player. If a previous association existed, it will be removed first.
+ */
+- (void)attachToPlayer:(AVPlayer *)player;
+
+/**
+ *  Detach the clock from the associated player, if any.
+ */
+- (void)detachFromPlayer;
+
+@end
+
+NS_ASSUME_NONNULL_END
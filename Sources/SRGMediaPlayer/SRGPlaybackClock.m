@@ -0,0 +1,420 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGPlaybackClock.h"
+
+#import <os/lock.h>
+
+@import libextobjc;
+@import MAKVONotificationCenter;
+
+// Observer handles pack the slot generation (high 32 bits) and the slot index (low 32 bits)
+static NSNumber *SRGPlaybackClockHandle(uint32_t slot, uint32_t generation)
+{
+    return @(((uint64_t)generation << 32) | slot);
+}
+
+static void SRGPlaybackClockObserverDeliver(void *context);
+
+@interface SRGPlaybackClockObserver : NSObject {
+@public
+    // Delivery to observers with a custom queue. At most one delivery is enqueued at any time, with the most recent
+    // tick time, so that ticks do not allocate (as a block would) and do not pile up if the queue is busy
+    os_unfair_lock _lock;
+    void (^_block)(CMTime time);                        // Accessed with the lock held
+    CMTime _pendingTime;
+    BOOL _deliveryScheduled;
+}
+
+@property (nonatomic) CMTime interval;
+@property (nonatomic) dispatch_queue_t queue;
+@property (nonatomic, copy) void (^block)(CMTime time);
+
+@property (nonatomic) NSNumber *handle;                 // Retained so that callers can store weak references to it
+@property (nonatomic) NSUInteger period;                // Number of clock ticks between block executions
+
+// Observers are linked in registration order
+@property (nonatomic) SRGPlaybackClockObserver *next;
+@property (nonatomic, weak) SRGPlaybackClockObserver *previous;
+
+@end
+
+@interface SRGPlaybackClock () {
+@private
+    uint32_t *_generations;                             // Incremented each time the corresponding slot is freed
+    uint32_t *_freeSlots;
+    NSUInteger _freeSlotCount;
+    NSUInteger _capacity;
+}
+
+@property (nonatomic) NSMutableArray *slots;            // Contains observers, or `NSNull` for free slots
+
+@property (nonatomic) SRGPlaybackClockObserver *firstObserver;
+@property (nonatomic, weak) SRGPlaybackClockObserver *lastObserver;
+@property (nonatomic) NSUInteger observerCount;
+
+@property (nonatomic) NSArray<SRGPlaybackClockObserver *> *dispatchObservers;
+
+@property (nonatomic) CMTime resolution;
+@property (nonatomic) NSUInteger resolutionObserverCount;   // Number of observers whose interval is the resolution
+
+@property (nonatomic, weak) AVPlayer *player;
+@property (nonatomic) id timeObserver;
+
+@property (nonatomic) NSUInteger tickCount;
+@property (nonatomic) CMTime lastTickTime;
+
+@end
+
+@implementation SRGPlaybackClock
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        self.slots = [NSMutableArray array];
+        self.resolution = kCMTimeInvalid;
+        self.lastTickTime = kCMTimeInvalid;
+    }
+    return self;
+}
+
+- (void)dealloc
+{
+    [self removeNativeObservers];
+    
+    free(_generations);
+    free(_freeSlots);
+}
+
+#pragma mark Associating with a player
+
+- (void)attachToPlayer:(AVPlayer *)player
+{
+    if (self.player == player) {
+        return;
+    }
+    
+    [self removeNativeObservers];
+    self.player = player;
+    [self installNativeObservers];
+}
+
+- (void)detachFromPlayer
+{
+    [self removeNativeObservers];
+    self.player = nil;
+}
+
+#pragma mark Managing observers
+
+- (id)addObserverForInterval:(CMTime)interval queue:(dispatch_queue_t)queue usingBlock:(void (^)(CMTime))block
+{
+    NSParameterAssert(block);
+    
+    SRGPlaybackClockObserver *observer = [[SRGPlaybackClockObserver alloc] init];
+    observer.interval = interval;
+    observer.queue = queue;
+    observer.block = block;
+    
+    uint32_t slot = 0;
+    if (_freeSlotCount != 0) {
+        slot = _freeSlots[--_freeSlotCount];
+        self.slots[slot] = observer;
+    }
+    else {
+        if (self.slots.count == _capacity) {
+            _capacity = MAX(2 * _capacity, 8);
+            _generations = realloc(_generations, _capacity * sizeof(uint32_t));
+            _freeSlots = realloc(_freeSlots, _capacity * sizeof(uint32_t));
+        }
+        
+        slot = (uint32_t)self.slots.count;
+        _generations[slot] = 0;
+        [self.slots addObject:observer];
+    }
+    
+    observer.previous = self.lastObserver;
+    if (self.lastObserver) {
+        self.lastObserver.next = observer;
+    }
+    else {
+        self.firstObserver = observer;
+    }
+    self.lastObserver = observer;
+    self.observerCount += 1;
+    self.dispatchObservers = nil;
+    
+    // The whole schedule only needs to be reloaded when the resolution changes
+    if (CMTIME_IS_INVALID(self.resolution) || CMTIME_COMPARE_INLINE(interval, <, self.resolution)) {
+        [self reloadSchedule];
+    }
+    else {
+        if (CMTIME_COMPARE_INLINE(interval, ==, self.resolution)) {
+            self.resolutionObserverCount += 1;
+        }
+        observer.period = [self periodForInterval:interval];
+    }
+    
+    observer.handle = SRGPlaybackClockHandle(slot, _generations[slot]);
+    return observer.handle;
+}
+
+- (void)removeObserver:(id)observer
+{
+    if (! [observer isKindOfClass:NSNumber.class]) {
+        return;
+    }
+    
+    uint64_t handle = [observer unsignedLongLongValue];
+    uint32_t slot = (uint32_t)(handle & UINT32_MAX);
+    uint32_t generation = (uint32_t)(handle >> 32);
+    
+    // Stale handles (slot freed and possibly reused since) are ignored
+    if (slot >= self.slots.count || _generations[slot] != generation || self.slots[slot] == NSNull.null) {
+        return;
+    }
+    
+    SRGPlaybackClockObserver *clockObserver = self.slots[slot];
+    clockObserver.block = nil;                          // Not executed anymore if removed during a tick
+    self.slots[slot] = NSNull.null;
+    _generations[slot] += 1;
+    _freeSlots[_freeSlotCount++] = slot;
+    
+    SRGPlaybackClockObserver *previous = clockObserver.previous;
+    SRGPlaybackClockObserver *next = clockObserver.next;
+    if (previous) {
+        previous.next = next;
+    }
+    else {
+        self.firstObserver = next;
+    }
+    if (next) {
+        next.previous = previous;
+    }
+    else {
+        self.lastObserver = previous;
+    }
+    self.observerCount -= 1;
+    self.dispatchObservers = nil;
+    
+    if (CMTIME_COMPARE_INLINE(clockObserver.interval, ==, self.resolution)) {
+        self.resolutionObserverCount -= 1;
+        if (self.resolutionObserverCount == 0) {
+            [self reloadSchedule];
+        }
+    }
+}
+
+- (NSUInteger)periodForInterval:(CMTime)interval
+{
+    long long period = llround(CMTimeGetSeconds(interval) / CMTimeGetSeconds(self.resolution));
+    return (NSUInteger)MAX(period, 1);
+}
+
+// Determine the clock resolution and the period of each observer, in ticks. The native observer is only installed
+// again if the resolution changed.
+- (void)reloadSchedule
+{
+    CMTime resolution = kCMTimeInvalid;
+    NSUInteger resolutionObserverCount = 0;
+    for (SRGPlaybackClockObserver *observer = self.firstObserver; observer; observer = observer.next) {
+        if (CMTIME_IS_INVALID(resolution) || CMTIME_COMPARE_INLINE(observer.interval, <, resolution)) {
+            resolution = observer.interval;
+            resolutionObserverCount = 1;
+        }
+        else if (CMTIME_COMPARE_INLINE(observer.interval, ==, resolution)) {
+            resolutionObserverCount += 1;
+        }
+    }
+    self.resolutionObserverCount = resolutionObserverCount;
+    
+    if (CMTIME_COMPARE_INLINE(resolution, !=, self.resolution)) {
+        [self removeNativeObservers];
+        self.resolution = resolution;
+        [self installNativeObservers];
+    }
+    
+    for (SRGPlaybackClockObserver *observer = self.firstObserver; observer; observer = observer.next) {
+        observer.period = [self periodForInterval:observer.interval];
+    }
+}
+
+// Blocks are executed from an immutable array, only built again after observers have been added or removed. Ticks
+// therefore do not allocate memory, and blocks can safely add or remove observers (a tick in progress continues with
+// the array it started with).
+- (NSArray<SRGPlaybackClockObserver *> *)dispatchObservers
+{
+    if (! _dispatchObservers) {
+        NSMutableArray<SRGPlaybackClockObserver *> *dispatchObservers = [NSMutableArray arrayWithCapacity:self.observerCount];
+        for (SRGPlaybackClockObserver *observer = self.firstObserver; observer; observer = observer.next) {
+            [dispatchObservers addObject:observer];
+        }
+        _dispatchObservers = dispatchObservers.copy;
+    }
+    return _dispatchObservers;
+}
+
+#pragma mark Ticks
+
+- (void)tickWithTime:(CMTime)time
+{
+    // Regular ticks are separated by the clock resolution. Other ticks result from playback time jumps, to which all
+    // observers must respond. The clock phase is reset in such cases.
+    BOOL regular = NO;
+    if (CMTIME_IS_NUMERIC(self.lastTickTime)) {
+        CMTime deviation = CMTimeAbsoluteValue(CMTimeSubtract(CMTimeSubtract(time, self.lastTickTime), self.resolution));
+        regular = CMTIME_COMPARE_INLINE(deviation, <, CMTimeMultiplyByRatio(self.resolution, 1, 2));
+    }
+    self.lastTickTime = time;
+    
+    NSUInteger tickCount = regular ? self.tickCount + 1 : 0;
+    self.tickCount = tickCount;
+    
+    for (SRGPlaybackClockObserver *observer in self.dispatchObservers) {
+        if (tickCount % observer.period == 0) {
+            [self notifyObserver:observer withTime:time];
+        }
+    }
+}
+
+- (void)notifyAllObserversWithTime:(CMTime)time
+{
+    for (SRGPlaybackClockObserver *observer in self.dispatchObservers) {
+        [self notifyObserver:observer withTime:time];
+    }
+}
+
+- (void)notifyObserver:(SRGPlaybackClockObserver *)observer withTime:(CMTime)time
+{
+    void (^block)(CMTime) = observer.block;
+    if (! block) {
+        return;
+    }
+    
+    dispatch_queue_t queue = observer.queue;
+    if (! queue || queue == dispatch_get_main_queue()) {
+        block(time);
+    }
+    else {
+        os_unfair_lock_lock(&observer->_lock);
+        observer->_pendingTime = time;
+        BOOL deliveryScheduled = observer->_deliveryScheduled;
+        observer->_deliveryScheduled = YES;
+        os_unfair_lock_unlock(&observer->_lock);
+        
+        if (! deliveryScheduled) {
+            dispatch_async_f(queue, (__bridge_retained void *)observer, SRGPlaybackClockObserverDeliver);
+        }
+    }
+}
+
+#pragma mark Native observers
+
+- (void)installNativeObservers
+{
+    if (! self.player || self.timeObserver || CMTIME_IS_INVALID(self.resolution)) {
+        return;
+    }
+    
+    self.lastTickTime = kCMTimeInvalid;
+    
+    @weakify(self)
+    self.timeObserver = [self.player addPeriodicTimeObserverForInterval:self.resolution queue:NULL usingBlock:^(CMTime time) {
+        @strongify(self)
+        AVPlayer *player = self.player;
+        if (! player) {         // It may have disappeared, as it is a weak property
+            [self removeNativeObservers];
+            return;
+        }
+        
+        if (player.currentItem.status == AVPlayerItemStatusReadyToPlay) {
+            [self tickWithTime:time];
+        }
+    }];
+    
+    [self.player addObserver:self keyPath:@keypath(self.player.currentItem.seekableTimeRanges) options:0 block:^(MAKVONotification * _Nonnull notification) {
+        @strongify(self)
+        AVPlayer *player = self.player;
+        if (player.currentItem.status == AVPlayerItemStatusReadyToPlay) {
+            [self notifyAllObserversWithTime:player.currentTime];
+        }
+    }];
+}
+
+- (void)removeNativeObservers
+{
+    if (! self.timeObserver) {
+        return;
+    }
+    
+    [self.player removeTimeObserver:self.timeObserver];
+    self.timeObserver = nil;
+    
+    [self.player removeObserver:self keyPath:@keypath(self.player.currentItem.seekableTimeRanges)];
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; observers = %@; resolution = %@; player = %@>",
+            self.class,
+            self,
+            @(self.observerCount),
+            @(CMTimeGetSeconds(self.resolution)),
+            self.player];
+}
+
+@end
+
+@implementation SRGPlaybackClockObserver
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _lock = OS_UNFAIR_LOCK_INIT;
+    }
+    return self;
+}
+
+#pragma mark Getters and setters
+
+- (void (^)(CMTime))block
+{
+    return _block;
+}
+
+- (void)setBlock:(void (^)(CMTime))block
+{
+    void (^copiedBlock)(CMTime) = [block copy];
+    
+    os_unfair_lock_lock(&_lock);
+    _block = copiedBlock;
+    os_unfair_lock_unlock(&_lock);
+}
+
+@end
+
+#pragma mark Static functions
+
+static void SRGPlaybackClockObserverDeliver(void *context)
+{
+    SRGPlaybackClockObserver *observer = (__bridge_transfer SRGPlaybackClockObserver *)context;
+    
+    os_unfair_lock_lock(&observer->_lock);
+    void (^block)(CMTime) = observer->_block;
+    CMTime time = observer->_pendingTime;
+    observer->_deliveryScheduled = NO;
+    os_unfair_lock_unlock(&observer->_lock);
+    
+    if (block) {
+        block(time);
+    }
+}
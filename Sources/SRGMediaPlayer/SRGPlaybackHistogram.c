@@ -0,0 +1,87 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGPlaybackHistogram.h"
+
+#include <math.h>
+
+#define SRGPlaybackHistogramMinimumValue 0.001
+#define SRGPlaybackHistogramBucketsPerPowerOfTwo 4
+
+// Bucket i (1 <= i < count - 1) contains values in [min * 2^((i - 1) / 4), min * 2^(i / 4))
+static int SRGPlaybackHistogramBucketForValue(double value)
+{
+    if (value < SRGPlaybackHistogramMinimumValue) {
+        return 0;
+    }
+    
+    int bucket = (int)floor(log2(value / SRGPlaybackHistogramMinimumValue) * SRGPlaybackHistogramBucketsPerPowerOfTwo) + 1;
+    return (bucket < SRGPlaybackHistogramBucketCount - 1) ? bucket : SRGPlaybackHistogramBucketCount - 1;
+}
+
+double SRGPlaybackHistogramBucketUpperBound(int bucket)
+{
+    if (bucket >= SRGPlaybackHistogramBucketCount - 1) {
+        return INFINITY;
+    }
+    
+    return SRGPlaybackHistogramMinimumValue * exp2((double)bucket / SRGPlaybackHistogramBucketsPerPowerOfTwo);
+}
+
+void SRGPlaybackHistogramRecord(SRGPlaybackHistogram *histogram, double value)
+{
+    if (! (value >= 0.)) {
+        return;
+    }
+    
+    histogram->buckets[SRGPlaybackHistogramBucketForValue(value)] += 1;
+    histogram->minimum = (histogram->count == 0) ? value : fmin(histogram->minimum, value);
+    histogram->maximum = (histogram->count == 0) ? value : fmax(histogram->maximum, value);
+    histogram->sum += value;
+    histogram->count += 1;
+}
+
+void SRGPlaybackHistogramMerge(SRGPlaybackHistogram *histogram, const SRGPlaybackHistogram *otherHistogram)
+{
+    if (otherHistogram->count == 0) {
+        return;
+    }
+    
+    for (int i = 0; i < SRGPlaybackHistogramBucketCount; ++i) {
+        histogram->buckets[i] += otherHistogram->buckets[i];
+    }
+    histogram->minimum = (histogram->count == 0) ? otherHistogram->minimum : fmin(histogram->minimum, otherHistogram->minimum);
+    histogram->maximum = (histogram->count == 0) ? otherHistogram->maximum : fmax(histogram->maximum, otherHistogram->maximum);
+    histogram->sum += otherHistogram->sum;
+    histogram->count += otherHistogram->count;
+}
+
+double SRGPlaybackHistogramMean(const SRGPlaybackHistogram *histogram)
+{
+    return (histogram->count != 0) ? histogram->sum / histogram->count : 0.;
+}
+
+double SRGPlaybackHistogramValueAtPercentile(const SRGPlaybackHistogram *histogram, double percentile)
+{
+    if (histogram->count == 0) {
+        return 0.;
+    }
+    
+    double clampedPercentile = fmin(fmax(percentile, 0.), 100.);
+    uint64_t rank = (uint64_t)ceil(clampedPercentile / 100. * histogram->count);
+    if (rank == 0) {
+        return histogram->minimum;
+    }
+    
+    uint64_t count = 0;
+    for (int i = 0; i < SRGPlaybackHistogramBucketCount; ++i) {
+        count += histogram->buckets[i];
+        if (count >= rank) {
+            return fmin(fmax(SRGPlaybackHistogramBucketUpperBound(i), histogram->minimum), histogram->maximum);
+        }
+    }
+    return histogram->maximum;
+}
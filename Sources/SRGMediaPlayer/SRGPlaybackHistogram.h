@@ -0,0 +1,65 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGPlaybackHistogram_h
+#define SRGPlaybackHistogram_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Number of histogram buckets. Bucket 0 collects values below 1 millisecond, the last bucket values above the largest
+ *  bucket bound (about 17 minutes). Buckets in between grow exponentially, four per power of two, so that values are
+ *  stored with a relative error below 19%.
+ */
+#define SRGPlaybackHistogramBucketCount 82
+
+/**
+ *  A streaming histogram of durations, in seconds. Values are accumulated in constant memory and time. Histograms can
+ *  be copied by value and are zero-initialized when empty.
+ */
+typedef struct {
+    uint32_t buckets[SRGPlaybackHistogramBucketCount];
+    uint64_t count;
+    double sum;
+    double minimum;
+    double maximum;
+} SRGPlaybackHistogram;
+
+/**
+ *  Record a value (negative values and NaNs are ignored).
+ */
+void SRGPlaybackHistogramRecord(SRGPlaybackHistogram *histogram, double value);
+
+/**
+ *  Merge the values of a histogram into another one.
+ */
+void SRGPlaybackHistogramMerge(SRGPlaybackHistogram *histogram, const SRGPlaybackHistogram *otherHistogram);
+
+/**
+ *  The mean of the recorded values, 0 if none.
+ */
+double SRGPlaybackHistogramMean(const SRGPlaybackHistogram *histogram);
+
+/**
+ *  An estimate of the value below which the specified percentage (between 0 and 100) of recorded values fall, 0 if no
+ *  value has been recorded. Estimates never lie outside the range of recorded values.
+ */
+double SRGPlaybackHistogramValueAtPercentile(const SRGPlaybackHistogram *histogram, double percentile);
+
+/**
+ *  The upper bound of the specified bucket, in seconds (infinity for the last bucket).
+ */
+double SRGPlaybackHistogramBucketUpperBound(int bucket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGPlaybackHistogram_h */
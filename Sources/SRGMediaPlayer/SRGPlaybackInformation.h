@@ -0,0 +1,60 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerConstants.h"
+
+@import AVFoundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Plain value capture of everything playback information is computed from. Capture and computation are separate so
+ *  that the computation can be tested in isolation. Both are made inline on the main thread.
+ */
+typedef struct {
+    BOOL readyToPlay;                                   // Whether the player item is ready to play.
+    BOOL hasLoadedTimeRanges;
+    CMTimeRange firstSeekableTimeRange;                 // `kCMTimeRangeInvalid` if none.
+    CMTimeRange lastSeekableTimeRange;                  // `kCMTimeRangeInvalid` if none.
+    CMTime duration;
+    CMTime currentTime;
+    NSTimeInterval currentTimeIntervalSinceReferenceDate; // Date matching the current time, `NAN` if none.
+    BOOL seeking;                                       // Whether a seek was being made.
+    NSTimeInterval seekElapsedTime;                     // Time elapsed since the last seek ended, `DBL_MAX` if none.
+    
+    NSTimeInterval minimumDVRWindowLength;
+    NSTimeInterval liveTolerance;
+    float playbackRate;                                 // Desired playback rate.
+    float effectivePlaybackRate;                        // Effective playback rate currently applied.
+    
+    BOOL cached;                                        // If set, the time range and stream type below are used.
+    CMTimeRange cachedTimeRange;
+    SRGMediaPlayerStreamType cachedStreamType;
+} SRGPlaybackInformationInput;
+
+/**
+ *  Playback information.
+ */
+typedef struct {
+    CMTimeRange timeRange;
+    SRGMediaPlayerStreamType streamType;
+    BOOL live;
+    float effectivePlaybackRate;
+} SRGPlaybackInformation;
+
+/**
+ *  Capture the input required to compute playback information for the specified player item. Must be called on the
+ *  main thread.
+ */
+OBJC_EXPORT SRGPlaybackInformationInput SRGPlaybackInformationInputForPlayerItem(AVPlayerItem * _Nullable playerItem);
+
+/**
+ *  Compute playback information from the specified input. Pure function, without any dependency on player objects, so
+ *  that it can be tested with arbitrary input.
+ */
+OBJC_EXPORT SRGPlaybackInformation SRGPlaybackInformationMake(SRGPlaybackInformationInput input);
+
+NS_ASSUME_NONNULL_END
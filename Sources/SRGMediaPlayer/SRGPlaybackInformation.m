@@ -0,0 +1,154 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGPlaybackInformation.h"
+
+static CMTimeRange SRGPlaybackInformationTimeRange(SRGPlaybackInformationInput input)
+{
+    if (! input.readyToPlay) {
+        return kCMTimeRangeInvalid;
+    }
+    
+    CMTimeRange firstSeekableTimeRange = input.firstSeekableTimeRange;
+    CMTimeRange lastSeekableTimeRange = input.lastSeekableTimeRange;
+    
+    if (CMTIMERANGE_IS_INVALID(firstSeekableTimeRange) || CMTIMERANGE_IS_INVALID(lastSeekableTimeRange)) {
+        return input.hasLoadedTimeRanges ? kCMTimeRangeZero : kCMTimeRangeInvalid;
+    }
+    
+    CMTimeRange timeRange = CMTimeRangeFromTimeToTime(firstSeekableTimeRange.start, CMTimeRangeGetEnd(lastSeekableTimeRange));
+    
+    // DVR window size too small. Check that we the stream is not an on-demand one first, of course
+    if (CMTIME_IS_INDEFINITE(input.duration) && CMTimeGetSeconds(timeRange.duration) < input.minimumDVRWindowLength) {
+        return CMTimeRangeMake(timeRange.start, kCMTimeZero);
+    }
+    else {
+        return timeRange;
+    }
+}
+
+static SRGMediaPlayerStreamType SRGPlaybackInformationStreamType(SRGPlaybackInformationInput input, CMTimeRange timeRange)
+{
+    if (CMTIMERANGE_IS_INVALID(timeRange)) {
+        return SRGMediaPlayerStreamTypeUnknown;
+    }
+    
+    if (CMTIMERANGE_IS_EMPTY(timeRange)) {
+        return SRGMediaPlayerStreamTypeLive;
+    }
+    else {
+        CMTime duration = input.duration;
+        
+        if (CMTIME_IS_INDEFINITE(duration)) {
+            return SRGMediaPlayerStreamTypeDVR;
+        }
+        else if (CMTIME_COMPARE_INLINE(duration, !=, kCMTimeZero)) {
+            return SRGMediaPlayerStreamTypeOnDemand;
+        }
+        else {
+            return SRGMediaPlayerStreamTypeLive;
+        }
+    }
+}
+
+static BOOL SRGPlaybackInformationIsNearLiveEdge(SRGPlaybackInformationInput input, NSTimeInterval tolerance, CMTimeRange timeRange, SRGMediaPlayerStreamType streamType)
+{
+    NSCAssert(tolerance >= 0., @"The tolerance must be >= 0");
+    
+    if (streamType == SRGMediaPlayerStreamTypeLive) {
+        return YES;
+    }
+    else if (streamType == SRGMediaPlayerStreamTypeDVR) {
+        return CMTimeGetSeconds(CMTimeSubtract(CMTimeRangeGetEnd(timeRange), input.currentTime)) < tolerance;
+    }
+    else {
+        return NO;
+    }
+}
+
+/**
+ *  Calculate the effective playback rate. This is required for DVR streams which require the rate to be adjusted near
+ *  the live edge to avoid playback issues (playing in the future is not possible) as chunks are added near the live
+ *  edge. This function also delivers correct effective playback rates for on-demand and livestreams without DVR.
+ *
+ *  For a DVR livestreams this function adjusts the playback rate differently depending on where the playhead position
+ *  currently is, as follows:
+ *
+ *
+ *                               Restore to desired rate                                 Limit to 1 at most
+ *
+ *                                 ◀──────────────────                                   ──────────────────▶
+ *
+ *    ┌─────────────────────────────────────┬────────────────────────────────────────────────────┬───────────────────────────────┐
+ *    │                                     │                                                    │                               │
+ *    │           Desired rate              │                  Keep current rate                 │         Max rate = 1          │
+ *    │                                     │                                                    │                               │
+ *    └─────────────────────────────────────┼────────────────────────────────────────────────────┼───────────────────────────────┤
+ *                                          │                                                    │                               │
+ *
+ *                                 kLiveEdgeTolerance +                                   kLiveEdgeTolerance                    Live
+ *                                   liveTolerance                                                                              edge
+ *
+ */
+static float SRGPlaybackInformationEffectivePlaybackRate(SRGPlaybackInformationInput input, CMTimeRange timeRange, SRGMediaPlayerStreamType streamType)
+{
+    static const NSTimeInterval kLiveEdgeTolerance = 5.;
+    
+    if (streamType == SRGMediaPlayerStreamTypeLive) {
+        return 1.f;
+    }
+    // When the distance from the live edge is below some tolerance we want the effective playback rate to be at most 1,
+    // as larger values would make playback fail when reaching the edge.
+    else if (SRGPlaybackInformationIsNearLiveEdge(input, kLiveEdgeTolerance, timeRange, streamType)) {
+        return fminf(input.playbackRate, 1.f);
+    }
+    // Conversely the playback rate can be restored to the intended rate when getting away from the live edge, but this
+    // cannot happen using the same tolerance as when nearing the edge. Chunks being periodically added would otherwise make
+    // the effective playback rate oscillate between the intended value and 1, which would be awkward. By adding the live
+    // tolerance (which should be larger than a multiple of the chunk size) to the live edge tolerance we obtain a tolerance
+    // at which the desired playback rate can be reliably applied.
+    else if (! SRGPlaybackInformationIsNearLiveEdge(input, kLiveEdgeTolerance + input.liveTolerance, timeRange, streamType)) {
+        return input.playbackRate;
+    }
+    // In between both tolerances, and if fast playback speed is desired, we keep the current effective playback rate. This
+    // ensures the optimal effective playback rate is applied, whether we are nearing the edge or getting away from it.
+    else {
+        return (input.playbackRate > 1.f && input.effectivePlaybackRate == 1.f) ? input.effectivePlaybackRate : input.playbackRate;
+    }
+}
+
+SRGPlaybackInformationInput SRGPlaybackInformationInputForPlayerItem(AVPlayerItem *playerItem)
+{
+    NSCAssert(NSThread.isMainThread, @"Must be called from the main thread");
+    
+    SRGPlaybackInformationInput input = {0};
+    input.readyToPlay = (playerItem.status == AVPlayerItemStatusReadyToPlay);
+    input.hasLoadedTimeRanges = (playerItem.loadedTimeRanges.count != 0);
+    
+    NSArray<NSValue *> *seekableTimeRanges = playerItem.seekableTimeRanges;
+    NSValue *firstSeekableTimeRangeValue = seekableTimeRanges.firstObject;
+    NSValue *lastSeekableTimeRangeValue = seekableTimeRanges.lastObject;
+    input.firstSeekableTimeRange = firstSeekableTimeRangeValue ? firstSeekableTimeRangeValue.CMTimeRangeValue : kCMTimeRangeInvalid;
+    input.lastSeekableTimeRange = lastSeekableTimeRangeValue ? lastSeekableTimeRangeValue.CMTimeRangeValue : kCMTimeRangeInvalid;
+    
+    input.duration = playerItem ? playerItem.duration : kCMTimeInvalid;
+    input.currentTime = playerItem ? playerItem.currentTime : kCMTimeInvalid;
+    
+    NSDate *currentDate = playerItem.currentDate;
+    input.currentTimeIntervalSinceReferenceDate = currentDate ? currentDate.timeIntervalSinceReferenceDate : NAN;
+    input.seekElapsedTime = DBL_MAX;
+    return input;
+}
+
+SRGPlaybackInformation SRGPlaybackInformationMake(SRGPlaybackInformationInput input)
+{
+    SRGPlaybackInformation playbackInformation;
+    playbackInformation.timeRange = input.cached ? input.cachedTimeRange : SRGPlaybackInformationTimeRange(input);
+    playbackInformation.streamType = input.cached ? input.cachedStreamType : SRGPlaybackInformationStreamType(input, playbackInformation.timeRange);
+    playbackInformation.live = SRGPlaybackInformationIsNearLiveEdge(input, input.liveTolerance, playbackInformation.timeRange, playbackInformation.streamType);
+    playbackInformation.effectivePlaybackRate = SRGPlaybackInformationEffectivePlaybackRate(input, playbackInformation.timeRange, playbackInformation.streamType);
+    return playbackInformation;
+}
@@ -0,0 +1,77 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerMetrics.h"
+#import "SRGPlayer.h"
+
+@import AVFoundation;
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Collects quality-of-experience metrics for a playback session. Times are system uptimes (see `-[NSProcessInfo
+ *  systemUptime]`), provided by the caller so that measurements can be tested deterministically. Inputs received
+ *  before a session has been started are ignored.
+ *
+ *  Collectors are not thread-safe.
+ */
+@interface SRGPlaybackMetricsCollector : NSObject
+
+/**
+ *  Start a new session, discarding all metrics collected so far.
+ */
+- (void)startSessionAtTime:(NSTimeInterval)time;
+
+/**
+ *  Start playing a new item within the current session (e.g. after the item was reloaded to recover from a stall).
+ *  Metrics derived from the logs of the items played so far are kept, those of the new item being added to them.
+ */
+- (void)startItem;
+
+/**
+ *  Record that the player is ready to play at its start position. Only the first call of a session is recorded.
+ */
+- (void)recordReadyToPlayAtTime:(NSTimeInterval)time;
+
+/**
+ *  Record that a video frame is ready for display. Only the first call of a session is recorded.
+ */
+- (void)recordFirstFrameAtTime:(NSTimeInterval)time;
+
+/**
+ *  Record the start and end of a stall.
+ */
+- (void)recordStallStartAtTime:(NSTimeInterval)time;
+- (void)recordStallEndAtTime:(NSTimeInterval)time;
+
+/**
+ *  Record the start and end of a seek. Seeks requested while a seek is already pending are measured from the first
+ *  request.
+ */
+- (void)recordSeekStartAtTime:(NSTimeInterval)time;
+- (void)recordSeekEndAtTime:(NSTimeInterval)time;
+
+/**
+ *  Update the metrics derived from the logs of the item being played, added to those of the items previously played
+ *  during the session (@see `-startItem`). Values are kept until the next session starts, even when the item is gone.
+ */
+- (void)updateWithAccessLog:(nullable AVPlayerItemAccessLog *)accessLog errorLog:(nullable AVPlayerItemErrorLog *)errorLog;
+
+/**
+ *  Update the metrics derived from the seek statistics of the player. Values are kept until the next session starts,
+ *  even when the player is gone.
+ */
+- (void)updateWithSeekStatistics:(const SRGPlayerSeekStatistics *)seekStatistics;
+
+/**
+ *  A summary of the metrics collected so far, ongoing stalls being accounted for up to the specified time.
+ */
+- (SRGMediaPlayerMetrics *)metricsAtTime:(NSTimeInterval)time;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,208 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGPlaybackMetricsCollector.h"
+
+#import "SRGMediaPlayerHistogram+Private.h"
+#import "SRGMediaPlayerMetrics+Private.h"
+
+@implementation SRGPlaybackMetricsCollector {
+@private
+    NSTimeInterval _prepareTime;
+    NSTimeInterval _readyToPlayTime;
+    NSTimeInterval _firstFrameTime;
+    NSTimeInterval _stallStartTime;
+    NSTimeInterval _seekStartTime;
+    
+    NSUInteger _stallCount;
+    SRGPlaybackHistogram _stallDurationHistogram;
+    SRGPlaybackHistogram _seekLatencyHistogram;
+    SRGPlayerSeekStatistics _seekStatistics;
+    
+    NSUInteger _bitrateSwitchCount;
+    double _indicatedBitrate;
+    NSUInteger _droppedVideoFrameCount;
+    NSUInteger _errorCount;
+    
+    // Log-derived values accumulated over the items previously played during the session
+    NSUInteger _previousItemsBitrateSwitchCount;
+    double _previousItemsIndicatedBitrate;
+    NSUInteger _previousItemsDroppedVideoFrameCount;
+    NSUInteger _previousItemsErrorCount;
+}
+
+#pragma mark Object lifecycle
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        _prepareTime = NAN;
+        [self reset];
+    }
+    return self;
+}
+
+#pragma mark Session
+
+- (void)reset
+{
+    _readyToPlayTime = NAN;
+    _firstFrameTime = NAN;
+    _stallStartTime = NAN;
+    _seekStartTime = NAN;
+    
+    _stallCount = 0;
+    _stallDurationHistogram = (SRGPlaybackHistogram){ 0 };
+    _seekLatencyHistogram = (SRGPlaybackHistogram){ 0 };
+    _seekStatistics = (SRGPlayerSeekStatistics){ 0 };
+    
+    _bitrateSwitchCount = 0;
+    _indicatedBitrate = 0.;
+    _droppedVideoFrameCount = 0;
+    _errorCount = 0;
+    
+    _previousItemsBitrateSwitchCount = 0;
+    _previousItemsIndicatedBitrate = 0.;
+    _previousItemsDroppedVideoFrameCount = 0;
+    _previousItemsErrorCount = 0;
+}
+
+- (BOOL)isSessionStarted
+{
+    return ! isnan(_prepareTime);
+}
+
+- (void)startSessionAtTime:(NSTimeInterval)time
+{
+    [self reset];
+    _prepareTime = time;
+}
+
+- (void)startItem
+{
+    _previousItemsBitrateSwitchCount = _bitrateSwitchCount;
+    _previousItemsIndicatedBitrate = _indicatedBitrate;
+    _previousItemsDroppedVideoFrameCount = _droppedVideoFrameCount;
+    _previousItemsErrorCount = _errorCount;
+}
+
+#pragma mark Events
+
+- (void)recordReadyToPlayAtTime:(NSTimeInterval)time
+{
+    if ([self isSessionStarted] && isnan(_readyToPlayTime)) {
+        _readyToPlayTime = time;
+    }
+}
+
+- (void)recordFirstFrameAtTime:(NSTimeInterval)time
+{
+    if ([self isSessionStarted] && isnan(_firstFrameTime)) {
+        _firstFrameTime = time;
+    }
+}
+
+- (void)recordStallStartAtTime:(NSTimeInterval)time
+{
+    if ([self isSessionStarted] && isnan(_stallStartTime)) {
+        _stallStartTime = time;
+        _stallCount += 1;
+    }
+}
+
+- (void)recordStallEndAtTime:(NSTimeInterval)time
+{
+    if (! isnan(_stallStartTime)) {
+        SRGPlaybackHistogramRecord(&_stallDurationHistogram, time - _stallStartTime);
+        _stallStartTime = NAN;
+    }
+}
+
+- (void)recordSeekStartAtTime:(NSTimeInterval)time
+{
+    if ([self isSessionStarted] && isnan(_seekStartTime)) {
+        _seekStartTime = time;
+    }
+}
+
+- (void)recordSeekEndAtTime:(NSTimeInterval)time
+{
+    if (! isnan(_seekStartTime)) {
+        SRGPlaybackHistogramRecord(&_seekLatencyHistogram, time - _seekStartTime);
+        _seekStartTime = NAN;
+    }
+}
+
+#pragma mark Logs
+
+- (void)updateWithAccessLog:(AVPlayerItemAccessLog *)accessLog errorLog:(AVPlayerItemErrorLog *)errorLog
+{
+    if (! [self isSessionStarted]) {
+        return;
+    }
+    
+    // A new access log event is created when the variant changes, but also for other reasons (e.g. seeks). Only count
+    // events with a different bitrate as switches, including with respect to the bitrate of the previous item.
+    NSArray<AVPlayerItemAccessLogEvent *> *events = accessLog.events;
+    if (events.count != 0) {
+        NSUInteger bitrateSwitchCount = _previousItemsBitrateSwitchCount;
+        NSUInteger droppedVideoFrameCount = _previousItemsDroppedVideoFrameCount;
+        double previousIndicatedBitrate = _previousItemsIndicatedBitrate;
+        for (AVPlayerItemAccessLogEvent *event in events) {
+            if (previousIndicatedBitrate > 0. && event.indicatedBitrate > 0. && event.indicatedBitrate != previousIndicatedBitrate) {
+                bitrateSwitchCount += 1;
+            }
+            if (event.indicatedBitrate > 0.) {
+                previousIndicatedBitrate = event.indicatedBitrate;
+            }
+            if (event.numberOfDroppedVideoFrames > 0) {
+                droppedVideoFrameCount += event.numberOfDroppedVideoFrames;
+            }
+        }
+        
+        _bitrateSwitchCount = bitrateSwitchCount;
+        _indicatedBitrate = previousIndicatedBitrate;
+        _droppedVideoFrameCount = droppedVideoFrameCount;
+    }
+    
+    if (errorLog) {
+        _errorCount = _previousItemsErrorCount + errorLog.events.count;
+    }
+}
+
+#pragma mark Seeks
+
+- (void)updateWithSeekStatistics:(const SRGPlayerSeekStatistics *)seekStatistics
+{
+    if ([self isSessionStarted]) {
+        _seekStatistics = *seekStatistics;
+    }
+}
+
+#pragma mark Metrics
+
+- (SRGMediaPlayerMetrics *)metricsAtTime:(NSTimeInterval)time
+{
+    NSTimeInterval stallDuration = _stallDurationHistogram.sum;
+    if (! isnan(_stallStartTime)) {
+        stallDuration += fmax(time - _stallStartTime, 0.);
+    }
+    
+    return [[SRGMediaPlayerMetrics alloc] initWithPrepareSystemUptime:_prepareTime
+                                                      startupDuration:_readyToPlayTime - _prepareTime
+                                                   firstFrameDuration:_firstFrameTime - _prepareTime
+                                                           stallCount:_stallCount
+                                                        stallDuration:stallDuration
+                                               stallDurationHistogram:[[SRGMediaPlayerHistogram alloc] initWithHistogram:&_stallDurationHistogram]
+                                                 seekLatencyHistogram:[[SRGMediaPlayerHistogram alloc] initWithHistogram:&_seekLatencyHistogram]
+                                                       seekStatistics:&_seekStatistics
+                                                   bitrateSwitchCount:_bitrateSwitchCount
+                                                     indicatedBitrate:_indicatedBitrate
+                                               droppedVideoFrameCount:_droppedVideoFrameCount
+                                                           errorCount:_errorCount];
+}
+
+@end
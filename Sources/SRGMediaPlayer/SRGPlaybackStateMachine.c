@@ -0,0 +1,142 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGPlaybackStateMachine.h"
+
+#include <assert.h>
+
+#define SRGPlaybackStateMachineStateCount 7
+
+/**
+ *  Transition targets. Besides fixed states, some targets depend on the player context the event was received in.
+ */
+typedef enum {
+    SRGPlaybackStateMachineTargetNone = 0,                      // Event ignored.
+    SRGPlaybackStateMachineTargetIdle,
+    SRGPlaybackStateMachineTargetPreparing,
+    SRGPlaybackStateMachineTargetSeeking,
+    SRGPlaybackStateMachineTargetStalled,
+    SRGPlaybackStateMachineTargetPlaying,
+    SRGPlaybackStateMachineTargetEnded,
+    SRGPlaybackStateMachineTargetRate,                          // Playing or paused, depending on the player rate.
+    SRGPlaybackStateMachineTargetRateUnlessAtEnd,               // Same as above, except at the end (non-streamed medias pause right before ending).
+    SRGPlaybackStateMachineTargetPlayingIfRate                  // Playing if the player rate is not zero (playback restarted after it ended).
+} SRGPlaybackStateMachineTarget;
+
+#define ANY_STATE(target) { target, target, target, target, target, target, target }
+
+// Rows are indexed by event type, columns by state (idle, preparing, playing, seeking, paused, stalled, ended)
+static const SRGPlaybackStateMachineTarget SRGPlaybackStateMachineTransitions[SRGPlaybackStateMachineEventTypeCount][SRGPlaybackStateMachineStateCount] = {
+    [SRGPlaybackStateMachineEventTypeReset] = ANY_STATE(SRGPlaybackStateMachineTargetIdle),
+    [SRGPlaybackStateMachineEventTypePrepare] = ANY_STATE(SRGPlaybackStateMachineTargetPreparing),
+    [SRGPlaybackStateMachineEventTypeStartCompleted] = {
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetRate,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone
+    },
+    [SRGPlaybackStateMachineEventTypeRateChanged] = {
+        SRGPlaybackStateMachineTargetRateUnlessAtEnd,
+        SRGPlaybackStateMachineTargetRateUnlessAtEnd,
+        SRGPlaybackStateMachineTargetRateUnlessAtEnd,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetRateUnlessAtEnd,
+        SRGPlaybackStateMachineTargetRateUnlessAtEnd,
+        SRGPlaybackStateMachineTargetPlayingIfRate
+    },
+    [SRGPlaybackStateMachineEventTypeSeekStarted] = ANY_STATE(SRGPlaybackStateMachineTargetSeeking),
+    [SRGPlaybackStateMachineEventTypeSeekEnded] = ANY_STATE(SRGPlaybackStateMachineTargetRate),
+    [SRGPlaybackStateMachineEventTypePlayedToEnd] = ANY_STATE(SRGPlaybackStateMachineTargetEnded),
+    [SRGPlaybackStateMachineEventTypeStallDetected] = {
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetStalled,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone
+    },
+    [SRGPlaybackStateMachineEventTypeStallEnded] = {
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetNone,
+        SRGPlaybackStateMachineTargetPlaying,
+        SRGPlaybackStateMachineTargetNone
+    }
+};
+
+#undef ANY_STATE
+
+SRGPlaybackStateMachineEvent SRGPlaybackStateMachineEventMake(SRGPlaybackStateMachineEventType type, bool playing, bool atEnd)
+{
+    SRGPlaybackStateMachineEvent event = { type, playing, atEnd };
+    return event;
+}
+
+SRGPlaybackStateMachineState SRGPlaybackStateMachineNextState(SRGPlaybackStateMachineState state, SRGPlaybackStateMachineEvent event)
+{
+    assert(state >= SRGPlaybackStateMachineStateIdle && state <= SRGPlaybackStateMachineStateEnded);
+    assert(event.type >= 0 && event.type < SRGPlaybackStateMachineEventTypeCount);
+    
+    SRGPlaybackStateMachineState rateState = event.playing ? SRGPlaybackStateMachineStatePlaying : SRGPlaybackStateMachineStatePaused;
+    
+    switch (SRGPlaybackStateMachineTransitions[event.type][state - SRGPlaybackStateMachineStateIdle]) {
+        case SRGPlaybackStateMachineTargetIdle: {
+            return SRGPlaybackStateMachineStateIdle;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetPreparing: {
+            return SRGPlaybackStateMachineStatePreparing;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetSeeking: {
+            return SRGPlaybackStateMachineStateSeeking;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetStalled: {
+            return SRGPlaybackStateMachineStateStalled;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetPlaying: {
+            return SRGPlaybackStateMachineStatePlaying;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetEnded: {
+            return SRGPlaybackStateMachineStateEnded;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetRate: {
+            return rateState;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetRateUnlessAtEnd: {
+            return event.atEnd ? state : rateState;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineTargetPlayingIfRate: {
+            return event.playing ? SRGPlaybackStateMachineStatePlaying : state;
+            break;
+        }
+        
+        default: {
+            return state;
+            break;
+        }
+    }
+}
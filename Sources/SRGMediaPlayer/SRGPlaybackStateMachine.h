@@ -0,0 +1,69 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGPlaybackStateMachine_h
+#define SRGPlaybackStateMachine_h
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Playback states. Raw values match those of `SRGMediaPlayerPlaybackState`.
+ */
+typedef enum {
+    SRGPlaybackStateMachineStateIdle = 1,
+    SRGPlaybackStateMachineStatePreparing,
+    SRGPlaybackStateMachineStatePlaying,
+    SRGPlaybackStateMachineStateSeeking,
+    SRGPlaybackStateMachineStatePaused,
+    SRGPlaybackStateMachineStateStalled,
+    SRGPlaybackStateMachineStateEnded
+} SRGPlaybackStateMachineState;
+
+/**
+ *  Events driving playback state changes.
+ */
+typedef enum {
+    SRGPlaybackStateMachineEventTypeReset = 0,                  // Playback stopped, reset or failed.
+    SRGPlaybackStateMachineEventTypePrepare,                    // A media is being prepared for playback.
+    SRGPlaybackStateMachineEventTypeStartCompleted,             // The item is ready to play and initially positioned.
+    SRGPlaybackStateMachineEventTypeRateChanged,                // The player rate changed while the item is ready to play.
+    SRGPlaybackStateMachineEventTypeSeekStarted,
+    SRGPlaybackStateMachineEventTypeSeekEnded,
+    SRGPlaybackStateMachineEventTypePlayedToEnd,
+    SRGPlaybackStateMachineEventTypeStallDetected,              // The playhead does not move while playing.
+    SRGPlaybackStateMachineEventTypeStallEnded,                 // The playhead moves again after a stall.
+    SRGPlaybackStateMachineEventTypeCount
+} SRGPlaybackStateMachineEventType;
+
+/**
+ *  An event, with the player context it was received in.
+ */
+typedef struct {
+    SRGPlaybackStateMachineEventType type;
+    bool playing;                                               // Whether the player rate is not zero.
+    bool atEnd;                                                 // Whether the playhead is at the end of a non-empty time range.
+} SRGPlaybackStateMachineEvent;
+
+/**
+ *  Create an event.
+ */
+SRGPlaybackStateMachineEvent SRGPlaybackStateMachineEventMake(SRGPlaybackStateMachineEventType type, bool playing, bool atEnd);
+
+/**
+ *  Return the state reached from the specified state when an event is received (the same state if the event has no
+ *  effect). Pure function without any dependency on AVFoundation.
+ */
+SRGPlaybackStateMachineState SRGPlaybackStateMachineNextState(SRGPlaybackStateMachineState state, SRGPlaybackStateMachineEvent event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGPlaybackStateMachine_h */
@@ -0,0 +1,404 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#include "SRGPlaybackTrace.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// Record layout: total length (1 byte), type (1 byte), timestamp (8 bytes), payload. Multi-byte values are stored
+// little-endian.
+#define SRGPlaybackTraceHeaderLength 10
+#define SRGPlaybackTraceMaximumRecordLength (SRGPlaybackTraceHeaderLength + 16)
+#define SRGPlaybackTraceCheckpointLength (SRGPlaybackTraceHeaderLength + 1)
+
+struct SRGPlaybackTrace {
+    uint8_t *bytes;
+    size_t capacity;
+    size_t head;                                                // Offset of the oldest record.
+    size_t count;                                               // Number of bytes used.
+    uint64_t droppedRecordCount;
+    SRGPlaybackStateMachineState initialState;                  // State reached before the oldest record.
+    uint64_t initialTimestamp;                                  // Timestamp of the last discarded record, if any.
+};
+
+static size_t SRGPlaybackTracePayloadLength(SRGPlaybackTraceRecordType type)
+{
+    switch (type) {
+        case SRGPlaybackTraceRecordTypeCheckpoint: {
+            return 1;
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeStateMachineEvent: {
+            return 3;
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeRate:
+        case SRGPlaybackTraceRecordTypeItemStatus:
+        case SRGPlaybackTraceRecordTypeSegments:
+        case SRGPlaybackTraceRecordTypeNotification:
+        case SRGPlaybackTraceRecordTypeSegmentTransition: {
+            return 4;
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTick:
+        case SRGPlaybackTraceRecordTypeSeekStart:
+        case SRGPlaybackTraceRecordTypeSeekEnd: {
+            return 8;
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTimeRange:
+        case SRGPlaybackTraceRecordTypeSeekableTimeRange:
+        case SRGPlaybackTraceRecordTypeDateSample: {
+            return 16;
+            break;
+        }
+        
+        default: {
+            return SIZE_MAX;
+            break;
+        }
+    }
+}
+
+static void SRGPlaybackTraceEncodeUInt32(uint8_t *bytes, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t SRGPlaybackTraceDecodeUInt32(const uint8_t *bytes)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= (uint32_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+static void SRGPlaybackTraceEncodeUInt64(uint8_t *bytes, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t SRGPlaybackTraceDecodeUInt64(const uint8_t *bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+static void SRGPlaybackTraceEncodeDouble(uint8_t *bytes, double value)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+    SRGPlaybackTraceEncodeUInt64(bytes, bits);
+}
+
+static double SRGPlaybackTraceDecodeDouble(const uint8_t *bytes)
+{
+    uint64_t bits = SRGPlaybackTraceDecodeUInt64(bytes);
+    double value = 0.;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static size_t SRGPlaybackTraceEncodeRecord(const SRGPlaybackTraceRecord *record, uint8_t *bytes)
+{
+    size_t payloadLength = SRGPlaybackTracePayloadLength(record->type);
+    if (payloadLength == SIZE_MAX) {
+        return 0;
+    }
+    
+    size_t length = SRGPlaybackTraceHeaderLength + payloadLength;
+    bytes[0] = (uint8_t)length;
+    bytes[1] = (uint8_t)record->type;
+    SRGPlaybackTraceEncodeUInt64(bytes + 2, record->timestamp);
+    
+    uint8_t *payload = bytes + SRGPlaybackTraceHeaderLength;
+    switch (record->type) {
+        case SRGPlaybackTraceRecordTypeStateMachineEvent: {
+            payload[0] = (uint8_t)record->event.type;
+            payload[1] = record->event.playing ? 1 : 0;
+            payload[2] = record->event.atEnd ? 1 : 0;
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeCheckpoint: {
+            payload[0] = (uint8_t)record->state;
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeRate: {
+            uint32_t bits = 0;
+            memcpy(&bits, &record->rate, sizeof(bits));
+            SRGPlaybackTraceEncodeUInt32(payload, bits);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTick:
+        case SRGPlaybackTraceRecordTypeSeekStart:
+        case SRGPlaybackTraceRecordTypeSeekEnd: {
+            SRGPlaybackTraceEncodeDouble(payload, record->time);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTimeRange:
+        case SRGPlaybackTraceRecordTypeSeekableTimeRange: {
+            SRGPlaybackTraceEncodeDouble(payload, record->timeRange.start);
+            SRGPlaybackTraceEncodeDouble(payload + 8, record->timeRange.duration);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeDateSample: {
+            SRGPlaybackTraceEncodeDouble(payload, record->dateSample.time);
+            SRGPlaybackTraceEncodeDouble(payload + 8, record->dateSample.timeIntervalSinceReferenceDate);
+            break;
+        }
+        
+        default: {
+            SRGPlaybackTraceEncodeUInt32(payload, record->value);
+            break;
+        }
+    }
+    return length;
+}
+
+static SRGPlaybackStateMachineState SRGPlaybackTraceNextState(SRGPlaybackStateMachineState state, const SRGPlaybackTraceRecord *record)
+{
+    switch (record->type) {
+        case SRGPlaybackTraceRecordTypeStateMachineEvent: {
+            return SRGPlaybackStateMachineNextState(state, record->event);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeCheckpoint: {
+            return record->state;
+            break;
+        }
+        
+        default: {
+            return state;
+            break;
+        }
+    }
+}
+
+// Copy bytes starting at the specified offset of the ring buffer, wrapping around its end if needed
+static void SRGPlaybackTraceCopyRingBytes(const SRGPlaybackTrace *trace, size_t offset, size_t length, uint8_t *buffer)
+{
+    size_t firstLength = (length < trace->capacity - offset) ? length : trace->capacity - offset;
+    memcpy(buffer, trace->bytes + offset, firstLength);
+    memcpy(buffer + firstLength, trace->bytes, length - firstLength);
+}
+
+static bool SRGPlaybackTraceHasCheckpoint(const SRGPlaybackTrace *trace)
+{
+    return trace->droppedRecordCount != 0 || trace->initialState != SRGPlaybackStateMachineStateIdle;
+}
+
+SRGPlaybackTrace *SRGPlaybackTraceCreate(size_t capacity, SRGPlaybackStateMachineState state)
+{
+    if (capacity < SRGPlaybackTraceMaximumRecordLength) {
+        return NULL;
+    }
+    
+    SRGPlaybackTrace *trace = calloc(1, sizeof(SRGPlaybackTrace));
+    if (! trace) {
+        return NULL;
+    }
+    
+    trace->bytes = malloc(capacity);
+    if (! trace->bytes) {
+        free(trace);
+        return NULL;
+    }
+    trace->capacity = capacity;
+    trace->initialState = state;
+    return trace;
+}
+
+void SRGPlaybackTraceDestroy(SRGPlaybackTrace *trace)
+{
+    if (! trace) {
+        return;
+    }
+    
+    free(trace->bytes);
+    free(trace);
+}
+
+void SRGPlaybackTraceAppend(SRGPlaybackTrace *trace, const SRGPlaybackTraceRecord *record)
+{
+    uint8_t bytes[SRGPlaybackTraceMaximumRecordLength];
+    size_t length = SRGPlaybackTraceEncodeRecord(record, bytes);
+    if (length == 0) {
+        return;
+    }
+    
+    // Discard the oldest records until there is enough room, keeping track of the state they lead to
+    while (trace->capacity - trace->count < length) {
+        size_t oldestLength = trace->bytes[trace->head];
+        
+        uint8_t oldestBytes[SRGPlaybackTraceMaximumRecordLength];
+        SRGPlaybackTraceCopyRingBytes(trace, trace->head, oldestLength, oldestBytes);
+        
+        size_t offset = 0;
+        SRGPlaybackTraceRecord oldestRecord;
+        if (SRGPlaybackTraceReadRecord(oldestBytes, oldestLength, &offset, &oldestRecord)) {
+            trace->initialState = SRGPlaybackTraceNextState(trace->initialState, &oldestRecord);
+            trace->initialTimestamp = oldestRecord.timestamp;
+        }
+        
+        trace->head = (trace->head + oldestLength) % trace->capacity;
+        trace->count -= oldestLength;
+        trace->droppedRecordCount += 1;
+    }
+    
+    // Records might wrap around the end of the buffer
+    size_t tail = (trace->head + trace->count) % trace->capacity;
+    size_t firstLength = (length < trace->capacity - tail) ? length : trace->capacity - tail;
+    memcpy(trace->bytes + tail, bytes, firstLength);
+    memcpy(trace->bytes, bytes + firstLength, length - firstLength);
+    trace->count += length;
+}
+
+size_t SRGPlaybackTraceByteCount(const SRGPlaybackTrace *trace)
+{
+    return SRGPlaybackTraceHasCheckpoint(trace) ? SRGPlaybackTraceCheckpointLength + trace->count : trace->count;
+}
+
+uint64_t SRGPlaybackTraceDroppedRecordCount(const SRGPlaybackTrace *trace)
+{
+    return trace->droppedRecordCount;
+}
+
+size_t SRGPlaybackTraceCopyBytes(const SRGPlaybackTrace *trace, uint8_t *buffer, size_t length)
+{
+    size_t byteCount = SRGPlaybackTraceByteCount(trace);
+    if (length < byteCount) {
+        return 0;
+    }
+    
+    size_t checkpointLength = 0;
+    if (SRGPlaybackTraceHasCheckpoint(trace)) {
+        SRGPlaybackTraceRecord checkpoint = { .type = SRGPlaybackTraceRecordTypeCheckpoint, .timestamp = trace->initialTimestamp };
+        checkpoint.state = trace->initialState;
+        checkpointLength = SRGPlaybackTraceEncodeRecord(&checkpoint, buffer);
+    }
+    
+    SRGPlaybackTraceCopyRingBytes(trace, trace->head, trace->count, buffer + checkpointLength);
+    return byteCount;
+}
+
+bool SRGPlaybackTraceReadRecord(const uint8_t *bytes, size_t length, size_t *offset, SRGPlaybackTraceRecord *record)
+{
+    if (*offset + SRGPlaybackTraceHeaderLength > length) {
+        return false;
+    }
+    
+    const uint8_t *recordBytes = bytes + *offset;
+    size_t recordLength = recordBytes[0];
+    SRGPlaybackTraceRecordType type = (SRGPlaybackTraceRecordType)recordBytes[1];
+    
+    size_t payloadLength = SRGPlaybackTracePayloadLength(type);
+    if (payloadLength == SIZE_MAX || recordLength != SRGPlaybackTraceHeaderLength + payloadLength || *offset + recordLength > length) {
+        return false;
+    }
+    
+    memset(record, 0, sizeof(SRGPlaybackTraceRecord));
+    record->type = type;
+    record->timestamp = SRGPlaybackTraceDecodeUInt64(recordBytes + 2);
+    
+    const uint8_t *payload = recordBytes + SRGPlaybackTraceHeaderLength;
+    switch (type) {
+        case SRGPlaybackTraceRecordTypeStateMachineEvent: {
+            if (payload[0] >= SRGPlaybackStateMachineEventTypeCount) {
+                return false;
+            }
+            record->event = SRGPlaybackStateMachineEventMake((SRGPlaybackStateMachineEventType)payload[0], payload[1] != 0, payload[2] != 0);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeCheckpoint: {
+            if (payload[0] < SRGPlaybackStateMachineStateIdle || payload[0] > SRGPlaybackStateMachineStateEnded) {
+                return false;
+            }
+            record->state = (SRGPlaybackStateMachineState)payload[0];
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeRate: {
+            uint32_t bits = SRGPlaybackTraceDecodeUInt32(payload);
+            memcpy(&record->rate, &bits, sizeof(bits));
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTick:
+        case SRGPlaybackTraceRecordTypeSeekStart:
+        case SRGPlaybackTraceRecordTypeSeekEnd: {
+            record->time = SRGPlaybackTraceDecodeDouble(payload);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTimeRange:
+        case SRGPlaybackTraceRecordTypeSeekableTimeRange: {
+            record->timeRange.start = SRGPlaybackTraceDecodeDouble(payload);
+            record->timeRange.duration = SRGPlaybackTraceDecodeDouble(payload + 8);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeDateSample: {
+            record->dateSample.time = SRGPlaybackTraceDecodeDouble(payload);
+            record->dateSample.timeIntervalSinceReferenceDate = SRGPlaybackTraceDecodeDouble(payload + 8);
+            break;
+        }
+        
+        default: {
+            record->value = SRGPlaybackTraceDecodeUInt32(payload);
+            break;
+        }
+    }
+    
+    *offset += recordLength;
+    return true;
+}
+
+SRGPlaybackTraceReplaySummary SRGPlaybackTraceReplay(const uint8_t *bytes, size_t length, SRGPlaybackStateMachineState initialState, SRGPlaybackTraceReplayCallback callback, void *context)
+{
+    SRGPlaybackTraceReplaySummary summary = { initialState, 0, 0, false };
+    
+    size_t offset = 0;
+    SRGPlaybackTraceRecord record;
+    while (SRGPlaybackTraceReadRecord(bytes, length, &offset, &record)) {
+        SRGPlaybackStateMachineState state = SRGPlaybackTraceNextState(summary.state, &record);
+        if (state != summary.state) {
+            summary.state = state;
+            
+            // Checkpoints restore a state, they are not transitions
+            if (record.type != SRGPlaybackTraceRecordTypeCheckpoint) {
+                summary.transitionCount += 1;
+            }
+        }
+        summary.recordCount += 1;
+        
+        if (callback) {
+            callback(&record, summary.state, context);
+        }
+    }
+    
+    summary.complete = (offset == length);
+    return summary;
+}
@@ -0,0 +1,150 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef SRGPlaybackTrace_h
+#define SRGPlaybackTrace_h
+
+#include "SRGPlaybackStateMachine.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Types of inputs recorded in a trace.
+ */
+typedef enum {
+    SRGPlaybackTraceRecordTypeStateMachineEvent = 1,            // Event fed to the playback state machine.
+    SRGPlaybackTraceRecordTypeItemStatus,                       // Player item status change (`AVPlayerItemStatus` raw value).
+    SRGPlaybackTraceRecordTypeRate,                             // Player rate change.
+    SRGPlaybackTraceRecordTypeTick,                             // Periodic controller refresh, at the specified time.
+    SRGPlaybackTraceRecordTypeSeekStart,                        // Seek to the specified time.
+    SRGPlaybackTraceRecordTypeSeekEnd,                          // Seek completion at the specified time.
+    SRGPlaybackTraceRecordTypeTimeRange,                        // Time range change.
+    SRGPlaybackTraceRecordTypeSegments,                         // Segment list update, with the new segment count.
+    SRGPlaybackTraceRecordTypeNotification,                     // Notification received (`SRGPlaybackTraceNotification` value).
+    SRGPlaybackTraceRecordTypeSeekableTimeRange,                // Seekable time range change (union of all seekable ranges).
+    SRGPlaybackTraceRecordTypeDateSample,                       // Time / date sample retained for livestreams.
+    SRGPlaybackTraceRecordTypeSegmentTransition,                // Segment transition, with the index of the new segment (`UINT32_MAX` if none).
+    SRGPlaybackTraceRecordTypeCheckpoint                        // Playback state reached before the oldest record of the trace.
+} SRGPlaybackTraceRecordType;
+
+/**
+ *  Notifications recorded in a trace.
+ */
+typedef enum {
+    SRGPlaybackTraceNotificationPlayedToEnd = 1,
+    SRGPlaybackTraceNotificationFailedToPlayToEnd,
+    SRGPlaybackTraceNotificationApplicationDidEnterBackground,
+    SRGPlaybackTraceNotificationApplicationWillEnterForeground
+} SRGPlaybackTraceNotification;
+
+/**
+ *  A trace record. Only the payload member matching the record type is meaningful.
+ */
+typedef struct {
+    SRGPlaybackTraceRecordType type;
+    uint64_t timestamp;                                         // Nanoseconds, on a monotonic clock.
+    union {
+        SRGPlaybackStateMachineEvent event;                     // State machine events.
+        float rate;                                             // Rate changes.
+        double time;                                            // Ticks and seeks, in seconds.
+        struct {
+            double start;
+            double duration;
+        } timeRange;                                            // Time range and seekable time range changes, in seconds.
+        struct {
+            double time;
+            double timeIntervalSinceReferenceDate;
+        } dateSample;                                           // Date samples, in seconds.
+        uint32_t value;                                         // Item status, segment count or index, or notification.
+        SRGPlaybackStateMachineState state;                     // Checkpoints.
+    };
+} SRGPlaybackTraceRecord;
+
+/**
+ *  A trace, recording inputs in a fixed-capacity ring buffer. Records are stored length-prefixed in a compact binary
+ *  form. When the buffer is full, the oldest records are discarded to make room for new ones. The playback state they
+ *  lead to is retained, so that trace contents can always be replayed from the correct state.
+ *
+ *  Traces are not thread-safe.
+ */
+typedef struct SRGPlaybackTrace SRGPlaybackTrace;
+
+/**
+ *  Create a trace with the specified capacity in bytes, starting in the specified playback state. Return `NULL` if the
+ *  capacity is too small to hold a single record, or if memory could not be allocated. Must be released with
+ *  `SRGPlaybackTraceDestroy`.
+ */
+SRGPlaybackTrace *SRGPlaybackTraceCreate(size_t capacity, SRGPlaybackStateMachineState state);
+
+/**
+ *  Destroy a trace.
+ */
+void SRGPlaybackTraceDestroy(SRGPlaybackTrace *trace);
+
+/**
+ *  Append a record to the trace.
+ */
+void SRGPlaybackTraceAppend(SRGPlaybackTrace *trace, const SRGPlaybackTraceRecord *record);
+
+/**
+ *  The number of bytes required to copy the trace contents.
+ */
+size_t SRGPlaybackTraceByteCount(const SRGPlaybackTrace *trace);
+
+/**
+ *  The number of records discarded since the trace was created, for lack of space.
+ */
+uint64_t SRGPlaybackTraceDroppedRecordCount(const SRGPlaybackTrace *trace);
+
+/**
+ *  Copy the trace contents, from its oldest to its most recent record, into the provided buffer. Return the number of
+ *  bytes copied, 0 if the buffer is too small to hold `SRGPlaybackTraceByteCount()` bytes.
+ *
+ *  If records have been discarded, or if the trace was not created in the idle state, contents start with a checkpoint
+ *  record carrying the playback state reached before the oldest record.
+ */
+size_t SRGPlaybackTraceCopyBytes(const SRGPlaybackTrace *trace, uint8_t *buffer, size_t length);
+
+/**
+ *  Read the record found at the specified offset of trace contents obtained with `SRGPlaybackTraceCopyBytes()`. Return
+ *  `true` and advance the offset to the next record if successful, `false` at the end of the trace or if the data is
+ *  corrupt.
+ */
+bool SRGPlaybackTraceReadRecord(const uint8_t *bytes, size_t length, size_t *offset, SRGPlaybackTraceRecord *record);
+
+/**
+ *  Replay callback, called for each record with the playback state reached after it has been applied.
+ */
+typedef void (*SRGPlaybackTraceReplayCallback)(const SRGPlaybackTraceRecord *record, SRGPlaybackStateMachineState state, void *context);
+
+/**
+ *  Replay summary.
+ */
+typedef struct {
+    SRGPlaybackStateMachineState state;                         // State reached at the end of the replay.
+    size_t recordCount;                                         // Number of records replayed.
+    size_t transitionCount;                                     // Number of state changes.
+    bool complete;                                              // `false` if the replay stopped early because of corrupt data.
+} SRGPlaybackTraceReplaySummary;
+
+/**
+ *  Replay trace contents obtained with `SRGPlaybackTraceCopyBytes()` deterministically, as fast as possible, starting
+ *  from the specified state. State machine events are fed to the playback state machine and checkpoints restore the
+ *  state they carry; other records are only reported to the callback (optional).
+ */
+SRGPlaybackTraceReplaySummary SRGPlaybackTraceReplay(const uint8_t *bytes, size_t length, SRGPlaybackStateMachineState initialState, SRGPlaybackTraceReplayCallback callback, void *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRGPlaybackTrace_h */
@@ -4,28 +4,66 @@
 //  License information is available from the LICENSE file.
 //
 
+#import "SRGPlaybackHistogram.h"
+
 @import AVFoundation;
 
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ *  Number of seek records kept by a player (an enum constant, so that it can be used as array size).
+ */
+enum : NSUInteger {
+    SRGPlayerSeekRecordCapacity = 128
+};
+
+/**
+ *  Record of a seek made by a player.
+ */
+typedef struct {
+    NSTimeInterval requestSystemUptime;                         // System uptime at which the seek was requested.
+    NSTimeInterval completionSystemUptime;                      // System uptime at which the seek finished or was cancelled.
+    BOOL finished;                                              // Whether the seek finished.
+    BOOL superseded;                                            // Whether the seek was cancelled by a more recent seek.
+    NSTimeInterval distance;                                    // Distance between the playback and target times, in seconds (`NAN` if unknown).
+    NSTimeInterval toleranceBefore;                             // Tolerances used, in seconds.
+    NSTimeInterval toleranceAfter;
+} SRGPlayerSeekRecord;
+
+/**
+ *  Statistics accumulated over all seeks made by a player. Latencies and distances are in seconds.
+ */
+typedef struct {
+    SRGPlaybackHistogram exactLatencyHistogram;                 // Latency of finished seeks made without tolerance.
+    SRGPlaybackHistogram tolerantLatencyHistogram;              // Latency of finished seeks made with some tolerance.
+    SRGPlaybackHistogram cancelledDurationHistogram;            // Time spent in seeks before they were cancelled.
+    SRGPlaybackHistogram distanceHistogram;                     // Distance of all seeks.
+    NSUInteger supersededCount;                                 // Number of seeks cancelled by a more recent seek.
+} SRGPlayerSeekStatistics;
+
 @class SRGPlayer;
 
 /**
- *  Player delegate protocol.
+ *  Player delegate protocol. Methods are called on the main thread, asynchronously if the seek was requested or
+ *  completed on another thread, but always in the order in which the corresponding events occurred.
+ *
+ *  Each seek request is assigned a sequence number, starting at 1 and incremented with each request (notified or
+ *  not). A completion whose sequence number is lower than the one of the latest `-player:willSeekToTime:sequenceNumber:`
+ *  call received is stale, a more recent seek having been requested in the meantime.
  */
 @protocol SRGPlayerDelegate <NSObject>
 
 /**
  *  The player begins seeking to the given time.
  */
-- (void)player:(SRGPlayer *)player willSeekToTime:(CMTime)time;
+- (void)player:(SRGPlayer *)player willSeekToTime:(CMTime)time sequenceNumber:(NSUInteger)sequenceNumber;
 
 /**
  *  The player did finish seeking to the given time.
  *
  *  @discussion Not called if a seek has been interrupted.
  */
-- (void)player:(SRGPlayer *)player didSeekToTime:(CMTime)time;
+- (void)player:(SRGPlayer *)player didSeekToTime:(CMTime)time sequenceNumber:(NSUInteger)sequenceNumber;
 
 @end
 
@@ -40,7 +78,11 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, weak, nullable) id<SRGPlayerDelegate> delegate;
 
 /**
- *  The time at which the player started seeking, `kCMTimeIndefinite` if no seek is currently being made.
+ *  The time at which the player started seeking, `kCMTimeIndefinite` if no seek is currently being made. Seek
+ *  properties can be read from any thread.
+ *
+ *  @discussion Seek start and target times are reset when the seek completion is delivered to the delegate, so that
+ *              they are still available when `-player:didSeekToTime:sequenceNumber:` is called.
  */
 @property (nonatomic, readonly) CMTime seekStartTime;
 
@@ -49,6 +91,11 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, readonly) CMTime seekTargetTime;
 
+/**
+ *  The system uptime at which the most recent finished seek ended, 0 if none.
+ */
+@property (nonatomic, readonly) NSTimeInterval seekEndSystemUptime;
+
 /**
  *  Seek to a given time with the provided tolerances, calling the specified handler on completion. The delegate
  *  methods are called iff `notify` is set to `YES`.
@@ -59,6 +106,22 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)seekToTime:(CMTime)time toleranceBefore:(CMTime)toleranceBefore toleranceAfter:(CMTime)toleranceAfter notify:(BOOL)notify completionHandler:(void (^)(BOOL finished))completionHandler;
 
+/**
+ *  The number of seeks cancelled by a more recent seek (e.g. while scrubbing).
+ */
+@property (nonatomic, readonly) NSUInteger supersededSeekCount;
+
+/**
+ *  Statistics accumulated over all seeks made by the player so far. Can be read from any thread.
+ */
+@property (nonatomic, readonly) SRGPlayerSeekStatistics seekStatistics;
+
+/**
+ *  Copy the records of the most recent completed seeks (at most `SRGPlayerSeekRecordCapacity`), from the oldest to the
+ *  most recent one, into the provided array. Return the number of records copied. Can be called from any thread.
+ */
+- (NSUInteger)getSeekRecords:(SRGPlayerSeekRecord *)records maxCount:(NSUInteger)maxCount;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -6,28 +6,73 @@
 
 #import "SRGPlayer.h"
 
-@interface SRGPlayer ()
+#import "SRGMediaPlayerSpans+Private.h"
 
-@property (nonatomic) NSInteger seekCount;
+#import <os/lock.h>
 
-@property (nonatomic) CMTime seekStartTime;
-@property (nonatomic) CMTime seekTargetTime;
-
-@end
-
-@implementation SRGPlayer
+@implementation SRGPlayer {
+@private
+    // Seek state, updated from the threads seeks are requested and completed on
+    os_unfair_lock _seekStateLock;
+    NSInteger _seekCount;
+    CMTime _seekStartTime;
+    CMTime _seekTargetTime;
+    NSTimeInterval _seekEndSystemUptime;
+    
+    // Seek instrumentation, updated from the threads seeks are requested and completed on
+    os_unfair_lock _seekRecordsLock;
+    SRGPlayerSeekRecord _seekRecords[SRGPlayerSeekRecordCapacity];
+    NSUInteger _seekRecordHead;                                 // Index of the oldest record.
+    NSUInteger _seekRecordCount;
+    NSUInteger _seekRequestCount;
+    SRGPlayerSeekStatistics _seekStatistics;
+    
+    // Delegate deliveries enqueued on the main queue and not yet performed
+    os_unfair_lock _delegateDeliveryLock;
+    NSUInteger _pendingDelegateDeliveryCount;
+}
 
 #pragma mark Object lifecycle
 
 - (instancetype)init
 {
     if (self = [super init]) {
-        self.seekStartTime = kCMTimeIndefinite;
-        self.seekTargetTime = kCMTimeIndefinite;
+        _seekStateLock = OS_UNFAIR_LOCK_INIT;
+        _seekStartTime = kCMTimeIndefinite;
+        _seekTargetTime = kCMTimeIndefinite;
+        
+        _seekRecordsLock = OS_UNFAIR_LOCK_INIT;
+        _delegateDeliveryLock = OS_UNFAIR_LOCK_INIT;
     }
     return self;
 }
 
+#pragma mark Getters and setters
+
+- (CMTime)seekStartTime
+{
+    os_unfair_lock_lock(&_seekStateLock);
+    CMTime seekStartTime = _seekStartTime;
+    os_unfair_lock_unlock(&_seekStateLock);
+    return seekStartTime;
+}
+
+- (CMTime)seekTargetTime
+{
+    os_unfair_lock_lock(&_seekStateLock);
+    CMTime seekTargetTime = _seekTargetTime;
+    os_unfair_lock_unlock(&_seekStateLock);
+    return seekTargetTime;
+}
+
+- (NSTimeInterval)seekEndSystemUptime
+{
+    os_unfair_lock_lock(&_seekStateLock);
+    NSTimeInterval seekEndSystemUptime = _seekEndSystemUptime;
+    os_unfair_lock_unlock(&_seekStateLock);
+    return seekEndSystemUptime;
+}
+
 #pragma mark Playback
 
 // Might be called from a background thread, in which case the completion handler might as well
@@ -38,45 +83,168 @@
 
 - (void)seekToTime:(CMTime)time toleranceBefore:(CMTime)toleranceBefore toleranceAfter:(CMTime)toleranceAfter notify:(BOOL)notify completionHandler:(void (^)(BOOL))completionHandler
 {
-    if (self.seekCount == 0) {
-        self.seekStartTime = self.currentTime;
+    CMTime currentTime = self.currentTime;
+    
+    os_unfair_lock_lock(&_seekStateLock);
+    if (_seekCount == 0) {
+        _seekStartTime = currentTime;
     }
-    self.seekTargetTime = time;
+    _seekTargetTime = time;
+    _seekCount += 1;
+    os_unfair_lock_unlock(&_seekStateLock);
+    
+    NSUInteger seekRequestIndex = [self registerSeekRequest];
+    NSUInteger sequenceNumber = seekRequestIndex + 1;
     
     if (notify) {
-        if (NSThread.isMainThread) {
-            [self.delegate player:self willSeekToTime:time];
-        }
-        else {
-            dispatch_sync(dispatch_get_main_queue(), ^{
-                [self.delegate player:self willSeekToTime:time];
-            });
-        }
+        [self deliverToDelegate:^(id<SRGPlayerDelegate> delegate) {
+            [delegate player:self willSeekToTime:time sequenceNumber:sequenceNumber];
+        }];
     }
     
-    ++self.seekCount;
+    SRGPlayerSeekRecord seekRecord = { 0 };
+    seekRecord.requestSystemUptime = NSProcessInfo.processInfo.systemUptime;
+    seekRecord.distance = fabs(CMTimeGetSeconds(CMTimeSubtract(time, currentTime)));
+    seekRecord.toleranceBefore = CMTimeGetSeconds(toleranceBefore);
+    seekRecord.toleranceAfter = CMTimeGetSeconds(toleranceAfter);
+    
+    // Seek spans end when the seek finishes or is cancelled, and might therefore overlap
+    uint64_t spanIdentifier = SRGMediaPlayerSpanBegin("seek");
     
     [super seekToTime:time toleranceBefore:toleranceBefore toleranceAfter:toleranceAfter completionHandler:^(BOOL finished) {
-        --self.seekCount;
+        SRGMediaPlayerSpanEnd("seek", spanIdentifier);
+        
+        os_unfair_lock_lock(&self->_seekStateLock);
+        self->_seekCount -= 1;
+        os_unfair_lock_unlock(&self->_seekStateLock);
+        
+        SRGPlayerSeekRecord completedSeekRecord = seekRecord;
+        completedSeekRecord.completionSystemUptime = NSProcessInfo.processInfo.systemUptime;
+        completedSeekRecord.finished = finished;
+        [self addSeekRecord:completedSeekRecord forRequestIndex:seekRequestIndex];
         
         if (finished) {
-            if (notify) {
-                if (NSThread.isMainThread) {
-                    [self.delegate player:self didSeekToTime:time];
+            os_unfair_lock_lock(&self->_seekStateLock);
+            self->_seekEndSystemUptime = completedSeekRecord.completionSystemUptime;
+            os_unfair_lock_unlock(&self->_seekStateLock);
+            
+            // Seek times are reset when the completion is delivered, so that the delegate can still read them, whether
+            // the delivery is synchronous or not. They are kept if another seek has been requested in the meantime.
+            [self deliverToDelegate:^(id<SRGPlayerDelegate> delegate) {
+                if (notify) {
+                    [delegate player:self didSeekToTime:time sequenceNumber:sequenceNumber];
                 }
-                else {
-                    dispatch_sync(dispatch_get_main_queue(), ^{
-                        [self.delegate player:self didSeekToTime:time];
-                    });
+                
+                os_unfair_lock_lock(&self->_seekStateLock);
+                if (self->_seekCount == 0) {
+                    self->_seekStartTime = kCMTimeIndefinite;
+                    self->_seekTargetTime = kCMTimeIndefinite;
                 }
-            }
-            
-            self.seekStartTime = kCMTimeIndefinite;
-            self.seekTargetTime = kCMTimeIndefinite;
+                os_unfair_lock_unlock(&self->_seekStateLock);
+            }];
         }
         
         completionHandler(finished);
     }];
 }
 
+#pragma mark Delegate delivery
+
+// Deliver synchronously when on the main thread with nothing enqueued, otherwise enqueue on the main queue (FIFO) so
+// that ordering is preserved without ever blocking the calling thread. Deliveries are enqueued while holding the lock,
+// so that they are enqueued in the order they were counted.
+- (void)deliverToDelegate:(void (^)(id<SRGPlayerDelegate> delegate))delivery
+{
+    os_unfair_lock_lock(&_delegateDeliveryLock);
+    BOOL immediate = NSThread.isMainThread && _pendingDelegateDeliveryCount == 0;
+    if (! immediate) {
+        _pendingDelegateDeliveryCount += 1;
+        dispatch_async(dispatch_get_main_queue(), ^{
+            // Decrement first so that seeks requested by the delegate itself are delivered immediately
+            os_unfair_lock_lock(&self->_delegateDeliveryLock);
+            self->_pendingDelegateDeliveryCount -= 1;
+            os_unfair_lock_unlock(&self->_delegateDeliveryLock);
+            
+            delivery(self.delegate);
+        });
+    }
+    os_unfair_lock_unlock(&_delegateDeliveryLock);
+    
+    if (immediate) {
+        delivery(self.delegate);
+    }
+}
+
+#pragma mark Seek instrumentation
+
+- (NSUInteger)registerSeekRequest
+{
+    os_unfair_lock_lock(&_seekRecordsLock);
+    NSUInteger seekRequestIndex = _seekRequestCount++;
+    os_unfair_lock_unlock(&_seekRecordsLock);
+    return seekRequestIndex;
+}
+
+- (void)addSeekRecord:(SRGPlayerSeekRecord)seekRecord forRequestIndex:(NSUInteger)requestIndex
+{
+    os_unfair_lock_lock(&_seekRecordsLock);
+    
+    // Seeks are cancelled when a new one is requested, but also when the item is replaced
+    seekRecord.superseded = ! seekRecord.finished && requestIndex + 1 < _seekRequestCount;
+    
+    NSUInteger index = (_seekRecordHead + _seekRecordCount) % SRGPlayerSeekRecordCapacity;
+    _seekRecords[index] = seekRecord;
+    if (_seekRecordCount < SRGPlayerSeekRecordCapacity) {
+        _seekRecordCount += 1;
+    }
+    else {
+        _seekRecordHead = (_seekRecordHead + 1) % SRGPlayerSeekRecordCapacity;
+    }
+    
+    NSTimeInterval duration = seekRecord.completionSystemUptime - seekRecord.requestSystemUptime;
+    if (! seekRecord.finished) {
+        SRGPlaybackHistogramRecord(&_seekStatistics.cancelledDurationHistogram, duration);
+    }
+    else if (seekRecord.toleranceBefore == 0. && seekRecord.toleranceAfter == 0.) {
+        SRGPlaybackHistogramRecord(&_seekStatistics.exactLatencyHistogram, duration);
+    }
+    else {
+        SRGPlaybackHistogramRecord(&_seekStatistics.tolerantLatencyHistogram, duration);
+    }
+    SRGPlaybackHistogramRecord(&_seekStatistics.distanceHistogram, seekRecord.distance);
+    if (seekRecord.superseded) {
+        _seekStatistics.supersededCount += 1;
+    }
+    
+    os_unfair_lock_unlock(&_seekRecordsLock);
+}
+
+- (NSUInteger)supersededSeekCount
+{
+    return self.seekStatistics.supersededCount;
+}
+
+- (SRGPlayerSeekStatistics)seekStatistics
+{
+    os_unfair_lock_lock(&_seekRecordsLock);
+    SRGPlayerSeekStatistics seekStatistics = _seekStatistics;
+    os_unfair_lock_unlock(&_seekRecordsLock);
+    return seekStatistics;
+}
+
+- (NSUInteger)getSeekRecords:(SRGPlayerSeekRecord *)records maxCount:(NSUInteger)maxCount
+{
+    os_unfair_lock_lock(&_seekRecordsLock);
+    
+    // Copy the most recent records if not all of them fit
+    NSUInteger count = MIN(_seekRecordCount, maxCount);
+    NSUInteger start = _seekRecordHead + _seekRecordCount - count;
+    for (NSUInteger i = 0; i < count; ++i) {
+        records[i] = _seekRecords[(start + i) % SRGPlayerSeekRecordCapacity];
+    }
+    
+    os_unfair_lock_unlock(&_seekRecordsLock);
+    return count;
+}
+
 @end
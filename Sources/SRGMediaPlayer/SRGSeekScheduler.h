@@ -0,0 +1,58 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A seek, which must call the provided completion handler exactly once when done.
+ */
+typedef void (^SRGSeekSchedulerSeek)(void (^completionHandler)(BOOL finished));
+
+/**
+ *  Coalesces seek requests so that at most one seek is in flight and one is pending. Seeks requested while a seek is
+ *  in flight replace the pending one, if any, whose completion handler is called with `finished` set to `NO`. The
+ *  pending seek is performed when the seek in flight finishes; if the seek in flight is cancelled (e.g. by a seek
+ *  made outside the scheduler), the pending seek is dropped as well.
+ *
+ *  Completion handlers of dropped seeks are called once the scheduler state has been updated, so that they can
+ *  schedule seeks themselves.
+ *
+ *  Schedulers must be used from the main thread. Completion handlers are always called on the main thread.
+ */
+@interface SRGSeekScheduler : NSObject
+
+/**
+ *  Schedule a seek, performed immediately if no seek is in flight.
+ */
+- (void)scheduleSeek:(SRGSeekSchedulerSeek)seek withCompletionHandler:(nullable void (^)(BOOL finished))completionHandler;
+
+/**
+ *  Perform a seek immediately, superseding the seek in flight, if any, and dropping the pending one. The completion
+ *  handler of the superseded seek is still called when it completes, without affecting the scheduler.
+ */
+- (void)performSeekImmediately:(SRGSeekSchedulerSeek)seek withCompletionHandler:(nullable void (^)(BOOL finished))completionHandler;
+
+/**
+ *  Drop the pending seek, if any, whose completion handler is called with `finished` set to `NO`, and stop waiting
+ *  for the seek in flight. The completion handler of the seek in flight is still called when it completes.
+ */
+- (void)reset;
+
+/**
+ *  Whether a seek is in flight.
+ */
+@property (nonatomic, readonly, getter=isSeekInFlight) BOOL seekInFlight;
+
+/**
+ *  Whether a seek is pending, waiting for the seek in flight to complete.
+ */
+@property (nonatomic, readonly) BOOL hasPendingSeek;
+
+@end
+
+NS_ASSUME_NONNULL_END
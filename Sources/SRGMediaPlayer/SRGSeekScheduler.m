@@ -0,0 +1,130 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSeekScheduler.h"
+
+@import libextobjc;
+
+@interface SRGSeekScheduler ()
+
+@property (nonatomic, getter=isSeekInFlight) BOOL seekInFlight;
+@property (nonatomic) NSUInteger generation;
+
+@property (nonatomic, copy) SRGSeekSchedulerSeek pendingSeek;
+@property (nonatomic, copy) void (^pendingCompletionHandler)(BOOL finished);
+
+@end
+
+@implementation SRGSeekScheduler
+
+#pragma mark Getters and setters
+
+- (BOOL)hasPendingSeek
+{
+    return self.pendingSeek != nil;
+}
+
+#pragma mark Scheduling
+
+- (void)scheduleSeek:(SRGSeekSchedulerSeek)seek withCompletionHandler:(void (^)(BOOL))completionHandler
+{
+    NSAssert(NSThread.isMainThread, @"Must be called from the main thread");
+    
+    if (self.seekInFlight) {
+        void (^droppedCompletionHandler)(BOOL) = [self removePendingSeek];
+        
+        self.pendingSeek = seek;
+        self.pendingCompletionHandler = completionHandler;
+        
+        droppedCompletionHandler ? droppedCompletionHandler(NO) : nil;
+    }
+    else {
+        [self startSeek:seek withCompletionHandler:completionHandler];
+    }
+}
+
+- (void)performSeekImmediately:(SRGSeekSchedulerSeek)seek withCompletionHandler:(void (^)(BOOL))completionHandler
+{
+    NSAssert(NSThread.isMainThread, @"Must be called from the main thread");
+    
+    void (^droppedCompletionHandler)(BOOL) = [self removePendingSeek];
+    
+    // The superseded seek must not affect the scheduler when it completes
+    self.generation += 1;
+    [self startSeek:seek withCompletionHandler:completionHandler];
+    
+    droppedCompletionHandler ? droppedCompletionHandler(NO) : nil;
+}
+
+- (void)reset
+{
+    void (^droppedCompletionHandler)(BOOL) = [self removePendingSeek];
+    
+    self.seekInFlight = NO;
+    self.generation += 1;
+    
+    droppedCompletionHandler ? droppedCompletionHandler(NO) : nil;
+}
+
+- (void)startSeek:(SRGSeekSchedulerSeek)seek withCompletionHandler:(void (^)(BOOL))completionHandler
+{
+    self.seekInFlight = YES;
+    
+    NSUInteger generation = self.generation;
+    
+    @weakify(self)
+    seek(^(BOOL finished) {
+        void (^completionBlock)(void) = ^{
+            @strongify(self)
+            if (generation == self.generation) {
+                [self seekDidComplete:finished];
+            }
+            completionHandler ? completionHandler(finished) : nil;
+        };
+        
+        if (NSThread.isMainThread) {
+            completionBlock();
+        }
+        else {
+            dispatch_async(dispatch_get_main_queue(), completionBlock);
+        }
+    });
+}
+
+// The pending seek is started before the completion handler of the seek in flight is called, so that seeks requested
+// from this handler are properly coalesced
+- (void)seekDidComplete:(BOOL)finished
+{
+    self.seekInFlight = NO;
+    
+    if (! self.pendingSeek) {
+        return;
+    }
+    
+    if (finished) {
+        SRGSeekSchedulerSeek pendingSeek = self.pendingSeek;
+        void (^pendingCompletionHandler)(BOOL) = [self removePendingSeek];
+        [self startSeek:pendingSeek withCompletionHandler:pendingCompletionHandler];
+    }
+    else {
+        void (^droppedCompletionHandler)(BOOL) = [self removePendingSeek];
+        droppedCompletionHandler ? droppedCompletionHandler(NO) : nil;
+    }
+}
+
+// Remove the pending seek and return its completion handler, which must be called by the caller once the scheduler
+// state is consistent, as it might schedule seeks itself
+- (void (^)(BOOL))removePendingSeek
+{
+    void (^pendingCompletionHandler)(BOOL) = self.pendingCompletionHandler;
+    
+    self.pendingSeek = nil;
+    self.pendingCompletionHandler = nil;
+    
+    return pendingCompletionHandler;
+}
+
+@end
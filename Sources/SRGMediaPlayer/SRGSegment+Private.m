@@ -6,8 +6,10 @@
 
 #import "SRGSegment+Private.h"
 
+#import "SRGMarkRange+Private.h"
+
 BOOL SRGMediaPlayerAreEqualSegments(id<SRGSegment> segment1, id<SRGSegment> segment2)
 {
-    return [segment1.srg_markRange isEqual:segment2.srg_markRange]
-        && segment1.srg_blocked == segment2.srg_blocked && segment1.srg_hidden == segment2.srg_hidden;        
+    return SRGMarkRangeValueEqual(segment1.srg_markRange.value, segment2.srg_markRange.value)
+        && segment1.srg_blocked == segment2.srg_blocked && segment1.srg_hidden == segment2.srg_hidden;
 }
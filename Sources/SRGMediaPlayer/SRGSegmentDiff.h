@@ -0,0 +1,71 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSegment.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Describes the changes between two segment lists.
+ *
+ *  Segments are matched by mark range, which provides their identity across updates (segment objects are usually
+ *  recreated when a list is refreshed). A matched segment is considered updated if it is a different object or if its
+ *  blocking or visibility status changed, and moved if its relative order in the list changed. Moves are kept to a minimum, so that the diff can be
+ *  applied to a collection view as a batch update.
+ */
+@interface SRGSegmentDiff : NSObject
+
+/**
+ *  Calculate the changes between the two specified lists.
+ */
+- (instancetype)initWithPreviousSegments:(NSArray<id<SRGSegment>> *)previousSegments segments:(NSArray<id<SRGSegment>> *)segments NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Indexes of inserted segments, in the new list.
+ */
+@property (nonatomic, readonly) NSIndexSet *insertedIndexes;
+
+/**
+ *  Indexes of removed segments, in the previous list.
+ */
+@property (nonatomic, readonly) NSIndexSet *removedIndexes;
+
+/**
+ *  Indexes of updated segments, in the new list.
+ */
+@property (nonatomic, readonly) NSIndexSet *updatedIndexes;
+
+/**
+ *  Moved segments, as a dictionary mapping indexes in the previous list to indexes in the new list.
+ */
+@property (nonatomic, readonly) NSDictionary<NSNumber *, NSNumber *> *movedIndexes;
+
+/**
+ *  Return `YES` iff the lists differ.
+ */
+@property (nonatomic, readonly) BOOL hasChanges;
+
+/**
+ *  Notification user information describing the changes.
+ */
+@property (nonatomic, readonly) NSDictionary<NSString *, id> *userInfo;
+
+/**
+ *  Return the segment from the new list equal to the specified one (@see `SRGMediaPlayerAreEqualSegments`), if any.
+ */
+- (nullable id<SRGSegment>)segmentEqualToSegment:(id<SRGSegment>)segment;
+
+@end
+
+@interface SRGSegmentDiff (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,203 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSegmentDiff.h"
+
+#import "SRGMediaPlayerConstants.h"
+#import "SRGSegment+Private.h"
+
+static NSIndexSet *SRGSegmentDiffStableIndexes(const NSUInteger *indexes, NSUInteger count);
+
+@interface SRGSegmentDiff ()
+
+@property (nonatomic) NSIndexSet *insertedIndexes;
+@property (nonatomic) NSIndexSet *removedIndexes;
+@property (nonatomic) NSIndexSet *updatedIndexes;
+@property (nonatomic) NSDictionary<NSNumber *, NSNumber *> *movedIndexes;
+
+@property (nonatomic) NSDictionary<SRGMarkRange *, NSArray<id<SRGSegment>> *> *segmentsByMarkRange;
+
+@end
+
+@implementation SRGSegmentDiff
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithPreviousSegments:(NSArray<id<SRGSegment>> *)previousSegments segments:(NSArray<id<SRGSegment>> *)segments
+{
+    if (self = [super init]) {
+        [self calculateWithPreviousSegments:previousSegments segments:segments];
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    return [self initWithPreviousSegments:@[] segments:@[]];
+}
+
+#pragma clang diagnostic pop
+
+#pragma mark Getters and setters
+
+- (BOOL)hasChanges
+{
+    return self.insertedIndexes.count != 0 || self.removedIndexes.count != 0 || self.updatedIndexes.count != 0 || self.movedIndexes.count != 0;
+}
+
+- (NSDictionary<NSString *, id> *)userInfo
+{
+    return @{ SRGMediaPlayerInsertedIndexesKey : self.insertedIndexes,
+              SRGMediaPlayerRemovedIndexesKey : self.removedIndexes,
+              SRGMediaPlayerUpdatedIndexesKey : self.updatedIndexes,
+              SRGMediaPlayerMovedIndexesKey : self.movedIndexes };
+}
+
+#pragma mark Calculation
+
+- (void)calculateWithPreviousSegments:(NSArray<id<SRGSegment>> *)previousSegments segments:(NSArray<id<SRGSegment>> *)segments
+{
+    // Group new segments by mark range, keeping list order within each group
+    NSMutableDictionary<SRGMarkRange *, NSMutableArray<NSNumber *> *> *indexesByMarkRange = [NSMutableDictionary dictionaryWithCapacity:segments.count];
+    NSMutableDictionary<SRGMarkRange *, NSMutableArray<id<SRGSegment>> *> *segmentsByMarkRange = [NSMutableDictionary dictionaryWithCapacity:segments.count];
+    [segments enumerateObjectsUsingBlock:^(id<SRGSegment> _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
+        SRGMarkRange *markRange = segment.srg_markRange;
+        NSMutableArray<NSNumber *> *indexes = indexesByMarkRange[markRange];
+        if (! indexes) {
+            indexes = [NSMutableArray array];
+            indexesByMarkRange[markRange] = indexes;
+            segmentsByMarkRange[markRange] = [NSMutableArray array];
+        }
+        [indexes addObject:@(idx)];
+        [segmentsByMarkRange[markRange] addObject:segment];
+    }];
+    self.segmentsByMarkRange = segmentsByMarkRange.copy;
+    
+    // Match previous segments in order, each new segment being matched at most once
+    NSUInteger previousCount = previousSegments.count;
+    NSUInteger *matchedPreviousIndexes = malloc(previousCount * sizeof(NSUInteger));
+    NSUInteger *matchedIndexes = malloc(previousCount * sizeof(NSUInteger));
+    NSUInteger matchCount = 0;
+    
+    NSMutableIndexSet *removedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableIndexSet *insertedIndexes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, segments.count)];
+    NSMutableIndexSet *updatedIndexes = [NSMutableIndexSet indexSet];
+    
+    for (NSUInteger i = 0; i < previousCount; ++i) {
+        id<SRGSegment> previousSegment = previousSegments[i];
+        NSMutableArray<NSNumber *> *indexes = indexesByMarkRange[previousSegment.srg_markRange];
+        if (indexes.count == 0) {
+            [removedIndexes addIndex:i];
+            continue;
+        }
+        
+        NSUInteger index = indexes.firstObject.unsignedIntegerValue;
+        [indexes removeObjectAtIndex:0];
+        [insertedIndexes removeIndex:index];
+        
+        // Recreated segments might carry other metadata (e.g. a title), and observers must receive the new objects
+        id<SRGSegment> segment = segments[index];
+        if (previousSegment != segment || ! SRGMediaPlayerAreEqualSegments(previousSegment, segment)) {
+            [updatedIndexes addIndex:index];
+        }
+        
+        matchedPreviousIndexes[matchCount] = i;
+        matchedIndexes[matchCount] = index;
+        ++matchCount;
+    }
+    
+    // Matched segments not belonging to the longest subsequence preserving their relative order must be moved
+    NSIndexSet *stableIndexes = SRGSegmentDiffStableIndexes(matchedIndexes, matchCount);
+    NSMutableDictionary<NSNumber *, NSNumber *> *movedIndexes = [NSMutableDictionary dictionary];
+    for (NSUInteger i = 0; i < matchCount; ++i) {
+        if (! [stableIndexes containsIndex:i]) {
+            movedIndexes[@(matchedPreviousIndexes[i])] = @(matchedIndexes[i]);
+        }
+    }
+    
+    free(matchedPreviousIndexes);
+    free(matchedIndexes);
+    
+    self.insertedIndexes = insertedIndexes.copy;
+    self.removedIndexes = removedIndexes.copy;
+    self.updatedIndexes = updatedIndexes.copy;
+    self.movedIndexes = movedIndexes.copy;
+}
+
+#pragma mark Lookup
+
+- (id<SRGSegment>)segmentEqualToSegment:(id<SRGSegment>)segment
+{
+    for (id<SRGSegment> candidateSegment in self.segmentsByMarkRange[segment.srg_markRange]) {
+        if (SRGMediaPlayerAreEqualSegments(candidateSegment, segment)) {
+            return candidateSegment;
+        }
+    }
+    return nil;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; insertedIndexes = %@; removedIndexes = %@; updatedIndexes = %@; movedIndexes = %@>",
+            self.class,
+            self,
+            self.insertedIndexes,
+            self.removedIndexes,
+            self.updatedIndexes,
+            self.movedIndexes];
+}
+
+@end
+
+#pragma mark Functions
+
+// Return the positions (in the provided array) of the elements belonging to a longest increasing subsequence.
+static NSIndexSet *SRGSegmentDiffStableIndexes(const NSUInteger *indexes, NSUInteger count)
+{
+    if (count == 0) {
+        return [NSIndexSet indexSet];
+    }
+    
+    // Patience sorting: `tails[k]` is the position of the smallest tail of an increasing subsequence of length k + 1
+    NSUInteger *tails = malloc(count * sizeof(NSUInteger));
+    NSUInteger *predecessors = malloc(count * sizeof(NSUInteger));
+    NSUInteger length = 0;
+    
+    for (NSUInteger i = 0; i < count; ++i) {
+        NSUInteger lowerBound = 0;
+        NSUInteger upperBound = length;
+        while (lowerBound < upperBound) {
+            NSUInteger middle = lowerBound + (upperBound - lowerBound) / 2;
+            if (indexes[tails[middle]] < indexes[i]) {
+                lowerBound = middle + 1;
+            }
+            else {
+                upperBound = middle;
+            }
+        }
+        
+        predecessors[i] = (lowerBound != 0) ? tails[lowerBound - 1] : NSNotFound;
+        tails[lowerBound] = i;
+        if (lowerBound == length) {
+            ++length;
+        }
+    }
+    
+    NSMutableIndexSet *stableIndexes = [NSMutableIndexSet indexSet];
+    for (NSUInteger i = tails[length - 1]; i != NSNotFound; i = predecessors[i]) {
+        [stableIndexes addIndex:i];
+    }
+    
+    free(tails);
+    free(predecessors);
+    
+    return stableIndexes.copy;
+}
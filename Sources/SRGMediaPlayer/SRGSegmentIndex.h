@@ -0,0 +1,106 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSegment.h"
+
+@import CoreMedia;
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Immutable index over a segment list, resolving a time to the segment it belongs to in logarithmic time.
+ *
+ *  Segment time ranges are flattened into a sorted list of elementary intervals, each associated with the first segment
+ *  (in list order) covering it. Lookups therefore return the same segment as a linear scan of the list stopping at the
+ *  first match would, even if segments overlap.
+ *
+ *  Indexes can be nested to describe segment hierarchies. A child index covers all child segments of the indexed
+ *  segments (@see `-[SRGSegment srg_childSegments]`), flattened into a single list.
+ */
+@interface SRGSegmentIndex : NSObject
+
+/**
+ *  Create an index for the specified segments, whose time ranges (in the stream reference frame) are provided in
+ *  the same order. Empty or invalid time ranges never match any time.
+ */
+- (instancetype)initWithSegments:(NSArray<id<SRGSegment>> *)segments timeRanges:(NSArray<NSValue *> *)timeRanges;
+
+/**
+ *  Same as `-initWithSegments:timeRanges:`, with an optional index for the child segments of the indexed segments.
+ */
+- (instancetype)initWithSegments:(NSArray<id<SRGSegment>> *)segments
+                      timeRanges:(NSArray<NSValue *> *)timeRanges
+               childSegmentIndex:(nullable SRGSegmentIndex *)childSegmentIndex NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The indexed segments.
+ */
+@property (nonatomic, readonly) NSArray<id<SRGSegment>> *segments;
+
+/**
+ *  The index of child segments, if any.
+ */
+@property (nonatomic, readonly, nullable) SRGSegmentIndex *childSegmentIndex;
+
+/**
+ *  `YES` iff at least one indexed segment (children included) is delimited by a date mark, i.e. if its resolved time
+ *  range depends on the stream reference date.
+ */
+@property (nonatomic, readonly, getter=isDateDependent) BOOL dateDependent;
+
+/**
+ *  Times at which the segment chain returned by `-segmentChainForTime:` might change, in increasing order.
+ */
+@property (nonatomic, readonly) NSArray<NSValue *> *boundaryTimes;
+
+/**
+ *  Return the first boundary time strictly after the specified time, `kCMTimeInvalid` if none.
+ */
+- (CMTime)boundaryTimeAfterTime:(CMTime)time;
+
+/**
+ *  Return the segment containing the specified time, `nil` if none.
+ */
+- (nullable id<SRGSegment>)segmentForTime:(CMTime)time;
+
+/**
+ *  Return the segment containing the specified time, followed by its child segment containing the time, and so on. The
+ *  list is empty if no segment contains the specified time.
+ */
+- (NSArray<id<SRGSegment>> *)segmentChainForTime:(CMTime)time;
+
+/**
+ *  Return the parent of the specified child segment (compared by identity), `nil` if none.
+ */
+- (nullable id<SRGSegment>)parentSegmentForSegment:(id<SRGSegment>)segment;
+
+/**
+ *  Return the time range of the blocked run containing the specified time, `kCMTimeRangeInvalid` if none. A blocked run
+ *  is a maximal time range within which every time resolves to a blocked segment (@see `-segmentForTime:`).
+ */
+- (CMTimeRange)blockedTimeRangeForTime:(CMTime)time;
+
+/**
+ *  Return the segments making up the blocked runs entirely contained within the specified time range, in time order.
+ */
+- (NSArray<id<SRGSegment>> *)blockedSegmentsInTimeRange:(CMTimeRange)timeRange;
+
+/**
+ *  Return the resolved time range of the specified segment or child segment (compared by identity), `kCMTimeRangeInvalid`
+ *  if the segment is not indexed.
+ */
+- (CMTimeRange)timeRangeForSegment:(id<SRGSegment>)segment;
+
+@end
+
+@interface SRGSegmentIndex (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,396 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSegmentIndex.h"
+
+#import "CMTimeRange+SRGMediaPlayer.h"
+#import "SRGMarkRange+Private.h"
+
+typedef struct {
+    CMTime time;
+    NSUInteger index;
+    BOOL start;
+} SRGSegmentIndexEvent;
+
+static int SRGSegmentIndexEventCompare(const void *event1, const void *event2);
+
+@interface SRGSegmentIndex () {
+@private
+    CMTime *_boundaryTimes;
+    NSUInteger *_boundaryIndexes;
+    NSUInteger _boundaryCount;
+    
+    CMTimeRange *_blockedTimeRanges;
+    NSUInteger _blockedTimeRangeCount;
+}
+
+@property (nonatomic) NSArray<id<SRGSegment>> *segments;
+@property (nonatomic) SRGSegmentIndex *childSegmentIndex;
+@property (nonatomic) NSArray<NSValue *> *timeRanges;
+@property (nonatomic) NSMapTable<id<SRGSegment>, NSNumber *> *segmentIndexes;
+@property (nonatomic) NSMapTable<id<SRGSegment>, id<SRGSegment>> *parentSegments;
+@property (nonatomic, getter=isDateDependent) BOOL dateDependent;
+
+@property (nonatomic) NSArray<NSArray<id<SRGSegment>> *> *blockedSegmentRuns;
+
+@end
+
+@implementation SRGSegmentIndex
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithSegments:(NSArray<id<SRGSegment>> *)segments
+                      timeRanges:(NSArray<NSValue *> *)timeRanges
+               childSegmentIndex:(SRGSegmentIndex *)childSegmentIndex
+{
+    NSParameterAssert(segments.count == timeRanges.count);
+    
+    if (self = [super init]) {
+        self.segments = segments;
+        self.childSegmentIndex = childSegmentIndex;
+        self.timeRanges = timeRanges;
+        
+        self.parentSegments = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality | NSPointerFunctionsStrongMemory
+                                                    valueOptions:NSPointerFunctionsObjectPointerPersonality | NSPointerFunctionsStrongMemory];
+        if (childSegmentIndex) {
+            for (id<SRGSegment> segment in segments) {
+                if (! [segment respondsToSelector:@selector(srg_childSegments)]) {
+                    continue;
+                }
+                
+                for (id<SRGSegment> childSegment in segment.srg_childSegments) {
+                    if (! [self.parentSegments objectForKey:childSegment]) {
+                        [self.parentSegments setObject:segment forKey:childSegment];
+                    }
+                }
+            }
+            
+            if (childSegmentIndex.dateDependent) {
+                self.dateDependent = YES;
+            }
+        }
+        
+        // Segments are looked up by identity. If a segment appears several times, its first occurrence wins.
+        self.segmentIndexes = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsObjectPointerPersonality | NSPointerFunctionsStrongMemory
+                                                    valueOptions:NSPointerFunctionsStrongMemory];
+        [segments enumerateObjectsUsingBlock:^(id<SRGSegment> _Nonnull segment, NSUInteger idx, BOOL * _Nonnull stop) {
+            if (! [self.segmentIndexes objectForKey:segment]) {
+                [self.segmentIndexes setObject:@(idx) forKey:segment];
+            }
+            
+            if (SRGMarkRangeValueHasDate(segment.srg_markRange.value)) {
+                self.dateDependent = YES;
+            }
+        }];
+        
+        [self buildWithTimeRanges:timeRanges];
+        [self buildBlockedRuns];
+    }
+    return self;
+}
+
+- (instancetype)initWithSegments:(NSArray<id<SRGSegment>> *)segments timeRanges:(NSArray<NSValue *> *)timeRanges
+{
+    return [self initWithSegments:segments timeRanges:timeRanges childSegmentIndex:nil];
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    return [self initWithSegments:@[] timeRanges:@[]];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    free(_boundaryTimes);
+    free(_boundaryIndexes);
+    free(_blockedTimeRanges);
+}
+
+#pragma mark Index construction
+
+// Sweep over segment start and end times, keeping track of the segments covering each elementary interval. The
+// winning segment of an interval is the one with the lowest index, which matches "first match wins" linear lookup.
+- (void)buildWithTimeRanges:(NSArray<NSValue *> *)timeRanges
+{
+    NSUInteger count = timeRanges.count;
+    if (count == 0) {
+        return;
+    }
+    
+    SRGSegmentIndexEvent *events = malloc(2 * count * sizeof(SRGSegmentIndexEvent));
+    NSUInteger eventCount = 0;
+    
+    for (NSUInteger i = 0; i < count; ++i) {
+        CMTimeRange timeRange = timeRanges[i].CMTimeRangeValue;
+        if (! SRG_CMTIMERANGE_IS_NOT_EMPTY(timeRange) || CMTIME_COMPARE_INLINE(timeRange.duration, <, kCMTimeZero)) {
+            continue;
+        }
+        
+        events[eventCount++] = (SRGSegmentIndexEvent){ timeRange.start, i, YES };
+        events[eventCount++] = (SRGSegmentIndexEvent){ CMTimeRangeGetEnd(timeRange), i, NO };
+    }
+    
+    qsort(events, eventCount, sizeof(SRGSegmentIndexEvent), SRGSegmentIndexEventCompare);
+    
+    _boundaryTimes = malloc(eventCount * sizeof(CMTime));
+    _boundaryIndexes = malloc(eventCount * sizeof(NSUInteger));
+    
+    NSMutableIndexSet *activeIndexes = [NSMutableIndexSet indexSet];
+    NSUInteger i = 0;
+    while (i < eventCount) {
+        CMTime time = events[i].time;
+        
+        // Apply all events occurring at the same time before determining the winner
+        while (i < eventCount && CMTIME_COMPARE_INLINE(events[i].time, ==, time)) {
+            if (events[i].start) {
+                [activeIndexes addIndex:events[i].index];
+            }
+            else {
+                [activeIndexes removeIndex:events[i].index];
+            }
+            ++i;
+        }
+        
+        // Merge adjacent intervals associated with the same segment
+        NSUInteger index = activeIndexes.firstIndex;
+        if (_boundaryCount != 0 && _boundaryIndexes[_boundaryCount - 1] == index) {
+            continue;
+        }
+        
+        _boundaryTimes[_boundaryCount] = time;
+        _boundaryIndexes[_boundaryCount] = index;
+        ++_boundaryCount;
+    }
+    
+    free(events);
+}
+
+// Merge consecutive elementary intervals resolving to blocked segments, so that a blocked run can be skipped at once.
+- (void)buildBlockedRuns
+{
+    NSMutableArray<NSArray<id<SRGSegment>> *> *blockedSegmentRuns = [NSMutableArray array];
+    
+    _blockedTimeRanges = malloc(MAX(_boundaryCount, 1) * sizeof(CMTimeRange));
+    
+    NSMutableArray<id<SRGSegment>> *runSegments = nil;
+    for (NSUInteger i = 0; i < _boundaryCount; ++i) {
+        NSUInteger index = _boundaryIndexes[i];
+        id<SRGSegment> segment = (index != NSNotFound) ? self.segments[index] : nil;
+        
+        if (segment.srg_blocked) {
+            if (! runSegments) {
+                runSegments = [NSMutableArray array];
+                _blockedTimeRanges[_blockedTimeRangeCount] = CMTimeRangeMake(_boundaryTimes[i], kCMTimeZero);
+            }
+            if (! [runSegments containsObject:segment]) {
+                [runSegments addObject:segment];
+            }
+        }
+        else if (runSegments) {
+            CMTime startTime = _blockedTimeRanges[_blockedTimeRangeCount].start;
+            _blockedTimeRanges[_blockedTimeRangeCount] = CMTimeRangeFromTimeToTime(startTime, _boundaryTimes[i]);
+            ++_blockedTimeRangeCount;
+            
+            [blockedSegmentRuns addObject:runSegments.copy];
+            runSegments = nil;
+        }
+    }
+    
+    self.blockedSegmentRuns = blockedSegmentRuns.copy;
+}
+
+#pragma mark Getters and setters
+
+- (NSArray<NSValue *> *)boundaryTimes
+{
+    NSArray<NSValue *> *childBoundaryTimes = self.childSegmentIndex.boundaryTimes ?: @[];
+    
+    // Merge both sorted lists, removing duplicates
+    NSMutableArray<NSValue *> *boundaryTimes = [NSMutableArray arrayWithCapacity:_boundaryCount + childBoundaryTimes.count];
+    NSUInteger i = 0, j = 0;
+    while (i < _boundaryCount || j < childBoundaryTimes.count) {
+        CMTime time = kCMTimeInvalid;
+        if (j == childBoundaryTimes.count || (i < _boundaryCount && CMTIME_COMPARE_INLINE(_boundaryTimes[i], <=, childBoundaryTimes[j].CMTimeValue))) {
+            time = _boundaryTimes[i++];
+        }
+        else {
+            time = childBoundaryTimes[j++].CMTimeValue;
+        }
+        
+        if (boundaryTimes.count == 0 || CMTIME_COMPARE_INLINE(boundaryTimes.lastObject.CMTimeValue, !=, time)) {
+            [boundaryTimes addObject:[NSValue valueWithCMTime:time]];
+        }
+    }
+    return boundaryTimes.copy;
+}
+
+#pragma mark Lookup
+
+// Return the number of boundaries located before or at the specified time
+- (NSUInteger)boundaryCountUpToTime:(CMTime)time
+{
+    NSUInteger lowerBound = 0;
+    NSUInteger upperBound = _boundaryCount;
+    while (lowerBound < upperBound) {
+        NSUInteger middle = lowerBound + (upperBound - lowerBound) / 2;
+        if (CMTIME_COMPARE_INLINE(_boundaryTimes[middle], <=, time)) {
+            lowerBound = middle + 1;
+        }
+        else {
+            upperBound = middle;
+        }
+    }
+    return lowerBound;
+}
+
+- (CMTime)boundaryTimeAfterTime:(CMTime)time
+{
+    if (CMTIME_IS_INVALID(time)) {
+        return kCMTimeInvalid;
+    }
+    
+    NSUInteger count = [self boundaryCountUpToTime:time];
+    CMTime boundaryTime = (count < _boundaryCount) ? _boundaryTimes[count] : kCMTimeInvalid;
+    
+    CMTime childBoundaryTime = self.childSegmentIndex ? [self.childSegmentIndex boundaryTimeAfterTime:time] : kCMTimeInvalid;
+    if (CMTIME_IS_INVALID(boundaryTime)) {
+        return childBoundaryTime;
+    }
+    else if (CMTIME_IS_INVALID(childBoundaryTime)) {
+        return boundaryTime;
+    }
+    else {
+        return CMTimeMinimum(boundaryTime, childBoundaryTime);
+    }
+}
+
+- (id<SRGSegment>)segmentForTime:(CMTime)time
+{
+    if (CMTIME_IS_INVALID(time) || _boundaryCount == 0) {
+        return nil;
+    }
+    
+    NSUInteger count = [self boundaryCountUpToTime:time];
+    if (count == 0) {
+        return nil;
+    }
+    
+    NSUInteger index = _boundaryIndexes[count - 1];
+    return (index != NSNotFound) ? self.segments[index] : nil;
+}
+
+// A single lookup per level. Child segments are only retained if they belong to the segment found at the level above.
+- (NSArray<id<SRGSegment>> *)segmentChainForTime:(CMTime)time
+{
+    id<SRGSegment> segment = [self segmentForTime:time];
+    if (! segment) {
+        return @[];
+    }
+    
+    NSMutableArray<id<SRGSegment>> *segmentChain = [NSMutableArray arrayWithObject:segment];
+    
+    SRGSegmentIndex *segmentIndex = self;
+    while (segmentIndex.childSegmentIndex) {
+        id<SRGSegment> childSegment = [segmentIndex.childSegmentIndex segmentForTime:time];
+        if (! childSegment || [segmentIndex.parentSegments objectForKey:childSegment] != segment) {
+            break;
+        }
+        
+        [segmentChain addObject:childSegment];
+        
+        segment = childSegment;
+        segmentIndex = segmentIndex.childSegmentIndex;
+    }
+    
+    return segmentChain.copy;
+}
+
+- (id<SRGSegment>)parentSegmentForSegment:(id<SRGSegment>)segment
+{
+    return [self.parentSegments objectForKey:segment] ?: [self.childSegmentIndex parentSegmentForSegment:segment];
+}
+
+- (CMTimeRange)blockedTimeRangeForTime:(CMTime)time
+{
+    if (CMTIME_IS_INVALID(time) || _blockedTimeRangeCount == 0) {
+        return kCMTimeRangeInvalid;
+    }
+    
+    // Find the last run starting before or at the specified time
+    NSUInteger lowerBound = 0;
+    NSUInteger upperBound = _blockedTimeRangeCount;
+    while (lowerBound < upperBound) {
+        NSUInteger middle = lowerBound + (upperBound - lowerBound) / 2;
+        if (CMTIME_COMPARE_INLINE(_blockedTimeRanges[middle].start, <=, time)) {
+            lowerBound = middle + 1;
+        }
+        else {
+            upperBound = middle;
+        }
+    }
+    
+    if (lowerBound == 0) {
+        return kCMTimeRangeInvalid;
+    }
+    
+    CMTimeRange blockedTimeRange = _blockedTimeRanges[lowerBound - 1];
+    return CMTimeRangeContainsTime(blockedTimeRange, time) ? blockedTimeRange : kCMTimeRangeInvalid;
+}
+
+- (NSArray<id<SRGSegment>> *)blockedSegmentsInTimeRange:(CMTimeRange)timeRange
+{
+    NSMutableArray<id<SRGSegment>> *blockedSegments = [NSMutableArray array];
+    for (NSUInteger i = 0; i < _blockedTimeRangeCount; ++i) {
+        if (CMTimeRangeContainsTimeRange(timeRange, _blockedTimeRanges[i])) {
+            [blockedSegments addObjectsFromArray:self.blockedSegmentRuns[i]];
+        }
+    }
+    return blockedSegments.copy;
+}
+
+- (CMTimeRange)timeRangeForSegment:(id<SRGSegment>)segment
+{
+    NSNumber *index = [self.segmentIndexes objectForKey:segment];
+    if (index) {
+        return self.timeRanges[index.unsignedIntegerValue].CMTimeRangeValue;
+    }
+    else if (self.childSegmentIndex) {
+        return [self.childSegmentIndex timeRangeForSegment:segment];
+    }
+    else {
+        return kCMTimeRangeInvalid;
+    }
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; segments = %@; boundaries = %@; blockedRuns = %@; dateDependent = %@; childSegmentIndex = %@>",
+            self.class,
+            self,
+            @(self.segments.count),
+            @(_boundaryCount),
+            @(_blockedTimeRangeCount),
+            self.dateDependent ? @"YES" : @"NO",
+            self.childSegmentIndex];
+}
+
+@end
+
+#pragma mark Functions
+
+static int SRGSegmentIndexEventCompare(const void *event1, const void *event2)
+{
+    const SRGSegmentIndexEvent *segmentIndexEvent1 = event1;
+    const SRGSegmentIndexEvent *segmentIndexEvent2 = event2;
+    return CMTimeCompare(segmentIndexEvent1->time, segmentIndexEvent2->time);
+}
@@ -0,0 +1,47 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGSignpostSpanBackend.h"
+
+#import <os/signpost.h>
+
+@interface SRGSignpostSpanBackend ()
+
+@property (nonatomic) os_log_t log;
+
+@end
+
+@implementation SRGSignpostSpanBackend
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithSubsystem:(NSString *)subsystem category:(NSString *)category
+{
+    if (self = [super init]) {
+        self.log = os_log_create(subsystem.UTF8String, category.UTF8String);
+    }
+    return self;
+}
+
+- (instancetype)init
+{
+    return [self initWithSubsystem:@"ch.srgssr.mediaplayer" category:@"PointsOfInterest"];
+}
+
+#pragma mark SRGMediaPlayerSpanBackend protocol
+
+// Signpost names must be string literals. Span identifiers are never 0, thus valid signpost identifiers.
+- (void)beginSpanWithName:(const char *)name identifier:(uint64_t)identifier
+{
+    os_signpost_interval_begin(self.log, (os_signpost_id_t)identifier, "Span", "%{public}s", name);
+}
+
+- (void)endSpanWithName:(const char *)name identifier:(uint64_t)identifier
+{
+    os_signpost_interval_end(self.log, (os_signpost_id_t)identifier, "Span", "%{public}s", name);
+}
+
+@end
@@ -0,0 +1,66 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import CoreMedia;
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Piecewise mapping between stream times and dates, built from (time, date) samples.
+ *
+ *  Each retained sample anchors a piece along which dates progress at the same pace as times, up to the next sample.
+ *  Discontinuities and clock drift are therefore accounted for as soon as a sample reveals them. Samples consistent
+ *  with the current mapping (within the specified tolerance) are discarded, so that the table only grows when needed.
+ *  Conversions are made in logarithmic time.
+ *
+ *  @discussion Dates are assumed to increase with times.
+ */
+@interface SRGTimeDateMapping : NSObject
+
+/**
+ *  Create an empty mapping. Samples deviating from the current mapping by more than `tolerance` seconds are retained.
+ */
+- (instancetype)initWithTolerance:(NSTimeInterval)tolerance NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The number of samples in the mapping table.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *  Add a sample to the mapping. Return `YES` iff the mapping changed (invalid samples are ignored).
+ */
+- (BOOL)addSampleWithTime:(CMTime)time timeIntervalSinceReferenceDate:(NSTimeInterval)timeInterval;
+
+/**
+ *  Remove samples which are not needed anymore to map times greater or equal to the specified time. Return `YES` iff
+ *  samples were removed.
+ */
+- (BOOL)removeSamplesBeforeTime:(CMTime)time;
+
+/**
+ *  Return the date corresponding to the specified time, as a time interval since the reference date. `NAN` if the
+ *  mapping is empty or the time invalid.
+ */
+- (NSTimeInterval)timeIntervalSinceReferenceDateForTime:(CMTime)time;
+
+/**
+ *  Return the time corresponding to the specified date, given as a time interval since the reference date. Dates
+ *  falling within a forward discontinuity are mapped to the time at which the discontinuity occurs. `kCMTimeInvalid`
+ *  if the mapping is empty.
+ */
+- (CMTime)timeForTimeIntervalSinceReferenceDate:(NSTimeInterval)timeInterval;
+
+@end
+
+@interface SRGTimeDateMapping (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
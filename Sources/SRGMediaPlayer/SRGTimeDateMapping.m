@@ -0,0 +1,185 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGTimeDateMapping.h"
+
+typedef struct {
+    CMTime time;
+    NSTimeInterval timeInterval;
+} SRGTimeDateSample;
+
+@interface SRGTimeDateMapping () {
+@private
+    SRGTimeDateSample *_samples;
+    NSUInteger _count;
+    NSUInteger _capacity;
+}
+
+@property (nonatomic) NSTimeInterval tolerance;
+
+@end
+
+@implementation SRGTimeDateMapping
+
+#pragma mark Object lifecycle
+
+- (instancetype)initWithTolerance:(NSTimeInterval)tolerance
+{
+    if (self = [super init]) {
+        self.tolerance = tolerance;
+    }
+    return self;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-implementations"
+
+- (instancetype)init
+{
+    return [self initWithTolerance:0.];
+}
+
+#pragma clang diagnostic pop
+
+- (void)dealloc
+{
+    free(_samples);
+}
+
+#pragma mark Getters and setters
+
+- (NSUInteger)count
+{
+    return _count;
+}
+
+#pragma mark Samples
+
+// Return the number of samples located before or at the specified time
+- (NSUInteger)sampleCountUpToTime:(CMTime)time
+{
+    NSUInteger lowerBound = 0;
+    NSUInteger upperBound = _count;
+    while (lowerBound < upperBound) {
+        NSUInteger middle = lowerBound + (upperBound - lowerBound) / 2;
+        if (CMTIME_COMPARE_INLINE(_samples[middle].time, <=, time)) {
+            lowerBound = middle + 1;
+        }
+        else {
+            upperBound = middle;
+        }
+    }
+    return lowerBound;
+}
+
+// Return the number of samples whose date is located before or at the specified date
+- (NSUInteger)sampleCountUpToTimeInterval:(NSTimeInterval)timeInterval
+{
+    NSUInteger lowerBound = 0;
+    NSUInteger upperBound = _count;
+    while (lowerBound < upperBound) {
+        NSUInteger middle = lowerBound + (upperBound - lowerBound) / 2;
+        if (_samples[middle].timeInterval <= timeInterval) {
+            lowerBound = middle + 1;
+        }
+        else {
+            upperBound = middle;
+        }
+    }
+    return lowerBound;
+}
+
+- (BOOL)addSampleWithTime:(CMTime)time timeIntervalSinceReferenceDate:(NSTimeInterval)timeInterval
+{
+    if (! CMTIME_IS_NUMERIC(time) || ! isfinite(timeInterval)) {
+        return NO;
+    }
+    
+    NSTimeInterval expectedTimeInterval = [self timeIntervalSinceReferenceDateForTime:time];
+    if (! isnan(expectedTimeInterval) && fabs(expectedTimeInterval - timeInterval) <= self.tolerance) {
+        return NO;
+    }
+    
+    NSUInteger index = [self sampleCountUpToTime:time];
+    if (index != 0 && CMTIME_COMPARE_INLINE(_samples[index - 1].time, ==, time)) {
+        _samples[index - 1].timeInterval = timeInterval;
+        return YES;
+    }
+    
+    if (_count == _capacity) {
+        _capacity = MAX(2 * _capacity, 8);
+        _samples = realloc(_samples, _capacity * sizeof(SRGTimeDateSample));
+    }
+    
+    memmove(&_samples[index + 1], &_samples[index], (_count - index) * sizeof(SRGTimeDateSample));
+    _samples[index] = (SRGTimeDateSample){ time, timeInterval };
+    ++_count;
+    return YES;
+}
+
+- (BOOL)removeSamplesBeforeTime:(CMTime)time
+{
+    if (CMTIME_IS_INVALID(time)) {
+        return NO;
+    }
+    
+    // Keep the sample anchoring the piece the time belongs to
+    NSUInteger count = [self sampleCountUpToTime:time];
+    if (count < 2) {
+        return NO;
+    }
+    
+    NSUInteger removedCount = count - 1;
+    memmove(&_samples[0], &_samples[removedCount], (_count - removedCount) * sizeof(SRGTimeDateSample));
+    _count -= removedCount;
+    return YES;
+}
+
+#pragma mark Conversions
+
+- (NSTimeInterval)timeIntervalSinceReferenceDateForTime:(CMTime)time
+{
+    if (_count == 0 || ! CMTIME_IS_NUMERIC(time)) {
+        return NAN;
+    }
+    
+    // Times before the first sample are extrapolated from it
+    NSUInteger count = [self sampleCountUpToTime:time];
+    SRGTimeDateSample sample = _samples[(count != 0) ? count - 1 : 0];
+    return sample.timeInterval + CMTimeGetSeconds(CMTimeSubtract(time, sample.time));
+}
+
+- (CMTime)timeForTimeIntervalSinceReferenceDate:(NSTimeInterval)timeInterval
+{
+    if (_count == 0 || ! isfinite(timeInterval)) {
+        return kCMTimeInvalid;
+    }
+    
+    NSUInteger count = [self sampleCountUpToTimeInterval:timeInterval];
+    NSUInteger index = (count != 0) ? count - 1 : 0;
+    
+    SRGTimeDateSample sample = _samples[index];
+    CMTime time = CMTimeAdd(sample.time, CMTimeMakeWithSeconds(timeInterval - sample.timeInterval, NSEC_PER_SEC));
+    
+    // The date is located in a gap between two pieces
+    if (count != 0 && index + 1 < _count && CMTIME_COMPARE_INLINE(time, >, _samples[index + 1].time)) {
+        time = _samples[index + 1].time;
+    }
+    return time;
+}
+
+#pragma mark Description
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; count = %@; tolerance = %@>",
+            self.class,
+            self,
+            @(_count),
+            @(self.tolerance)];
+}
+
+@end
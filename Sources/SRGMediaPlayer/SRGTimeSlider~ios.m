@@ -315,7 +315,7 @@ static NSString *SRGTimeSliderAccessibilityFormatter(NSTimeInterval seconds)
     }
     
     if (self.seekingDuringTracking) {
-        [self.mediaPlayerController seekToPosition:[SRGPosition positionAroundTime:time] withCompletionHandler:nil];
+        [self.mediaPlayerController scrubToPosition:[SRGPosition positionAroundTime:time] withCompletionHandler:nil];
     }
     
     if ([self.delegate respondsToSelector:@selector(timeSlider:isMovingToTime:date:withValue:interactive:)]) {
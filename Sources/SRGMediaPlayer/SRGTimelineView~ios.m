@@ -10,16 +10,21 @@
 
 #import "SRGTimelineView.h"
 
-#import "SRGMediaPlayerController.h"
+#import "SRGMediaPlayerConstants.h"
+#import "SRGMediaPlayerController+Private.h"
 
 @import AVFoundation;
 
 static void commonInit(SRGTimelineView *self);
+static NSArray<NSIndexPath *> *SRGTimelineViewIndexPaths(NSIndexSet *indexes);
 
 @interface SRGTimelineView ()
 
 @property (nonatomic, weak) UICollectionView *collectionView;
 
+// Segments currently displayed by the collection view
+@property (nonatomic) NSArray<id<SRGSegment>> *segments;
+
 @end
 
 @implementation SRGTimelineView
@@ -46,8 +51,21 @@ static void commonInit(SRGTimelineView *self);
 
 - (void)setMediaPlayerController:(SRGMediaPlayerController *)mediaPlayerController
 {
+    if (_mediaPlayerController) {
+        [NSNotificationCenter.defaultCenter removeObserver:self
+                                                      name:SRGMediaPlayerVisibleSegmentsDidChangeNotification
+                                                    object:_mediaPlayerController];
+    }
+    
     _mediaPlayerController = mediaPlayerController;
     [self reloadData];
+    
+    if (mediaPlayerController) {
+        [NSNotificationCenter.defaultCenter addObserver:self
+                                               selector:@selector(visibleSegmentsDidChange:)
+                                                   name:SRGMediaPlayerVisibleSegmentsDidChangeNotification
+                                                 object:mediaPlayerController];
+    }
 }
 
 - (void)setItemWidth:(CGFloat)itemWidth
@@ -97,7 +115,7 @@ static void commonInit(SRGTimelineView *self);
 
 - (id)dequeueReusableCellWithReuseIdentifier:(NSString *)identifier forSegment:(id<SRGSegment>)segment
 {
-    NSInteger index = [self.mediaPlayerController.visibleSegments indexOfObject:segment];
+    NSInteger index = [self indexOfSegment:segment];
     NSAssert(index != NSNotFound, @"The segment must be found");
     NSIndexPath *indexPath = [NSIndexPath indexPathForRow:index inSection:0];
     return [self.collectionView dequeueReusableCellWithReuseIdentifier:identifier forIndexPath:indexPath];
@@ -107,19 +125,98 @@ static void commonInit(SRGTimelineView *self);
 
 - (void)reloadData
 {
+    self.segments = self.mediaPlayerController.visibleSegments ?: @[];
     [self.collectionView reloadData];
 }
 
+- (NSUInteger)indexOfSegment:(id<SRGSegment>)segment
+{
+    // Use the constant-time controller mapping when the displayed list is up to date (usually the case). Fall back to
+    // an equality-based search otherwise, or for segments not found by identity.
+    NSUInteger index = NSNotFound;
+    if (self.segments == self.mediaPlayerController.visibleSegments) {
+        index = [self.mediaPlayerController visibleIndexForSegment:segment];
+    }
+    if (index == NSNotFound) {
+        index = [self.segments indexOfObject:segment];
+    }
+    return index;
+}
+
+- (void)applyChangesFromNotification:(NSNotification *)notification
+{
+    NSArray<id<SRGSegment>> *segments = self.mediaPlayerController.visibleSegments ?: @[];
+    
+    NSIndexSet *insertedIndexes = notification.userInfo[SRGMediaPlayerInsertedIndexesKey];
+    NSIndexSet *removedIndexes = notification.userInfo[SRGMediaPlayerRemovedIndexesKey];
+    NSIndexSet *updatedIndexes = notification.userInfo[SRGMediaPlayerUpdatedIndexesKey];
+    NSDictionary<NSNumber *, NSNumber *> *movedIndexes = notification.userInfo[SRGMediaPlayerMovedIndexesKey];
+    
+    // Batch updates can only be applied if the changes are consistent with what is currently displayed. Off-screen,
+    // a plain reload is cheaper anyway.
+    if (! self.window || self.segments.count - removedIndexes.count + insertedIndexes.count != segments.count) {
+        [self reloadData];
+        return;
+    }
+    
+    // Within a batch, reloads are identified in the previous list, and an item cannot be both moved and reloaded. Updated
+    // items which moved are therefore deleted and inserted again, while the others are reloaded at their previous index.
+    // Items neither inserted nor moved keep their relative order, which lets us find the previous index of the latter.
+    NSMutableIndexSet *deletedIndexes = removedIndexes.mutableCopy;
+    NSMutableIndexSet *addedIndexes = insertedIndexes.mutableCopy;
+    NSMutableIndexSet *reloadedIndexes = [NSMutableIndexSet indexSet];
+    NSMutableDictionary<NSNumber *, NSNumber *> *batchMovedIndexes = [NSMutableDictionary dictionaryWithCapacity:movedIndexes.count];
+    
+    NSMutableIndexSet *stablePreviousIndexes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, self.segments.count)];
+    [stablePreviousIndexes removeIndexes:removedIndexes];
+    NSMutableIndexSet *stableIndexes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, segments.count)];
+    [stableIndexes removeIndexes:insertedIndexes];
+    
+    [movedIndexes enumerateKeysAndObjectsUsingBlock:^(NSNumber * _Nonnull previousIndex, NSNumber * _Nonnull index, BOOL * _Nonnull stop) {
+        [stablePreviousIndexes removeIndex:previousIndex.unsignedIntegerValue];
+        [stableIndexes removeIndex:index.unsignedIntegerValue];
+        
+        if ([updatedIndexes containsIndex:index.unsignedIntegerValue]) {
+            [deletedIndexes addIndex:previousIndex.unsignedIntegerValue];
+            [addedIndexes addIndex:index.unsignedIntegerValue];
+        }
+        else {
+            batchMovedIndexes[previousIndex] = index;
+        }
+    }];
+    
+    NSUInteger stablePreviousIndex = stablePreviousIndexes.firstIndex;
+    for (NSUInteger stableIndex = stableIndexes.firstIndex; stableIndex != NSNotFound; stableIndex = [stableIndexes indexGreaterThanIndex:stableIndex]) {
+        if ([updatedIndexes containsIndex:stableIndex]) {
+            [reloadedIndexes addIndex:stablePreviousIndex];
+        }
+        stablePreviousIndex = [stablePreviousIndexes indexGreaterThanIndex:stablePreviousIndex];
+    }
+    
+    [self.collectionView performBatchUpdates:^{
+        self.segments = segments;
+        
+        [self.collectionView deleteItemsAtIndexPaths:SRGTimelineViewIndexPaths(deletedIndexes)];
+        [self.collectionView insertItemsAtIndexPaths:SRGTimelineViewIndexPaths(addedIndexes)];
+        [self.collectionView reloadItemsAtIndexPaths:SRGTimelineViewIndexPaths(reloadedIndexes)];
+        
+        [batchMovedIndexes enumerateKeysAndObjectsUsingBlock:^(NSNumber * _Nonnull previousIndex, NSNumber * _Nonnull index, BOOL * _Nonnull stop) {
+            [self.collectionView moveItemAtIndexPath:[NSIndexPath indexPathForRow:previousIndex.integerValue inSection:0]
+                                         toIndexPath:[NSIndexPath indexPathForRow:index.integerValue inSection:0]];
+        }];
+    } completion:nil];
+}
+
 #pragma mark UICollectionViewDataSource protocol
 
 - (NSInteger)collectionView:(UICollectionView *)collectionView numberOfItemsInSection:(NSInteger)section
 {
-    return self.mediaPlayerController.visibleSegments.count;
+    return self.segments.count;
 }
 
 - (UICollectionViewCell *)collectionView:(UICollectionView *)collectionView cellForItemAtIndexPath:(NSIndexPath *)indexPath
 {
-    id<SRGSegment> segment = self.mediaPlayerController.visibleSegments[indexPath.row];
+    id<SRGSegment> segment = self.segments[indexPath.row];
     return [self.delegate timelineView:self cellForSegment:segment];
 }
 
@@ -127,7 +224,7 @@ static void commonInit(SRGTimelineView *self);
 
 - (void)collectionView:(UICollectionView *)collectionView didSelectItemAtIndexPath:(NSIndexPath *)indexPath
 {
-    id<SRGSegment> segment = self.mediaPlayerController.visibleSegments[indexPath.row];
+    id<SRGSegment> segment = self.segments[indexPath.row];
     [self.mediaPlayerController seekToPosition:nil inSegment:segment withCompletionHandler:nil];
     
     if ([self.delegate respondsToSelector:@selector(timelineView:didSelectSegmentAtIndexPath:)]) {
@@ -159,7 +256,7 @@ static void commonInit(SRGTimelineView *self);
         return;
     }
     
-    NSInteger segmentIndex = [self.mediaPlayerController.visibleSegments indexOfObject:segment];
+    NSInteger segmentIndex = [self indexOfSegment:segment];
     if (segmentIndex == NSNotFound) {
         return;
     }
@@ -169,6 +266,13 @@ static void commonInit(SRGTimelineView *self);
                                         animated:animated];
 }
 
+#pragma mark Notifications
+
+- (void)visibleSegmentsDidChange:(NSNotification *)notification
+{
+    [self applyChangesFromNotification:notification];
+}
+
 #pragma mark Interface Builder integration
 
 - (void)prepareForInterfaceBuilder
@@ -210,8 +314,19 @@ static void commonInit(SRGTimelineView *self)
         [collectionView.trailingAnchor constraintEqualToAnchor:self.trailingAnchor]
     ]];
     
+    self.segments = @[];
+    
     self.itemWidth = 60.f;
     self.itemSpacing = 4.f;
 }
 
+static NSArray<NSIndexPath *> *SRGTimelineViewIndexPaths(NSIndexSet *indexes)
+{
+    NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:indexes.count];
+    [indexes enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL * _Nonnull stop) {
+        [indexPaths addObject:[NSIndexPath indexPathForRow:idx inSection:0]];
+    }];
+    return indexPaths.copy;
+}
+
 #endif
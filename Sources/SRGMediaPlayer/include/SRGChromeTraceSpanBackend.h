@@ -0,0 +1,47 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerSpans.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Span backend writing spans to a file in the Chrome trace event format, which can be loaded into `chrome://tracing`,
+ *  Perfetto or any tool understanding this format. Spans are written as asynchronous events, timestamps being system
+ *  uptimes in microseconds.
+ *
+ *  @discussion Events are written on a background queue. The file is completed when the backend is closed or
+ *              deallocated.
+ */
+@interface SRGChromeTraceSpanBackend : NSObject <SRGMediaPlayerSpanBackend>
+
+/**
+ *  Create a backend writing to the specified file URL, replacing any existing file. Return `nil` if the file could
+ *  not be created.
+ */
+- (nullable instancetype)initWithFileURL:(NSURL *)fileURL NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  The URL of the file being written.
+ */
+@property (nonatomic, readonly) NSURL *fileURL;
+
+/**
+ *  Write pending events and complete the file. Spans received afterwards are discarded.
+ */
+- (void)close;
+
+@end
+
+@interface SRGChromeTraceSpanBackend (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
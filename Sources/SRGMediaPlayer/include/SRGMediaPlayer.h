@@ -17,11 +17,16 @@ FOUNDATION_EXPORT NSString *SRGMediaPlayerMarketingVersion(void);
 #import "SRGActivityGestureRecognizer.h"
 #import "SRGAirPlayButton.h"
 #import "SRGAirPlayView.h"
+#import "SRGChromeTraceSpanBackend.h"
 #import "SRGMark.h"
 #import "SRGMarkRange.h"
 #import "SRGMediaPlayerConstants.h"
 #import "SRGMediaPlayerController.h"
 #import "SRGMediaPlayerError.h"
+#import "SRGMediaPlayerHistogram.h"
+#import "SRGMediaPlayerMetrics.h"
+#import "SRGMediaPlayerSnapshot.h"
+#import "SRGMediaPlayerSpans.h"
 #import "SRGMediaPlayerView.h"
 #import "SRGMediaPlayerViewController.h"
 #import "SRGPictureInPictureButton.h"
@@ -30,6 +35,7 @@ FOUNDATION_EXPORT NSString *SRGMediaPlayerMarketingVersion(void);
 #import "SRGPlaybackSettingsButton.h"
 #import "SRGPosition.h"
 #import "SRGSegment.h"
+#import "SRGSignpostSpanBackend.h"
 #import "SRGTimelineView.h"
 #import "SRGTimeSlider.h"
 #import "SRGViewModeButton.h"
@@ -133,6 +133,69 @@ typedef NS_ENUM(NSInteger, SRGMediaPlayerSelectionReason) {
     SRGMediaPlayerSelectionReasonUpdate                         // Selection update during playback
 };
 
+/**
+ *  Frequencies at which playback information is refreshed by the controller.
+ */
+typedef NS_ENUM(NSInteger, SRGMediaPlayerRefreshFrequency) {
+    /**
+     *  No periodic refresh. Used when no media is being played, when playback has ended, or when an on-demand stream
+     *  is paused.
+     */
+    SRGMediaPlayerRefreshFrequencyNone = 0,
+    /**
+     *  Refresh every 5 seconds. Used when the application is in background, or when a livestream is paused.
+     */
+    SRGMediaPlayerRefreshFrequencyLow,
+    /**
+     *  Refresh every second.
+     */
+    SRGMediaPlayerRefreshFrequencyNormal,
+    /**
+     *  Refresh every 250 milliseconds. Used during playback shortly before a segment boundary is reached, or when the
+     *  distance to the live edge of a DVR stream is close to the live tolerance.
+     */
+    SRGMediaPlayerRefreshFrequencyHigh
+};
+
+/**
+ *  Policies applied when playback stays stalled for longer than the stall recovery delay.
+ */
+typedef NS_ENUM(NSInteger, SRGMediaPlayerStallRecoveryPolicy) {
+    /**
+     *  Wait until the player resumes playback on its own.
+     */
+    SRGMediaPlayerStallRecoveryPolicyWait = 0,
+    /**
+     *  Ask the player to resume playback immediately with the data already buffered.
+     */
+    SRGMediaPlayerStallRecoveryPolicyNudge,
+    /**
+     *  Cap the item peak bitrate to half the bitrate currently played, so that a lower variant gets selected. The
+     *  original peak bitrate is restored once playback has not stalled again for a while.
+     */
+    SRGMediaPlayerStallRecoveryPolicyLowerBitrate,
+    /**
+     *  Reload the media at the current position (at the live edge for livestreams) and resume playback. The player item
+     *  is replaced on the same player, the playback state, segments and metrics being preserved.
+     */
+    SRGMediaPlayerStallRecoveryPolicyReload
+};
+
+// Default amount of seconds playback must stay stalled before the stall recovery policy is applied.
+static NSTimeInterval const SRGMediaPlayerDefaultStallRecoveryDelay = 5.;
+
+/**
+ *  Controller properties reported by `SRGMediaPlayerPropertiesDidChangeNotification`.
+ */
+typedef NS_OPTIONS(NSUInteger, SRGMediaPlayerProperties) {
+    SRGMediaPlayerPropertyPlaybackState = 1 << 0,               // `playbackState`
+    SRGMediaPlayerPropertyMediaType = 1 << 1,                   // `mediaType`
+    SRGMediaPlayerPropertyTimeRange = 1 << 2,                   // `timeRange`
+    SRGMediaPlayerPropertyStreamType = 1 << 3,                  // `streamType`
+    SRGMediaPlayerPropertyLive = 1 << 4,                        // `live`
+    SRGMediaPlayerPropertyEffectivePlaybackRate = 1 << 5        // `effectivePlaybackRate`
+};
+
 /**
  *  @name Playback setup (provided as `userInfo` to the controller).
  */
@@ -207,11 +270,39 @@ OBJC_EXPORT NSString * const SRGMediaPlayerSegmentDidStartNotification;
 OBJC_EXPORT NSString * const SRGMediaPlayerSegmentDidEndNotification;                       // Notification sent when a segment ends.
 
 /**
- *  Blocked segments skipping notifications.
+ *  Notification sent when the current child segment changes. Use the keys available below to retrieve information from
+ *  the notification `userInfo` dictionary.
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerChildSegmentDidStartNotification;                // Notification sent when a child segment starts.
+OBJC_EXPORT NSString * const SRGMediaPlayerChildSegmentDidEndNotification;                  // Notification sent when a child segment ends.
+
+/**
+ *  Blocked segments skipping notifications. Contiguous blocked segments are skipped at once, with a single pair of
+ *  notifications.
  */
 OBJC_EXPORT NSString * const SRGMediaPlayerWillSkipBlockedSegmentNotification;              // Notification sent when the player starts skipping a blocked segment.
 OBJC_EXPORT NSString * const SRGMediaPlayerDidSkipBlockedSegmentNotification;               // Notification sent when the player finishes skipping a blocked segment.
 
+/**
+ *  Notifications sent when the segment list changes. Use the keys available below to retrieve the changes from the
+ *  notification `userInfo` dictionary. Segments are matched by mark range, and matched segments are reported as updated
+ *  if they are different objects or if their status changed. No notification is sent if the same segment objects are
+ *  set again.
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerSegmentsDidChangeNotification;                   // Notification sent when `segments` changes.
+OBJC_EXPORT NSString * const SRGMediaPlayerVisibleSegmentsDidChangeNotification;            // Notification sent when `visibleSegments` changes.
+
+/**
+ *  Notification sent at most once per run loop turn when controller properties changed, summarizing all changes made
+ *  since the previous notification. Use the keys available below to retrieve the changes from the notification
+ *  `userInfo` dictionary. Properties which changed but recovered their initial value in the meantime are not reported.
+ *
+ *  @discussion Individual KVO and `SRGMediaPlayerPlaybackStateDidChangeNotification` notifications are still sent
+ *              when each property changes. Subscribers interested in the overall controller state should prefer
+ *              this notification, which lets them perform a single update when several properties change at once.
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerPropertiesDidChangeNotification;                 // Notification name.
+
 /**
  *  @name Notification user information keys
  */
@@ -245,18 +336,28 @@ OBJC_EXPORT NSString * const SRGMediaPlayerSeekDateKey;
  */
 OBJC_EXPORT NSString * const SRGMediaPlayerSegmentKey;                                      // The involved segment as an `id<SRGSegment>` object.
 
+/**
+ *  Information available for `SRGMediaPlayerWillSkipBlockedSegmentNotification` and `SRGMediaPlayerDidSkipBlockedSegmentNotification`.
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerSkippedSegmentsKey;                              // All skipped segments as an `NSArray` of `id<SRGSegment>` objects, in time order.
+
 /**
  *  Information available for `SRGMediaPlayerSegmentDidStartNotification` and `SRGMediaPlayerSegmentDidEndNotification`.
  */
 OBJC_EXPORT NSString * const SRGMediaPlayerSelectedKey;                                     // Key to an `NSNumber` wrapping a boolean, set to `YES` iff the segment was selected.
 
 /**
- *  Information available for `SRGMediaPlayerSegmentDidStartNotification`.
+ *  Information available for `SRGMediaPlayerChildSegmentDidStartNotification` and `SRGMediaPlayerChildSegmentDidEndNotification`.
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerParentSegmentKey;                                // The parent of the involved child segment as an `id<SRGSegment>` object.
+
+/**
+ *  Information available for `SRGMediaPlayerSegmentDidStartNotification` and `SRGMediaPlayerChildSegmentDidStartNotification`.
  */
 OBJC_EXPORT NSString * const SRGMediaPlayerPreviousSegmentKey;                              // The previously played segment, if any, as an `id<SRGSegment>` object.
 
 /**
- *  Information available for `SRGMediaPlayerSegmentDidEndNotification`.
+ *  Information available for `SRGMediaPlayerSegmentDidEndNotification` and `SRGMediaPlayerChildSegmentDidEndNotification`.
  */
 OBJC_EXPORT NSString * const SRGMediaPlayerNextSegmentKey;                                  // The segment which will be played next, if any, as an `id<SRGSegment>` object.
 OBJC_EXPORT NSString * const SRGMediaPlayerInterruptionKey;                                 // Key to an `NSNumber` wrapping a boolean, set to `YES` iff the end notification results because segment playback was interrupted.
@@ -267,6 +368,24 @@ OBJC_EXPORT NSString * const SRGMediaPlayerInterruptionKey;
 OBJC_EXPORT NSString * const SRGMediaPlayerSelectionKey;                                    // Key to an `NSNumber` wrapping a boolean, set to `YES` iff the notification results from a segment selection.
 OBJC_EXPORT NSString * const SRGMediaPlayerSelectionReasonKey;                              // Key to an `NSNumber` wrapping a `SRGMediaPlayerSelectionReason`, specifying the reason selection was made.
 
+/**
+ *  Information available for `SRGMediaPlayerSegmentsDidChangeNotification` and `SRGMediaPlayerVisibleSegmentsDidChangeNotification`.
+ *  Changes can be applied as a batch update to a collection displaying the previous segment list.
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerInsertedIndexesKey;                              // Key to an `NSIndexSet` of inserted segments, in the new list.
+OBJC_EXPORT NSString * const SRGMediaPlayerRemovedIndexesKey;                               // Key to an `NSIndexSet` of removed segments, in the previous list.
+OBJC_EXPORT NSString * const SRGMediaPlayerUpdatedIndexesKey;                               // Key to an `NSIndexSet` of updated segments, in the new list.
+OBJC_EXPORT NSString * const SRGMediaPlayerMovedIndexesKey;                                 // Key to an `NSDictionary` mapping indexes of moved segments in the previous list to indexes in the new list.
+
+/**
+ *  Information available for `SRGMediaPlayerPropertiesDidChangeNotification`. Values are dictionaries whose keys are
+ *  `NSNumber`s wrapping single `SRGMediaPlayerProperties` values, and whose values are the property values boxed as
+ *  they are when accessed through key-value coding (e.g. `NSValue` wrapping a `CMTimeRange` for the time range).
+ */
+OBJC_EXPORT NSString * const SRGMediaPlayerChangedPropertiesKey;                            // Key to an `NSNumber` wrapping the `SRGMediaPlayerProperties` which changed.
+OBJC_EXPORT NSString * const SRGMediaPlayerPreviousValuesKey;                               // Key to an `NSDictionary` of the values of changed properties before the changes.
+OBJC_EXPORT NSString * const SRGMediaPlayerValuesKey;                                       // Key to an `NSDictionary` of the values of changed properties after the changes.
+
 /**
  *  Information available for `SRGMediaPlayerAudioTrackDidChangeNotification` and `SRGMediaPlayerSubtitleTrackDidChangeNotification`.
  */
@@ -5,6 +5,8 @@
 //
 
 #import "SRGMediaPlayerConstants.h"
+#import "SRGMediaPlayerMetrics.h"
+#import "SRGMediaPlayerSnapshot.h"
 #import "SRGMediaPlayerView.h"
 #import "SRGPosition.h"
 #import "SRGSegment.h"
@@ -170,6 +172,10 @@ NS_ASSUME_NONNULL_BEGIN
  *
  *  Overlapping segments are not supported, associated time ranges must be disjoint (the behavior is otherwise undefined).
  *
+ *  Segments can optionally contain child segments (e.g. highlights within a chapter). Transitions between child segments
+ *  are reported with dedicated notifications, and `-segmentChainForTime:` returns a segment together with its children
+ *  containing some time.
+ *
  *  ## KVO, boundary time and periodic time observers
  *
  *  In addition to notification registrations, three kinds of observation mechanisms can be set on a player to observe
@@ -422,7 +428,8 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  *  The segments which have been loaded into the player.
  *
- *  @discussion The segment list can be updated at any time.
+ *  @discussion The segment list can be updated at any time. Changes are reported with `SRGMediaPlayerSegmentsDidChangeNotification`
+ *              and `SRGMediaPlayerVisibleSegmentsDidChangeNotification`.
  */
 @property (nonatomic, nullable) NSArray<id<SRGSegment>> *segments;
 
@@ -436,6 +443,91 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, readonly, weak, nullable) id<SRGSegment> currentSegment;
 
+/**
+ *  Return the deepest child segment (@see `-[SRGSegment srg_childSegments]`) of the current segment corresponding to
+ *  the current playback position, `nil` if none.
+ */
+@property (nonatomic, readonly, weak, nullable) id<SRGSegment> currentChildSegment;
+
+/**
+ *  Return the segment containing the specified time, followed by its child segment containing this time (if any), and
+ *  so on. Return an empty array if no segment contains the specified time.
+ */
+- (NSArray<id<SRGSegment>> *)segmentChainForTime:(CMTime)time;
+
+@end
+
+/**
+ *  Segment transition information, as received by segment transition observers.
+ *
+ *  @discussion Segments are not retained by the structure and are only guaranteed to be valid during observer block
+ *              execution. Blocked segments are never reported.
+ */
+typedef struct {
+    /**
+     *  The segment played before the transition, `nil` if none.
+     */
+    __unsafe_unretained id<SRGSegment> _Nullable previousSegment;
+    /**
+     *  The segment played after the transition, `nil` if none.
+     */
+    __unsafe_unretained id<SRGSegment> _Nullable segment;
+    /**
+     *  `YES` iff `segment` has been explicitly selected.
+     */
+    BOOL selected;
+    /**
+     *  The reason why `segment` has been selected. Meaningful only if `selected` is `YES`.
+     */
+    SRGMediaPlayerSelectionReason selectionReason;
+    /**
+     *  `YES` iff playback of `previousSegment` was interrupted (e.g. by a seek or a selection).
+     */
+    BOOL interrupted;
+    /**
+     *  The playback time before the transition.
+     */
+    CMTime lastPlaybackTime;
+    /**
+     *  The playback date before the transition, as a time interval since the reference date. `NAN` if the stream has
+     *  no date information.
+     */
+    NSTimeInterval lastPlaybackTimeIntervalSinceReferenceDate;
+    /**
+     *  The number of elementary transitions coalesced into this one (at least 1).
+     */
+    NSUInteger transitionCount;
+} SRGSegmentTransition;
+
+/**
+ *  @name Segment transition observers
+ */
+
+@interface SRGMediaPlayerController (SegmentTransitions)
+
+/**
+ *  Register a block called on the main thread when playback moves from a segment to another one. This is a lightweight
+ *  alternative to segment start and end notifications, better suited for analytics.
+ *
+ *  @param block The block to be called.
+ *
+ *  @return An opaque token identifying the observer, to be used for removal.
+ *
+ *  @discussion Transitions are coalesced: transitions made within the same run loop iteration or while a seek is being
+ *              made (e.g. when seeking over several segments or skipping blocked ones) are reported as a single transition
+ *              from the segment played initially to the one played eventually. Transitions ending in the segment they
+ *              started from are not reported, unless this segment was selected. No transition information is gathered
+ *              when no observers are registered.
+ */
+- (id)addSegmentTransitionObserverUsingBlock:(void (^)(SRGSegmentTransition transition))block;
+
+/**
+ *  Remove a segment transition observer (does nothing if the observer is not registered).
+ *
+ *  @param observer The observer to remove (does nothing if `nil`).
+ */
+- (void)removeSegmentTransitionObserver:(nullable id)observer;
+
 @end
 
 /**
@@ -509,6 +601,15 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, readonly, getter=isLive) BOOL live;
 
+/**
+ *  An immutable snapshot of the current playback status, published each time the playback state, the time range and
+ *  associated properties (stream type, live status, effective playback rate) or the current segment change.
+ *
+ *  @discussion Unlike other controller properties, this property can be read from any thread. Each snapshot being
+ *              immutable, all values it contains are consistent with each other.
+ */
+@property (readonly) SRGMediaPlayerSnapshot *snapshot;
+
 @end
 
 /**
@@ -553,6 +654,13 @@ NS_ASSUME_NONNULL_BEGIN
  *  @discussion Your can registers observers with the media player controller when you like (you do not have to wait until the player
  *              is ready, observers will be attached to it automatically when appropriate). Note that such observers are not removed
  *              when the player controller is reset (they will not execute until playback is started again).
+ *
+ *              All observers are driven by a single clock ticking at the shortest interval registered, including the one used
+ *              by the controller for its own refreshes (@see `refreshFrequency`). Intervals are therefore rounded to the nearest
+ *              multiple of this shortest interval (e.g. a 0.6 second interval registered next to a 0.25 second one is executed
+ *              every 0.5 second). All blocks are also executed when playback time jumps (e.g. after a seek). Blocks enqueued on
+ *              a custom queue receive the most recent time, ticks occurring while a previous execution is still pending being
+ *              coalesced with it.
  */
 - (id)addPeriodicTimeObserverForInterval:(CMTime)interval queue:(nullable dispatch_queue_t)queue usingBlock:(void (^)(CMTime time))block;
 
@@ -563,6 +671,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)removePeriodicTimeObserver:(nullable id)observer;
 
+/**
+ *  The frequency at which the controller currently refreshes playback information (time range, stream type, live
+ *  status and tracks) on its own. The frequency adapts to the playback context, see `SRGMediaPlayerRefreshFrequency`.
+ *
+ *  @discussion This property is key-value observable. Since the controller refreshes are driven by the same clock
+ *              as periodic time observers registered with the controller, the intervals of the latter might be rounded
+ *              differently when the refresh frequency changes (@see `-addPeriodicTimeObserverForInterval:queue:usingBlock:`).
+ */
+@property (nonatomic, readonly) SRGMediaPlayerRefreshFrequency refreshFrequency;
+
 @end
 
 /**
@@ -921,4 +1039,67 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+/**
+ *  Stall management. Stalls are reported by the player as soon as it has to wait for more data to be buffered while
+ *  playing, and lead to the `SRGMediaPlayerPlaybackStateStalled` state.
+ */
+@interface SRGMediaPlayerController (Stalls)
+
+/**
+ *  The policy applied when playback stays stalled for longer than `stallRecoveryDelay`. The policy is applied again
+ *  after each additional delay until playback resumes. Default is `SRGMediaPlayerStallRecoveryPolicyNudge`.
+ */
+@property (nonatomic) SRGMediaPlayerStallRecoveryPolicy stallRecoveryPolicy;
+
+/**
+ *  The delay after which the stall recovery policy is applied. Default is `SRGMediaPlayerDefaultStallRecoveryDelay`.
+ */
+@property (nonatomic) NSTimeInterval stallRecoveryDelay;
+
+/**
+ *  The date at which the current or most recent stall started, `nil` if none. Key-value observable.
+ */
+@property (nonatomic, readonly, nullable) NSDate *lastStallStartDate;
+
+/**
+ *  The date at which the most recent stall ended, `nil` if none or if a stall is currently ongoing. Key-value observable.
+ */
+@property (nonatomic, readonly, nullable) NSDate *lastStallEndDate;
+
+@end
+
+/**
+ *  Quality-of-experience metrics. The controller measures startup time, stalls, seek latency, bitrate switches and
+ *  dropped frames for the media being played, from the moment it is prepared until another media is prepared.
+ */
+@interface SRGMediaPlayerController (Metrics)
+
+/**
+ *  A summary of the metrics collected for the current (or most recent) playback session, computed on access.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerMetrics *metrics;
+
+@end
+
+/**
+ *  Playback tracing. When enabled, the controller records all inputs it receives (player changes, periodic refreshes,
+ *  seeks, notifications and segment updates) into a compact binary trace of fixed size. Traces can be attached to bug
+ *  reports and replayed offline on any platform with `make replay-trace TRACE=<path>`.
+ */
+@interface SRGMediaPlayerController (Tracing)
+
+/**
+ *  The trace capacity in bytes. Set to a non-zero value to enable tracing (disabled by default). When the trace is
+ *  full, its oldest records are discarded, but the playback state they lead to is kept so that the trace can still be
+ *  replayed. Changing the capacity discards the current trace.
+ */
+@property (nonatomic) NSUInteger traceCapacity;
+
+/**
+ *  The trace recorded so far, from its oldest to its most recent record. `nil` if tracing is disabled.
+ */
+@property (nonatomic, readonly, nullable) NSData *traceData;
+
+@end
+
 NS_ASSUME_NONNULL_END
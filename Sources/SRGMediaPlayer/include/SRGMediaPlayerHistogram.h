@@ -0,0 +1,56 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  An immutable histogram of durations. Values are stored in exponentially growing buckets, so that percentiles can be
+ *  estimated with a relative error below 19% whatever the number of recorded values.
+ */
+@interface SRGMediaPlayerHistogram : NSObject
+
+/**
+ *  The number of recorded values.
+ */
+@property (nonatomic, readonly) NSUInteger count;
+
+/**
+ *  The smallest recorded value, 0 if none.
+ */
+@property (nonatomic, readonly) NSTimeInterval minimum;
+
+/**
+ *  The largest recorded value, 0 if none.
+ */
+@property (nonatomic, readonly) NSTimeInterval maximum;
+
+/**
+ *  The sum of recorded values.
+ */
+@property (nonatomic, readonly) NSTimeInterval sum;
+
+/**
+ *  The mean of recorded values, 0 if none.
+ */
+@property (nonatomic, readonly) NSTimeInterval mean;
+
+/**
+ *  An estimate of the value below which the specified percentage (between 0 and 100) of recorded values fall, 0 if
+ *  none.
+ */
+- (NSTimeInterval)valueAtPercentile:(double)percentile;
+
+@end
+
+@interface SRGMediaPlayerHistogram (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
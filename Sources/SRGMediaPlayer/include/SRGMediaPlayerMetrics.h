@@ -0,0 +1,110 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerHistogram.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  An immutable summary of quality-of-experience metrics for a playback session, i.e. from the time a media is
+ *  prepared for playback until it is stopped or another media is prepared.
+ *
+ *  @discussion Durations which could not be measured (yet) are `NAN`.
+ */
+@interface SRGMediaPlayerMetrics : NSObject
+
+/**
+ *  The system uptime at which playback was prepared (see `-[NSProcessInfo systemUptime]`), `NAN` if no session
+ *  has been started.
+ */
+@property (nonatomic, readonly) NSTimeInterval prepareSystemUptime;
+
+/**
+ *  The time elapsed between playback preparation and the moment the player was ready to play at the requested
+ *  start position.
+ */
+@property (nonatomic, readonly) NSTimeInterval startupDuration;
+
+/**
+ *  The time elapsed between playback preparation and the moment the first video frame was ready for display in the
+ *  controller view. Remains `NAN` for audio content, or if the controller view was never displayed.
+ */
+@property (nonatomic, readonly) NSTimeInterval firstFrameDuration;
+
+/**
+ *  The number of stalls (rebuffering events) which occurred after playback started.
+ */
+@property (nonatomic, readonly) NSUInteger stallCount;
+
+/**
+ *  The total time spent stalled, including an ongoing stall.
+ */
+@property (nonatomic, readonly) NSTimeInterval stallDuration;
+
+/**
+ *  The distribution of completed stall durations.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerHistogram *stallDurationHistogram;
+
+/**
+ *  The distribution of seek latencies, i.e. of the time elapsed between a seek request and its completion.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerHistogram *seekLatencyHistogram;
+
+/**
+ *  The distributions of latencies of individual seeks made by the player, for exact positions (without tolerance) and
+ *  tolerant positions (e.g. `+[SRGPosition positionAroundTime:]`). Unlike `seekLatencyHistogram`, which measures the
+ *  time spent in the seeking state, seeks cancelled by a more recent seek are not included.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerHistogram *exactSeekLatencyHistogram;
+@property (nonatomic, readonly) SRGMediaPlayerHistogram *tolerantSeekLatencyHistogram;
+
+/**
+ *  The distribution of time spent in seeks which were cancelled before they could finish.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerHistogram *cancelledSeekDurationHistogram;
+
+/**
+ *  The distribution of distances between the playback time and the target time of seeks, in seconds.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerHistogram *seekDistanceHistogram;
+
+/**
+ *  The number of seeks cancelled because a more recent seek was requested (e.g. while scrubbing).
+ */
+@property (nonatomic, readonly) NSUInteger supersededSeekCount;
+
+/**
+ *  The number of variant switches with a different bitrate, as reported by the player item access log.
+ */
+@property (nonatomic, readonly) NSUInteger bitrateSwitchCount;
+
+/**
+ *  The bitrate of the variant currently played, as reported by the player item access log, 0 if unknown.
+ */
+@property (nonatomic, readonly) double indicatedBitrate;
+
+/**
+ *  The number of video frames dropped during playback, as reported by the player item access log.
+ */
+@property (nonatomic, readonly) NSUInteger droppedVideoFrameCount;
+
+/**
+ *  The number of errors (e.g. failed segment downloads) reported by the player item error log.
+ */
+@property (nonatomic, readonly) NSUInteger errorCount;
+
+@end
+
+@interface SRGMediaPlayerMetrics (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,75 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerConstants.h"
+#import "SRGSegment.h"
+
+@import CoreMedia;
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  An immutable snapshot of the playback status of a media player controller, captured on the main thread at some
+ *  point in time. Snapshots are consistent and can be used from any thread.
+ */
+@interface SRGMediaPlayerSnapshot : NSObject
+
+/**
+ *  The playback state.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerPlaybackState playbackState;
+
+/**
+ *  The playback time.
+ */
+@property (nonatomic, readonly) CMTime time;
+
+/**
+ *  The time range.
+ */
+@property (nonatomic, readonly) CMTimeRange timeRange;
+
+/**
+ *  The stream type.
+ */
+@property (nonatomic, readonly) SRGMediaPlayerStreamType streamType;
+
+/**
+ *  Whether the stream was played in live conditions.
+ */
+@property (nonatomic, readonly, getter=isLive) BOOL live;
+
+/**
+ *  The effective playback rate.
+ */
+@property (nonatomic, readonly) float effectivePlaybackRate;
+
+/**
+ *  The segment being played, if any.
+ */
+@property (nonatomic, readonly, nullable) id<SRGSegment> currentSegment;
+
+/**
+ *  The system uptime at which the snapshot was captured (see `-[NSProcessInfo systemUptime]`).
+ */
+@property (nonatomic, readonly) NSTimeInterval systemUptime;
+
+/**
+ *  The playback time estimated at the specified system uptime, assuming playback progressed at the effective playback
+ *  rate since the snapshot was captured. Equal to `time` if the snapshot was not captured while playing.
+ */
+- (CMTime)estimatedTimeAtSystemUptime:(NSTimeInterval)systemUptime;
+
+@end
+
+@interface SRGMediaPlayerSnapshot (Unavailable)
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,47 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  A backend receiving the spans emitted by the library around its most expensive operations (media preparation,
+ *  playback information updates, segment lookups, track updates, media configuration reloads, seeks and view mode
+ *  switches).
+ *
+ *  @discussion Spans can begin and end on any thread, and spans of asynchronous operations (e.g. seeks) might overlap.
+ *              Backend implementations must therefore be thread-safe.
+ */
+@protocol SRGMediaPlayerSpanBackend <NSObject>
+
+/**
+ *  A span begins. Names emitted by the library are static strings, and identifiers are unique non-zero values shared by
+ *  the begin and end events of a span.
+ *
+ *  @discussion Names are only guaranteed to be valid during the call. Backends processing them later must copy them.
+ */
+- (void)beginSpanWithName:(const char *)name identifier:(uint64_t)identifier;
+
+/**
+ *  A span ends.
+ */
+- (void)endSpanWithName:(const char *)name identifier:(uint64_t)identifier;
+
+@end
+
+/**
+ *  Set the backend to which spans are emitted, `nil` to disable spans (default). Spans stay compiled into production
+ *  builds and have negligible cost when disabled.
+ */
+OBJC_EXPORT void SRGMediaPlayerSetSpanBackend(id<SRGMediaPlayerSpanBackend> _Nullable backend);
+
+/**
+ *  The current span backend, if any.
+ */
+OBJC_EXPORT id<SRGMediaPlayerSpanBackend> _Nullable SRGMediaPlayerSpanBackend(void);
+
+NS_ASSUME_NONNULL_END
@@ -29,6 +29,16 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, readonly, getter=srg_isHidden) BOOL srg_hidden;
 
+@optional
+
+/**
+ *  Segments nested within the segment (e.g. highlights within a chapter), if any. Child segment time ranges are clipped
+ *  to the parent segment time range. Children can themselves have children.
+ *
+ *  @discussion The blocked and hidden status of child segments is not interpreted by the player.
+ */
+@property (nonatomic, readonly, nullable) NSArray<id<SRGSegment>> *srg_childSegments;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -0,0 +1,31 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "SRGMediaPlayerSpans.h"
+
+@import Foundation;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ *  Span backend emitting spans as signpost intervals, which can be inspected with Instruments. Intervals are all named
+ *  "Span", the span name being provided as interval message.
+ */
+@interface SRGSignpostSpanBackend : NSObject <SRGMediaPlayerSpanBackend>
+
+/**
+ *  Create a backend logging to the specified subsystem and category.
+ */
+- (instancetype)initWithSubsystem:(NSString *)subsystem category:(NSString *)category NS_DESIGNATED_INITIALIZER;
+
+/**
+ *  Create a backend logging to the `ch.srgssr.mediaplayer` subsystem, with a points of interest category.
+ */
+- (instancetype)init;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -20,8 +20,9 @@ NS_ASSUME_NONNULL_BEGIN
  *
  *  To add a timeline to a custom player layout, simply drag and drop an `SRGTimelineView` onto the player layout,
  *  and bind its `mediaPlayerController` and `delegate` outlets. You can of course instantiate and configure the view
- *  programatically as well. Call `-reloadData` when you need to trigger a reload of the timeline based on the segments
- *  available from the media player controller.
+ *  programatically as well. Changes made to the segment list of the media player controller are automatically applied
+ *  to the timeline as animated batch updates. Call `-reloadData` when you need to trigger a full reload of the timeline
+ *  based on the segments available from the media player controller.
  *
  *  Customisation of timeline cells is achieved through subclassing of `UICollectionViewCell`, exactly like a usual
  *  `UICollectionView`.
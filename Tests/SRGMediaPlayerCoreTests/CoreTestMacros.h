@@ -0,0 +1,38 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#ifndef CoreTestMacros_h
+#define CoreTestMacros_h
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int s_failureCount = 0;
+
+#define TestAssert(condition, ...)                                                                          \
+    do {                                                                                                    \
+        if (! (condition)) {                                                                                \
+            fprintf(stderr, "%s:%d: assertion failed: %s. ", __FILE__, __LINE__, #condition);               \
+            fprintf(stderr, __VA_ARGS__);                                                                   \
+            fprintf(stderr, "\n");                                                                          \
+            s_failureCount++;                                                                               \
+            return;                                                                                         \
+        }                                                                                                   \
+    } while (0)
+
+// Return the process exit status, reporting the number of failures, if any
+static inline int TestResult(const char *name)
+{
+    if (s_failureCount != 0) {
+        fprintf(stderr, "%d %s test(s) failed\n", s_failureCount, name);
+        return EXIT_FAILURE;
+    }
+    
+    printf("All %s tests passed\n", name);
+    return EXIT_SUCCESS;
+}
+
+#endif /* CoreTestMacros_h */
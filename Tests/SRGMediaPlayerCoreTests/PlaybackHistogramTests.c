@@ -0,0 +1,103 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+// Platform-independent tests for playback histograms. Run with `make test-core`.
+
+#include "CoreTestMacros.h"
+#include "SRGPlaybackHistogram.h"
+
+#include <math.h>
+
+static void TestEmptyHistogram(void)
+{
+    SRGPlaybackHistogram histogram = { 0 };
+    TestAssert(histogram.count == 0, "count = %llu", (unsigned long long)histogram.count);
+    TestAssert(SRGPlaybackHistogramMean(&histogram) == 0., "mean");
+    TestAssert(SRGPlaybackHistogramValueAtPercentile(&histogram, 50.) == 0., "median");
+}
+
+static void TestInvalidValues(void)
+{
+    SRGPlaybackHistogram histogram = { 0 };
+    SRGPlaybackHistogramRecord(&histogram, -1.);
+    SRGPlaybackHistogramRecord(&histogram, NAN);
+    TestAssert(histogram.count == 0, "count = %llu", (unsigned long long)histogram.count);
+}
+
+static void TestBucketBounds(void)
+{
+    for (int i = 0; i < SRGPlaybackHistogramBucketCount - 1; ++i) {
+        TestAssert(SRGPlaybackHistogramBucketUpperBound(i) < SRGPlaybackHistogramBucketUpperBound(i + 1), "bucket %d", i);
+    }
+    TestAssert(isinf(SRGPlaybackHistogramBucketUpperBound(SRGPlaybackHistogramBucketCount - 1)), "last bucket");
+    TestAssert(SRGPlaybackHistogramBucketUpperBound(SRGPlaybackHistogramBucketCount - 2) > 1000., "largest bound");
+}
+
+static void TestStatistics(void)
+{
+    SRGPlaybackHistogram histogram = { 0 };
+    for (int i = 1; i <= 1000; ++i) {
+        SRGPlaybackHistogramRecord(&histogram, i / 100.);
+    }
+    
+    TestAssert(histogram.count == 1000, "count = %llu", (unsigned long long)histogram.count);
+    TestAssert(histogram.minimum == 0.01 && histogram.maximum == 10., "minimum = %f, maximum = %f", histogram.minimum, histogram.maximum);
+    TestAssert(fabs(SRGPlaybackHistogramMean(&histogram) - 5.005) < 1e-9, "mean = %f", SRGPlaybackHistogramMean(&histogram));
+    
+    // Estimates are bucket upper bounds, within the relative error of the bucket width
+    static const double kPercentiles[] = { 10., 50., 90., 99. };
+    for (size_t i = 0; i < sizeof(kPercentiles) / sizeof(kPercentiles[0]); ++i) {
+        double expectedValue = kPercentiles[i] / 10.;
+        double value = SRGPlaybackHistogramValueAtPercentile(&histogram, kPercentiles[i]);
+        TestAssert(value >= expectedValue && value <= expectedValue * 1.19, "p%.0f = %f", kPercentiles[i], value);
+    }
+    
+    TestAssert(SRGPlaybackHistogramValueAtPercentile(&histogram, 0.) == 0.01, "p0");
+    TestAssert(SRGPlaybackHistogramValueAtPercentile(&histogram, 100.) == 10., "p100");
+}
+
+static void TestOutOfRangeValues(void)
+{
+    SRGPlaybackHistogram histogram = { 0 };
+    SRGPlaybackHistogramRecord(&histogram, 0.);
+    SRGPlaybackHistogramRecord(&histogram, 1e6);
+    
+    TestAssert(histogram.buckets[0] == 1 && histogram.buckets[SRGPlaybackHistogramBucketCount - 1] == 1, "edge buckets");
+    TestAssert(SRGPlaybackHistogramValueAtPercentile(&histogram, 100.) == 1e6, "p100 = %f", SRGPlaybackHistogramValueAtPercentile(&histogram, 100.));
+}
+
+static void TestMerge(void)
+{
+    SRGPlaybackHistogram histogram1 = { 0 };
+    SRGPlaybackHistogram histogram2 = { 0 };
+    SRGPlaybackHistogram histogram = { 0 };
+    for (int i = 1; i <= 100; ++i) {
+        SRGPlaybackHistogramRecord((i % 2 == 0) ? &histogram1 : &histogram2, i);
+        SRGPlaybackHistogramRecord(&histogram, i);
+    }
+    
+    SRGPlaybackHistogram mergedHistogram = { 0 };
+    SRGPlaybackHistogramMerge(&mergedHistogram, &histogram1);
+    SRGPlaybackHistogramMerge(&mergedHistogram, &histogram2);
+    
+    TestAssert(mergedHistogram.count == histogram.count && mergedHistogram.sum == histogram.sum, "count and sum");
+    TestAssert(mergedHistogram.minimum == histogram.minimum && mergedHistogram.maximum == histogram.maximum, "range");
+    for (int i = 0; i < SRGPlaybackHistogramBucketCount; ++i) {
+        TestAssert(mergedHistogram.buckets[i] == histogram.buckets[i], "bucket %d", i);
+    }
+}
+
+int main(void)
+{
+    TestEmptyHistogram();
+    TestInvalidValues();
+    TestBucketBounds();
+    TestStatistics();
+    TestOutOfRangeValues();
+    TestMerge();
+    
+    return TestResult("playback histogram");
+}
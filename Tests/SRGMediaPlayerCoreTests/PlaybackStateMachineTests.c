@@ -0,0 +1,194 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+// Platform-independent tests for the playback state machine. Run with `make test-core`.
+
+#include "CoreTestMacros.h"
+#include "SRGPlaybackStateMachine.h"
+
+#include <stdint.h>
+
+static SRGPlaybackStateMachineState NextState(SRGPlaybackStateMachineState state, SRGPlaybackStateMachineEventType type, bool playing, bool atEnd)
+{
+    return SRGPlaybackStateMachineNextState(state, SRGPlaybackStateMachineEventMake(type, playing, atEnd));
+}
+
+// Transitions as they were originally written in the controller, event by event
+static SRGPlaybackStateMachineState ReferenceNextState(SRGPlaybackStateMachineState state, SRGPlaybackStateMachineEvent event)
+{
+    SRGPlaybackStateMachineState rateState = event.playing ? SRGPlaybackStateMachineStatePlaying : SRGPlaybackStateMachineStatePaused;
+    switch (event.type) {
+        case SRGPlaybackStateMachineEventTypeReset: {
+            return SRGPlaybackStateMachineStateIdle;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypePrepare: {
+            return SRGPlaybackStateMachineStatePreparing;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypeStartCompleted: {
+            return (state == SRGPlaybackStateMachineStatePreparing) ? rateState : state;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypeRateChanged: {
+            if (state != SRGPlaybackStateMachineStateEnded && state != SRGPlaybackStateMachineStateSeeking && ! event.atEnd) {
+                return rateState;
+            }
+            else if (state == SRGPlaybackStateMachineStateEnded && event.playing) {
+                return SRGPlaybackStateMachineStatePlaying;
+            }
+            else {
+                return state;
+            }
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypeSeekStarted: {
+            return SRGPlaybackStateMachineStateSeeking;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypeSeekEnded: {
+            return rateState;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypePlayedToEnd: {
+            return SRGPlaybackStateMachineStateEnded;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypeStallDetected: {
+            return (state == SRGPlaybackStateMachineStatePlaying) ? SRGPlaybackStateMachineStateStalled : state;
+            break;
+        }
+        
+        case SRGPlaybackStateMachineEventTypeStallEnded: {
+            return (state == SRGPlaybackStateMachineStateStalled) ? SRGPlaybackStateMachineStatePlaying : state;
+            break;
+        }
+        
+        default: {
+            return state;
+            break;
+        }
+    }
+}
+
+// xorshift64* generator, for reproducible random event sequences
+static uint64_t RandomNumber(uint64_t *seed)
+{
+    *seed ^= *seed >> 12;
+    *seed ^= *seed << 25;
+    *seed ^= *seed >> 27;
+    return *seed * 2685821657736338717ULL;
+}
+
+static void TestPlaybackLifecycle(void)
+{
+    SRGPlaybackStateMachineState state = SRGPlaybackStateMachineStateIdle;
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypePrepare, false, false);
+    TestAssert(state == SRGPlaybackStateMachineStatePreparing, "state = %d", state);
+    
+    // The player rate is applied once the start position has been reached
+    state = NextState(state, SRGPlaybackStateMachineEventTypeStartCompleted, true, false);
+    TestAssert(state == SRGPlaybackStateMachineStatePlaying, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeStallDetected, true, false);
+    TestAssert(state == SRGPlaybackStateMachineStateStalled, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeStallEnded, true, false);
+    TestAssert(state == SRGPlaybackStateMachineStatePlaying, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeSeekStarted, true, false);
+    TestAssert(state == SRGPlaybackStateMachineStateSeeking, "state = %d", state);
+    
+    // Rate changes during seeks are ignored
+    state = NextState(state, SRGPlaybackStateMachineEventTypeRateChanged, false, false);
+    TestAssert(state == SRGPlaybackStateMachineStateSeeking, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeSeekEnded, false, false);
+    TestAssert(state == SRGPlaybackStateMachineStatePaused, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeRateChanged, true, false);
+    TestAssert(state == SRGPlaybackStateMachineStatePlaying, "state = %d", state);
+    
+    // Non-streamed medias pause right before the end is reached
+    state = NextState(state, SRGPlaybackStateMachineEventTypeRateChanged, false, true);
+    TestAssert(state == SRGPlaybackStateMachineStatePlaying, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypePlayedToEnd, false, true);
+    TestAssert(state == SRGPlaybackStateMachineStateEnded, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeRateChanged, false, true);
+    TestAssert(state == SRGPlaybackStateMachineStateEnded, "state = %d", state);
+    
+    // Playback restarted after it ended
+    state = NextState(state, SRGPlaybackStateMachineEventTypeRateChanged, true, true);
+    TestAssert(state == SRGPlaybackStateMachineStatePlaying, "state = %d", state);
+    
+    state = NextState(state, SRGPlaybackStateMachineEventTypeReset, false, false);
+    TestAssert(state == SRGPlaybackStateMachineStateIdle, "state = %d", state);
+}
+
+static void TestStallOnlyWhilePlaying(void)
+{
+    for (SRGPlaybackStateMachineState state = SRGPlaybackStateMachineStateIdle; state <= SRGPlaybackStateMachineStateEnded; ++state) {
+        SRGPlaybackStateMachineState nextState = NextState(state, SRGPlaybackStateMachineEventTypeStallDetected, true, false);
+        if (state == SRGPlaybackStateMachineStatePlaying) {
+            TestAssert(nextState == SRGPlaybackStateMachineStateStalled, "state = %d", state);
+        }
+        else {
+            TestAssert(nextState == state, "state = %d", state);
+        }
+    }
+}
+
+static void TestRandomEventSequences(void)
+{
+    static const int kSequenceCount = 10000;
+    static const int kSequenceLength = 100;
+    
+    uint64_t seed = 0x5247535352474D50ULL;
+    for (int i = 0; i < kSequenceCount; ++i) {
+        SRGPlaybackStateMachineState state = SRGPlaybackStateMachineStateIdle;
+        for (int j = 0; j < kSequenceLength; ++j) {
+            uint64_t number = RandomNumber(&seed);
+            SRGPlaybackStateMachineEvent event = SRGPlaybackStateMachineEventMake((SRGPlaybackStateMachineEventType)(number % SRGPlaybackStateMachineEventTypeCount),
+                                                                                  (number >> 8) & 1,
+                                                                                  (number >> 9) & 1);
+            SRGPlaybackStateMachineState nextState = SRGPlaybackStateMachineNextState(state, event);
+            TestAssert(nextState >= SRGPlaybackStateMachineStateIdle && nextState <= SRGPlaybackStateMachineStateEnded, "sequence %d, event %d", i, j);
+            
+            SRGPlaybackStateMachineState referenceNextState = ReferenceNextState(state, event);
+            TestAssert(nextState == referenceNextState, "sequence %d, event %d: state %d, event type %d (playing = %d, at end = %d) leads to %d, expected %d",
+                       i, j, state, event.type, event.playing, event.atEnd, nextState, referenceNextState);
+            
+            // Seeks can only be left when they end or when playback is interrupted
+            if (state == SRGPlaybackStateMachineStateSeeking && nextState != state) {
+                TestAssert(event.type == SRGPlaybackStateMachineEventTypeSeekEnded
+                           || event.type == SRGPlaybackStateMachineEventTypePlayedToEnd
+                           || event.type == SRGPlaybackStateMachineEventTypePrepare
+                           || event.type == SRGPlaybackStateMachineEventTypeReset, "sequence %d, event %d", i, j);
+            }
+            
+            state = nextState;
+        }
+    }
+}
+
+int main(void)
+{
+    TestPlaybackLifecycle();
+    TestStallOnlyWhilePlaying();
+    TestRandomEventSequences();
+    
+    return TestResult("playback state machine");
+}
@@ -0,0 +1,263 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+// Platform-independent tests for playback traces. Run with `make test-core`.
+
+#include "CoreTestMacros.h"
+#include "SRGPlaybackTrace.h"
+
+static SRGPlaybackTraceRecord EventRecord(uint64_t timestamp, SRGPlaybackStateMachineEventType type, bool playing)
+{
+    SRGPlaybackTraceRecord record = { .type = SRGPlaybackTraceRecordTypeStateMachineEvent, .timestamp = timestamp };
+    record.event = SRGPlaybackStateMachineEventMake(type, playing, false);
+    return record;
+}
+
+static SRGPlaybackTraceRecord TickRecord(uint64_t timestamp, double time)
+{
+    SRGPlaybackTraceRecord record = { .type = SRGPlaybackTraceRecordTypeTick, .timestamp = timestamp };
+    record.time = time;
+    return record;
+}
+
+static void TestCreation(void)
+{
+    TestAssert(SRGPlaybackTraceCreate(4, SRGPlaybackStateMachineStateIdle) == NULL, "too small capacity");
+    
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(1024, SRGPlaybackStateMachineStateIdle);
+    TestAssert(trace != NULL, "trace creation");
+    TestAssert(SRGPlaybackTraceByteCount(trace) == 0, "empty trace");
+    SRGPlaybackTraceDestroy(trace);
+}
+
+static void TestRoundTrip(void)
+{
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(1024, SRGPlaybackStateMachineStateIdle);
+    
+    SRGPlaybackTraceRecord records[9];
+    records[0] = EventRecord(1, SRGPlaybackStateMachineEventTypePrepare, false);
+    records[1] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeItemStatus, .timestamp = 2, .value = 1 };
+    records[2] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeRate, .timestamp = 3, .rate = 1.5f };
+    records[3] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeTimeRange, .timestamp = 4, .timeRange = { 10., 3600. } };
+    records[4] = TickRecord(UINT64_MAX, 42.25);
+    records[5] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeNotification, .timestamp = 6, .value = SRGPlaybackTraceNotificationPlayedToEnd };
+    records[6] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSeekableTimeRange, .timestamp = 7, .timeRange = { 5., 7200. } };
+    records[7] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeDateSample, .timestamp = 8, .dateSample = { 12.5, 781000000. } };
+    records[8] = (SRGPlaybackTraceRecord){ .type = SRGPlaybackTraceRecordTypeSegmentTransition, .timestamp = 9, .value = UINT32_MAX };
+    
+    for (size_t i = 0; i < 9; ++i) {
+        SRGPlaybackTraceAppend(trace, &records[i]);
+    }
+    
+    uint8_t bytes[1024];
+    size_t length = SRGPlaybackTraceCopyBytes(trace, bytes, sizeof(bytes));
+    TestAssert(length == SRGPlaybackTraceByteCount(trace), "length = %zu", length);
+    
+    size_t offset = 0;
+    SRGPlaybackTraceRecord record;
+    for (size_t i = 0; i < 9; ++i) {
+        TestAssert(SRGPlaybackTraceReadRecord(bytes, length, &offset, &record), "record %zu", i);
+        TestAssert(record.type == records[i].type && record.timestamp == records[i].timestamp, "record %zu", i);
+    }
+    TestAssert(! SRGPlaybackTraceReadRecord(bytes, length, &offset, &record), "end of trace");
+    TestAssert(offset == length, "offset = %zu", offset);
+    
+    offset = 0;
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.event.type == SRGPlaybackStateMachineEventTypePrepare, "event type = %d", record.event.type);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.value == 1, "value = %u", record.value);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.rate == 1.5f, "rate = %f", record.rate);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.timeRange.start == 10. && record.timeRange.duration == 3600., "time range = %f, %f", record.timeRange.start, record.timeRange.duration);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.time == 42.25, "time = %f", record.time);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.timeRange.start == 5. && record.timeRange.duration == 7200., "seekable time range = %f, %f", record.timeRange.start, record.timeRange.duration);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.dateSample.time == 12.5 && record.dateSample.timeIntervalSinceReferenceDate == 781000000., "date sample = %f, %f", record.dateSample.time, record.dateSample.timeIntervalSinceReferenceDate);
+    SRGPlaybackTraceReadRecord(bytes, length, &offset, &record);
+    TestAssert(record.value == UINT32_MAX, "segment index = %u", record.value);
+    
+    SRGPlaybackTraceDestroy(trace);
+}
+
+static void TestRingBufferOverflow(void)
+{
+    // Capacity which is not a multiple of the record length, so that records wrap around the end of the buffer
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(100, SRGPlaybackStateMachineStateIdle);
+    
+    for (uint64_t i = 0; i < 1000; ++i) {
+        SRGPlaybackTraceRecord record = TickRecord(i, (double)i);
+        SRGPlaybackTraceAppend(trace, &record);
+    }
+    
+    // Tick records are 18 bytes long, at most 5 of them fit. Contents start with an 11-byte checkpoint.
+    TestAssert(SRGPlaybackTraceByteCount(trace) == 101, "byte count = %zu", SRGPlaybackTraceByteCount(trace));
+    TestAssert(SRGPlaybackTraceDroppedRecordCount(trace) == 995, "dropped = %llu", (unsigned long long)SRGPlaybackTraceDroppedRecordCount(trace));
+    
+    uint8_t bytes[128];
+    size_t length = SRGPlaybackTraceCopyBytes(trace, bytes, sizeof(bytes));
+    TestAssert(SRGPlaybackTraceCopyBytes(trace, bytes, 100) == 0, "buffer too small");
+    
+    size_t offset = 0;
+    SRGPlaybackTraceRecord record;
+    TestAssert(SRGPlaybackTraceReadRecord(bytes, length, &offset, &record), "checkpoint");
+    TestAssert(record.type == SRGPlaybackTraceRecordTypeCheckpoint && record.timestamp == 994, "checkpoint");
+    TestAssert(record.state == SRGPlaybackStateMachineStateIdle, "state = %d", record.state);
+    
+    // The most recent records are kept, in order
+    for (uint64_t i = 995; i < 1000; ++i) {
+        TestAssert(SRGPlaybackTraceReadRecord(bytes, length, &offset, &record), "record %llu", (unsigned long long)i);
+        TestAssert(record.timestamp == i && record.time == (double)i, "record %llu", (unsigned long long)i);
+    }
+    
+    SRGPlaybackTraceDestroy(trace);
+}
+
+static void TestCorruptData(void)
+{
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(1024, SRGPlaybackStateMachineStateIdle);
+    SRGPlaybackTraceRecord record = TickRecord(1, 1.);
+    SRGPlaybackTraceAppend(trace, &record);
+    SRGPlaybackTraceAppend(trace, &record);
+    
+    uint8_t bytes[1024];
+    size_t length = SRGPlaybackTraceCopyBytes(trace, bytes, sizeof(bytes));
+    
+    // Truncated trace
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(bytes, length - 1, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    TestAssert(summary.recordCount == 1 && ! summary.complete, "record count = %zu", summary.recordCount);
+    
+    // Invalid record type
+    bytes[1] = 0xff;
+    summary = SRGPlaybackTraceReplay(bytes, length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    TestAssert(summary.recordCount == 0 && ! summary.complete, "record count = %zu", summary.recordCount);
+    
+    SRGPlaybackTraceDestroy(trace);
+}
+
+typedef struct {
+    size_t tickCount;
+    SRGPlaybackStateMachineState lastState;
+} ReplayContext;
+
+static void ReplayCallback(const SRGPlaybackTraceRecord *record, SRGPlaybackStateMachineState state, void *context)
+{
+    ReplayContext *replayContext = context;
+    if (record->type == SRGPlaybackTraceRecordTypeTick) {
+        replayContext->tickCount += 1;
+    }
+    replayContext->lastState = state;
+}
+
+static void TestReplay(void)
+{
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(4096, SRGPlaybackStateMachineStateIdle);
+    
+    SRGPlaybackTraceRecord records[] = {
+        EventRecord(1, SRGPlaybackStateMachineEventTypePrepare, false),
+        EventRecord(2, SRGPlaybackStateMachineEventTypeStartCompleted, true),
+        TickRecord(3, 1.),
+        EventRecord(4, SRGPlaybackStateMachineEventTypeSeekStarted, true),
+        EventRecord(5, SRGPlaybackStateMachineEventTypeRateChanged, false),
+        EventRecord(6, SRGPlaybackStateMachineEventTypeSeekEnded, false),
+        TickRecord(7, 2.),
+        EventRecord(8, SRGPlaybackStateMachineEventTypeRateChanged, true)
+    };
+    for (size_t i = 0; i < sizeof(records) / sizeof(records[0]); ++i) {
+        SRGPlaybackTraceAppend(trace, &records[i]);
+    }
+    
+    uint8_t bytes[4096];
+    size_t length = SRGPlaybackTraceCopyBytes(trace, bytes, sizeof(bytes));
+    
+    ReplayContext context = { 0, SRGPlaybackStateMachineStateIdle };
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(bytes, length, SRGPlaybackStateMachineStateIdle, ReplayCallback, &context);
+    TestAssert(summary.complete, "complete replay");
+    TestAssert(summary.recordCount == 8, "record count = %zu", summary.recordCount);
+    TestAssert(summary.state == SRGPlaybackStateMachineStatePlaying, "state = %d", summary.state);
+    
+    // Preparing, playing, seeking, paused, playing
+    TestAssert(summary.transitionCount == 5, "transition count = %zu", summary.transitionCount);
+    TestAssert(context.tickCount == 2, "tick count = %zu", context.tickCount);
+    TestAssert(context.lastState == summary.state, "last state = %d", context.lastState);
+    
+    // Replays are deterministic
+    SRGPlaybackTraceReplaySummary otherSummary = SRGPlaybackTraceReplay(bytes, length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    TestAssert(otherSummary.state == summary.state && otherSummary.recordCount == summary.recordCount
+               && otherSummary.transitionCount == summary.transitionCount, "deterministic replay");
+    
+    SRGPlaybackTraceDestroy(trace);
+}
+
+static void TestWraparoundReplay(void)
+{
+    // Room for a few records only
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(64, SRGPlaybackStateMachineStateIdle);
+    
+    SRGPlaybackTraceRecord prepareRecord = EventRecord(1, SRGPlaybackStateMachineEventTypePrepare, false);
+    SRGPlaybackTraceAppend(trace, &prepareRecord);
+    SRGPlaybackTraceRecord startRecord = EventRecord(2, SRGPlaybackStateMachineEventTypeStartCompleted, true);
+    SRGPlaybackTraceAppend(trace, &startRecord);
+    
+    // Push state machine events out of the trace
+    for (uint64_t i = 3; i < 100; ++i) {
+        SRGPlaybackTraceRecord record = TickRecord(i, (double)i);
+        SRGPlaybackTraceAppend(trace, &record);
+    }
+    
+    SRGPlaybackTraceRecord pauseRecord = EventRecord(100, SRGPlaybackStateMachineEventTypeRateChanged, false);
+    SRGPlaybackTraceAppend(trace, &pauseRecord);
+    
+    uint8_t bytes[128];
+    size_t length = SRGPlaybackTraceCopyBytes(trace, bytes, sizeof(bytes));
+    TestAssert(length != 0, "length = %zu", length);
+    
+    // Replay starts from the playing state reached by discarded records, and therefore leads to the paused state
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(bytes, length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    TestAssert(summary.complete, "complete replay");
+    TestAssert(summary.state == SRGPlaybackStateMachineStatePaused, "state = %d", summary.state);
+    TestAssert(summary.transitionCount == 1, "transition count = %zu", summary.transitionCount);
+    
+    SRGPlaybackTraceDestroy(trace);
+}
+
+static void TestInitialState(void)
+{
+    // Traces created during playback start with a checkpoint
+    SRGPlaybackTrace *trace = SRGPlaybackTraceCreate(1024, SRGPlaybackStateMachineStatePlaying);
+    
+    uint8_t bytes[1024];
+    size_t length = SRGPlaybackTraceCopyBytes(trace, bytes, sizeof(bytes));
+    TestAssert(length == SRGPlaybackTraceByteCount(trace) && length != 0, "length = %zu", length);
+    
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(bytes, length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    TestAssert(summary.complete && summary.state == SRGPlaybackStateMachineStatePlaying, "state = %d", summary.state);
+    TestAssert(summary.transitionCount == 0, "transition count = %zu", summary.transitionCount);
+    
+    // Invalid checkpoint state (the payload follows the 10-byte record header)
+    bytes[10] = 0xff;
+    summary = SRGPlaybackTraceReplay(bytes, length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    TestAssert(summary.recordCount == 0 && ! summary.complete, "record count = %zu", summary.recordCount);
+    
+    SRGPlaybackTraceDestroy(trace);
+}
+
+int main(void)
+{
+    TestCreation();
+    TestRoundTrip();
+    TestRingBufferOverflow();
+    TestCorruptData();
+    TestReplay();
+    TestWraparoundReplay();
+    TestInitialState();
+    
+    return TestResult("playback trace");
+}
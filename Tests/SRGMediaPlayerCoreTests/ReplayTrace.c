@@ -0,0 +1,131 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+// Replay a trace recorded with `SRGMediaPlayerController`, printing each record with the resulting playback state.
+// Run with `make replay-trace TRACE=<path>`.
+
+#include "SRGPlaybackTrace.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *StateName(SRGPlaybackStateMachineState state)
+{
+    static const char *s_names[] = { "idle", "preparing", "playing", "seeking", "paused", "stalled", "ended" };
+    return s_names[state - SRGPlaybackStateMachineStateIdle];
+}
+
+static void PrintRecord(const SRGPlaybackTraceRecord *record, SRGPlaybackStateMachineState state, void *context)
+{
+    (void)context;
+    
+    printf("%" PRIu64 "\t", record->timestamp);
+    switch (record->type) {
+        case SRGPlaybackTraceRecordTypeStateMachineEvent: {
+            printf("event %d (playing = %d, at end = %d)", record->event.type, record->event.playing, record->event.atEnd);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeRate: {
+            printf("rate %g", record->rate);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTick: {
+            printf("tick %g", record->time);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeSeekStart: {
+            printf("seek start %g", record->time);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeSeekEnd: {
+            printf("seek end %g", record->time);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeTimeRange: {
+            printf("time range %g + %g", record->timeRange.start, record->timeRange.duration);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeItemStatus: {
+            printf("item status %u", record->value);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeSegments: {
+            printf("segments %u", record->value);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeNotification: {
+            printf("notification %u", record->value);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeSeekableTimeRange: {
+            printf("seekable time range %g + %g", record->timeRange.start, record->timeRange.duration);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeDateSample: {
+            printf("date sample %g at %g", record->dateSample.timeIntervalSinceReferenceDate, record->dateSample.time);
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeSegmentTransition: {
+            if (record->value != UINT32_MAX) {
+                printf("segment transition to %u", record->value);
+            }
+            else {
+                printf("segment transition to none");
+            }
+            break;
+        }
+        
+        case SRGPlaybackTraceRecordTypeCheckpoint: {
+            printf("checkpoint %s", StateName(record->state));
+            break;
+        }
+    }
+    printf("\t-> %s\n", StateName(state));
+}
+
+int main(int argc, const char *argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s <trace>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    
+    FILE *file = fopen(argv[1], "rb");
+    if (! file) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    
+    uint8_t *bytes = malloc(length > 0 ? (size_t)length : 1);
+    size_t readLength = fread(bytes, 1, (size_t)length, file);
+    fclose(file);
+    
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(bytes, readLength, SRGPlaybackStateMachineStateIdle, PrintRecord, NULL);
+    free(bytes);
+    
+    printf("%zu records replayed, %zu state changes, final state: %s\n", summary.recordCount, summary.transitionCount, StateName(summary.state));
+    if (! summary.complete) {
+        fprintf(stderr, "Replay stopped early because of corrupt data\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -65,6 +65,19 @@
     XCTAssertNotEqualObjects(dateMark1, timeMark3);
 }
 
+- (void)testEqualityAcrossTimescales
+{
+    SRGMark *timeMark1 = [SRGMark markAtTime:CMTimeMake(7, 1)];
+    SRGMark *timeMark2 = [SRGMark markAtTime:CMTimeMakeWithSeconds(7., NSEC_PER_SEC)];
+    XCTAssertEqualObjects(timeMark1, timeMark2);
+    XCTAssertEqual(timeMark1.hash, timeMark2.hash);
+    
+    SRGMark *zeroTimeMark = [SRGMark markAtTime:kCMTimeZero];
+    SRGMark *dateMark = [SRGMark markAtDate:NSDate.date];
+    XCTAssertNotEqualObjects(zeroTimeMark, dateMark);
+    XCTAssertNotEqualObjects(dateMark, zeroTimeMark);
+}
+
 - (void)testHash
 {
     SRGMark *timeMark1 = [SRGMark markAtTime:CMTimeMakeWithSeconds(7., NSEC_PER_SEC)];
@@ -0,0 +1,232 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+#import "TestMacros.h"
+
+#include <malloc/malloc.h>
+
+@import libextobjc;
+
+// Private framework header
+#import "SRGPlaybackClock.h"
+
+static CMTime TimeInSeconds(NSTimeInterval seconds)
+{
+    return CMTimeMakeWithSeconds(seconds, NSEC_PER_SEC);
+}
+
+static size_t BlocksInUse(void)
+{
+    malloc_statistics_t statistics;
+    malloc_zone_statistics(NULL, &statistics);
+    return statistics.blocks_in_use;
+}
+
+@interface PlaybackClockTestCase : MediaPlayerBaseTestCase
+
+@end
+
+@implementation PlaybackClockTestCase
+
+#pragma mark Tests
+
+- (void)testRegistrationOrder
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    NSMutableArray<NSNumber *> *executions = [NSMutableArray array];
+    for (NSInteger i = 0; i < 3; ++i) {
+        [playbackClock addObserverForInterval:TimeInSeconds(1. + i) queue:NULL usingBlock:^(CMTime time) {
+            [executions addObject:@(i)];
+        }];
+    }
+    XCTAssertEqual(playbackClock.observerCount, 3);
+    TestAssertEqualTimeInSeconds(playbackClock.resolution, 1);
+    
+    [playbackClock tickWithTime:kCMTimeZero];
+    XCTAssertEqualObjects(executions, (@[ @0, @1, @2 ]));
+}
+
+- (void)testIntervals
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    __block NSInteger fastCount = 0;
+    [playbackClock addObserverForInterval:TimeInSeconds(0.5) queue:NULL usingBlock:^(CMTime time) {
+        fastCount++;
+    }];
+    
+    __block NSInteger slowCount = 0;
+    [playbackClock addObserverForInterval:TimeInSeconds(1.5) queue:NULL usingBlock:^(CMTime time) {
+        slowCount++;
+    }];
+    
+    for (NSInteger i = 0; i <= 6; ++i) {
+        [playbackClock tickWithTime:TimeInSeconds(i * 0.5)];
+    }
+    XCTAssertEqual(fastCount, 7);
+    XCTAssertEqual(slowCount, 3);
+    
+    // Time jumps execute all blocks and reset the clock phase
+    [playbackClock tickWithTime:TimeInSeconds(20.)];
+    XCTAssertEqual(fastCount, 8);
+    XCTAssertEqual(slowCount, 4);
+    
+    [playbackClock tickWithTime:TimeInSeconds(20.5)];
+    XCTAssertEqual(fastCount, 9);
+    XCTAssertEqual(slowCount, 4);
+}
+
+- (void)testStaleObserverRemoval
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    id removedObserver = [playbackClock addObserverForInterval:TimeInSeconds(1.) queue:NULL usingBlock:^(CMTime time) {
+        XCTFail(@"Removed observers must not be executed");
+    }];
+    [playbackClock removeObserver:removedObserver];
+    XCTAssertEqual(playbackClock.observerCount, 0);
+    XCTAssertFalse(CMTIME_IS_VALID(playbackClock.resolution));
+    
+    __block NSInteger count = 0;
+    id observer = [playbackClock addObserverForInterval:TimeInSeconds(1.) queue:NULL usingBlock:^(CMTime time) {
+        count++;
+    }];
+    XCTAssertNotEqualObjects(observer, removedObserver);
+    
+    // The slot freed by the removed observer has been reused, but the stale observer must not remove the new one
+    [playbackClock removeObserver:removedObserver];
+    XCTAssertEqual(playbackClock.observerCount, 1);
+    
+    [playbackClock tickWithTime:kCMTimeZero];
+    XCTAssertEqual(count, 1);
+}
+
+- (void)testObserverUpdatesDuringTick
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    __block id removedObserver = nil;
+    __block NSInteger addedCount = 0;
+    
+    @weakify(playbackClock)
+    [playbackClock addObserverForInterval:TimeInSeconds(1.) queue:NULL usingBlock:^(CMTime time) {
+        @strongify(playbackClock)
+        [playbackClock removeObserver:removedObserver];
+        [playbackClock addObserverForInterval:TimeInSeconds(1.) queue:NULL usingBlock:^(CMTime time) {
+            addedCount++;
+        }];
+    }];
+    removedObserver = [playbackClock addObserverForInterval:TimeInSeconds(1.) queue:NULL usingBlock:^(CMTime time) {
+        XCTFail(@"Observers removed during a tick must not be executed");
+    }];
+    
+    [playbackClock tickWithTime:kCMTimeZero];
+    XCTAssertEqual(playbackClock.observerCount, 2);
+    XCTAssertEqual(addedCount, 0);
+    
+    [playbackClock tickWithTime:TimeInSeconds(1.)];
+    XCTAssertEqual(playbackClock.observerCount, 3);
+    XCTAssertEqual(addedCount, 1);
+}
+
+- (void)testTickAllocations
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    __block NSInteger count = 0;
+    for (NSInteger i = 0; i < 50; ++i) {
+        [playbackClock addObserverForInterval:TimeInSeconds(0.1 * (i % 5 + 1)) queue:NULL usingBlock:^(CMTime time) {
+            count++;
+        }];
+    }
+    
+    [playbackClock tickWithTime:kCMTimeZero];
+    
+    // Autoreleased objects are kept alive until the end of the test, so that any allocation made per tick accumulates
+    NSInteger const tickCount = 10000;
+    size_t blocksInUse = BlocksInUse();
+    for (NSInteger i = 1; i <= tickCount; ++i) {
+        [playbackClock tickWithTime:TimeInSeconds(i * 0.1)];
+    }
+    XCTAssertTrue((NSInteger)(BlocksInUse() - blocksInUse) <= 1);
+    XCTAssertTrue(count > 50 * tickCount / 5);
+}
+
+- (void)testTickAllocationsWithQueue
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.playbackClockTest", DISPATCH_QUEUE_SERIAL);
+    
+    __block NSInteger count = 0;
+    for (NSInteger i = 0; i < 10; ++i) {
+        [playbackClock addObserverForInterval:TimeInSeconds(0.1) queue:queue usingBlock:^(CMTime time) {
+            count++;
+        }];
+    }
+    
+    [playbackClock tickWithTime:kCMTimeZero];
+    dispatch_sync(queue, ^{});
+    
+    NSInteger const tickCount = 10000;
+    size_t blocksInUse = BlocksInUse();
+    for (NSInteger i = 1; i <= tickCount; ++i) {
+        [playbackClock tickWithTime:TimeInSeconds(i * 0.1)];
+    }
+    dispatch_sync(queue, ^{});
+    XCTAssertTrue((NSInteger)(BlocksInUse() - blocksInUse) <= 1);
+    
+    // Ticks might be coalesced while the queue is busy, but the most recent one is always delivered
+    XCTAssertTrue(count > 10);
+}
+
+- (void)testCoalescedQueueDelivery
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    dispatch_queue_t queue = dispatch_queue_create("ch.srgssr.playbackClockTest", DISPATCH_QUEUE_SERIAL);
+    dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+    
+    NSMutableArray<NSNumber *> *times = [NSMutableArray array];
+    [playbackClock addObserverForInterval:TimeInSeconds(1.) queue:queue usingBlock:^(CMTime time) {
+        [times addObject:@(CMTimeGetSeconds(time))];
+    }];
+    
+    // Block the queue while ticking
+    dispatch_async(queue, ^{
+        dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    });
+    for (NSInteger i = 0; i < 5; ++i) {
+        [playbackClock tickWithTime:TimeInSeconds(i)];
+    }
+    dispatch_semaphore_signal(semaphore);
+    dispatch_sync(queue, ^{});
+    
+    XCTAssertEqualObjects(times, @[ @4 ]);
+}
+
+- (void)testTickPerformance
+{
+    SRGPlaybackClock *playbackClock = [[SRGPlaybackClock alloc] init];
+    
+    __block NSInteger count = 0;
+    for (NSInteger i = 0; i < 50; ++i) {
+        [playbackClock addObserverForInterval:TimeInSeconds(0.1 * (i % 5 + 1)) queue:NULL usingBlock:^(CMTime time) {
+            count++;
+        }];
+    }
+    
+    __block NSInteger tick = 0;
+    [self measureBlock:^{
+        for (NSInteger i = 0; i < 10000; ++i) {
+            [playbackClock tickWithTime:TimeInSeconds(tick++ * 0.1)];
+        }
+    }];
+}
+
+@end
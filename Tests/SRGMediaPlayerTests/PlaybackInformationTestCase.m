@@ -0,0 +1,124 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+
+@import SRGMediaPlayer;
+
+// Private framework header
+#import "SRGPlaybackInformation.h"
+
+static CMTime TimeInSeconds(NSTimeInterval seconds)
+{
+    return CMTimeMakeWithSeconds(seconds, NSEC_PER_SEC);
+}
+
+static CMTimeRange TimeRangeInSeconds(NSTimeInterval start, NSTimeInterval duration)
+{
+    return CMTimeRangeMake(TimeInSeconds(start), TimeInSeconds(duration));
+}
+
+static SRGPlaybackInformationInput PlaybackInformationInput(CMTimeRange seekableTimeRange, CMTime duration, CMTime currentTime)
+{
+    SRGPlaybackInformationInput input = {0};
+    input.readyToPlay = YES;
+    input.hasLoadedTimeRanges = YES;
+    input.firstSeekableTimeRange = seekableTimeRange;
+    input.lastSeekableTimeRange = seekableTimeRange;
+    input.duration = duration;
+    input.currentTime = currentTime;
+    input.currentTimeIntervalSinceReferenceDate = NAN;
+    input.minimumDVRWindowLength = 0.;
+    input.liveTolerance = SRGMediaPlayerDefaultLiveTolerance;
+    input.playbackRate = 1.f;
+    input.effectivePlaybackRate = 1.f;
+    return input;
+}
+
+@interface PlaybackInformationTestCase : MediaPlayerBaseTestCase
+
+@end
+
+@implementation PlaybackInformationTestCase
+
+#pragma mark Tests
+
+- (void)testNotReadyToPlay
+{
+    SRGPlaybackInformationInput input = PlaybackInformationInput(TimeRangeInSeconds(0., 100.), TimeInSeconds(100.), kCMTimeZero);
+    input.readyToPlay = NO;
+    
+    SRGPlaybackInformation playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertTrue(CMTIMERANGE_IS_INVALID(playbackInformation.timeRange));
+    XCTAssertEqual(playbackInformation.streamType, SRGMediaPlayerStreamTypeUnknown);
+    XCTAssertFalse(playbackInformation.live);
+}
+
+- (void)testOnDemand
+{
+    SRGPlaybackInformationInput input = PlaybackInformationInput(TimeRangeInSeconds(0., 100.), TimeInSeconds(100.), TimeInSeconds(50.));
+    input.playbackRate = 2.f;
+    
+    SRGPlaybackInformation playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertTrue(CMTimeRangeEqual(playbackInformation.timeRange, TimeRangeInSeconds(0., 100.)));
+    XCTAssertEqual(playbackInformation.streamType, SRGMediaPlayerStreamTypeOnDemand);
+    XCTAssertFalse(playbackInformation.live);
+    XCTAssertEqual(playbackInformation.effectivePlaybackRate, 2.f);
+}
+
+- (void)testLive
+{
+    SRGPlaybackInformationInput input = PlaybackInformationInput(kCMTimeRangeInvalid, kCMTimeIndefinite, TimeInSeconds(10.));
+    
+    SRGPlaybackInformation playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertTrue(CMTimeRangeEqual(playbackInformation.timeRange, kCMTimeRangeZero));
+    XCTAssertEqual(playbackInformation.streamType, SRGMediaPlayerStreamTypeLive);
+    XCTAssertTrue(playbackInformation.live);
+    XCTAssertEqual(playbackInformation.effectivePlaybackRate, 1.f);
+}
+
+- (void)testDVR
+{
+    SRGPlaybackInformationInput input = PlaybackInformationInput(TimeRangeInSeconds(0., 3600.), kCMTimeIndefinite, TimeInSeconds(3600.));
+    input.playbackRate = 2.f;
+    
+    SRGPlaybackInformation playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertEqual(playbackInformation.streamType, SRGMediaPlayerStreamTypeDVR);
+    XCTAssertTrue(playbackInformation.live);
+    
+    // Fast playback is not possible near the live edge
+    XCTAssertEqual(playbackInformation.effectivePlaybackRate, 1.f);
+    
+    input.currentTime = TimeInSeconds(1800.);
+    
+    playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertFalse(playbackInformation.live);
+    XCTAssertEqual(playbackInformation.effectivePlaybackRate, 2.f);
+}
+
+- (void)testDVRWindowTooSmall
+{
+    SRGPlaybackInformationInput input = PlaybackInformationInput(TimeRangeInSeconds(0., 30.), kCMTimeIndefinite, TimeInSeconds(30.));
+    input.minimumDVRWindowLength = 60.;
+    
+    SRGPlaybackInformation playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertTrue(CMTIMERANGE_IS_EMPTY(playbackInformation.timeRange));
+    XCTAssertEqual(playbackInformation.streamType, SRGMediaPlayerStreamTypeLive);
+}
+
+- (void)testCachedInformation
+{
+    SRGPlaybackInformationInput input = PlaybackInformationInput(TimeRangeInSeconds(0., 50.), TimeInSeconds(100.), TimeInSeconds(20.));
+    input.cached = YES;
+    input.cachedTimeRange = TimeRangeInSeconds(0., 100.);
+    input.cachedStreamType = SRGMediaPlayerStreamTypeOnDemand;
+    
+    SRGPlaybackInformation playbackInformation = SRGPlaybackInformationMake(input);
+    XCTAssertTrue(CMTimeRangeEqual(playbackInformation.timeRange, TimeRangeInSeconds(0., 100.)));
+    XCTAssertEqual(playbackInformation.streamType, SRGMediaPlayerStreamTypeOnDemand);
+}
+
+@end
@@ -0,0 +1,195 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+
+@import SRGMediaPlayer;
+
+// Private framework header
+#import "SRGPlaybackMetricsCollector.h"
+
+// Logs cannot be instantiated, these classes provide the information the collector extracts from them
+@interface LogEvent : NSObject
+
+@property (nonatomic) double indicatedBitrate;
+@property (nonatomic) NSInteger numberOfDroppedVideoFrames;
+
+@end
+
+@implementation LogEvent
+
+@end
+
+@interface Log : NSObject
+
+@property (nonatomic) NSArray *events;
+
+@end
+
+@implementation Log
+
+@end
+
+static LogEvent *LogEventWithIndicatedBitrate(double indicatedBitrate, NSInteger numberOfDroppedVideoFrames)
+{
+    LogEvent *event = [[LogEvent alloc] init];
+    event.indicatedBitrate = indicatedBitrate;
+    event.numberOfDroppedVideoFrames = numberOfDroppedVideoFrames;
+    return event;
+}
+
+static Log *LogWithEvents(NSArray *events)
+{
+    Log *log = [[Log alloc] init];
+    log.events = events;
+    return log;
+}
+
+@interface PlaybackMetricsTestCase : MediaPlayerBaseTestCase
+
+@end
+
+@implementation PlaybackMetricsTestCase
+
+#pragma mark Tests
+
+- (void)testNoSession
+{
+    SRGPlaybackMetricsCollector *collector = [[SRGPlaybackMetricsCollector alloc] init];
+    [collector recordReadyToPlayAtTime:1.];
+    [collector recordStallStartAtTime:2.];
+    
+    SRGMediaPlayerMetrics *metrics = [collector metricsAtTime:3.];
+    XCTAssertTrue(isnan(metrics.prepareSystemUptime));
+    XCTAssertTrue(isnan(metrics.startupDuration));
+    XCTAssertTrue(isnan(metrics.firstFrameDuration));
+    XCTAssertEqual(metrics.stallCount, 0);
+    XCTAssertEqual(metrics.stallDuration, 0.);
+    XCTAssertEqual(metrics.seekLatencyHistogram.count, 0);
+}
+
+- (void)testStartup
+{
+    SRGPlaybackMetricsCollector *collector = [[SRGPlaybackMetricsCollector alloc] init];
+    [collector startSessionAtTime:10.];
+    [collector recordFirstFrameAtTime:10.5];
+    [collector recordReadyToPlayAtTime:11.];
+    
+    // Only the first occurrences are recorded
+    [collector recordFirstFrameAtTime:20.];
+    [collector recordReadyToPlayAtTime:20.];
+    
+    SRGMediaPlayerMetrics *metrics = [collector metricsAtTime:30.];
+    XCTAssertEqual(metrics.prepareSystemUptime, 10.);
+    XCTAssertEqualWithAccuracy(metrics.startupDuration, 1., 1e-9);
+    XCTAssertEqualWithAccuracy(metrics.firstFrameDuration, 0.5, 1e-9);
+}
+
+- (void)testStalls
+{
+    SRGPlaybackMetricsCollector *collector = [[SRGPlaybackMetricsCollector alloc] init];
+    [collector startSessionAtTime:0.];
+    
+    [collector recordStallStartAtTime:10.];
+    [collector recordStallEndAtTime:12.];
+    [collector recordStallStartAtTime:20.];
+    [collector recordStallEndAtTime:21.];
+    [collector recordStallStartAtTime:30.];
+    
+    // The ongoing stall is accounted for in the total duration, but not in the histogram
+    SRGMediaPlayerMetrics *metrics = [collector metricsAtTime:34.];
+    XCTAssertEqual(metrics.stallCount, 3);
+    XCTAssertEqualWithAccuracy(metrics.stallDuration, 7., 1e-9);
+    XCTAssertEqual(metrics.stallDurationHistogram.count, 2);
+    XCTAssertEqualWithAccuracy(metrics.stallDurationHistogram.minimum, 1., 1e-9);
+    XCTAssertEqualWithAccuracy(metrics.stallDurationHistogram.maximum, 2., 1e-9);
+    XCTAssertEqualWithAccuracy(metrics.stallDurationHistogram.mean, 1.5, 1e-9);
+}
+
+- (void)testSeeks
+{
+    SRGPlaybackMetricsCollector *collector = [[SRGPlaybackMetricsCollector alloc] init];
+    [collector startSessionAtTime:0.];
+    
+    [collector recordSeekStartAtTime:10.];
+    [collector recordSeekEndAtTime:10.2];
+    
+    // Seeks requested while a seek is pending are measured from the first request
+    [collector recordSeekStartAtTime:20.];
+    [collector recordSeekStartAtTime:20.5];
+    [collector recordSeekEndAtTime:21.];
+    
+    SRGMediaPlayerMetrics *metrics = [collector metricsAtTime:30.];
+    XCTAssertEqual(metrics.seekLatencyHistogram.count, 2);
+    XCTAssertEqualWithAccuracy(metrics.seekLatencyHistogram.minimum, 0.2, 1e-9);
+    XCTAssertEqualWithAccuracy(metrics.seekLatencyHistogram.maximum, 1., 1e-9);
+    XCTAssertEqualWithAccuracy([metrics.seekLatencyHistogram valueAtPercentile:100.], 1., 1e-9);
+}
+
+- (void)testItemLogs
+{
+    SRGPlaybackMetricsCollector *collector = [[SRGPlaybackMetricsCollector alloc] init];
+    [collector startSessionAtTime:0.];
+    
+    Log *accessLog = LogWithEvents(@[ LogEventWithIndicatedBitrate(1000., 2), LogEventWithIndicatedBitrate(2000., 3) ]);
+    Log *errorLog = LogWithEvents(@[ NSNull.null ]);
+    [collector updateWithAccessLog:(AVPlayerItemAccessLog *)accessLog errorLog:(AVPlayerItemErrorLog *)errorLog];
+    
+    SRGMediaPlayerMetrics *metrics = [collector metricsAtTime:1.];
+    XCTAssertEqual(metrics.bitrateSwitchCount, 1);
+    XCTAssertEqual(metrics.indicatedBitrate, 2000.);
+    XCTAssertEqual(metrics.droppedVideoFrameCount, 5);
+    XCTAssertEqual(metrics.errorCount, 1);
+    
+    // Updating with the logs of the same item does not count them twice
+    [collector updateWithAccessLog:(AVPlayerItemAccessLog *)accessLog errorLog:(AVPlayerItemErrorLog *)errorLog];
+    XCTAssertEqual([collector metricsAtTime:1.].droppedVideoFrameCount, 5);
+    
+    // Metrics of the items played during a session are accumulated. Switching from the bitrate of the previous item
+    // counts as a switch.
+    [collector startItem];
+    
+    SRGMediaPlayerMetrics *newItemMetrics = [collector metricsAtTime:2.];
+    XCTAssertEqual(newItemMetrics.bitrateSwitchCount, 1);
+    XCTAssertEqual(newItemMetrics.droppedVideoFrameCount, 5);
+    
+    Log *newAccessLog = LogWithEvents(@[ LogEventWithIndicatedBitrate(500., 1) ]);
+    Log *newErrorLog = LogWithEvents(@[ NSNull.null, NSNull.null ]);
+    [collector updateWithAccessLog:(AVPlayerItemAccessLog *)newAccessLog errorLog:(AVPlayerItemErrorLog *)newErrorLog];
+    
+    SRGMediaPlayerMetrics *updatedMetrics = [collector metricsAtTime:3.];
+    XCTAssertEqual(updatedMetrics.bitrateSwitchCount, 2);
+    XCTAssertEqual(updatedMetrics.indicatedBitrate, 500.);
+    XCTAssertEqual(updatedMetrics.droppedVideoFrameCount, 6);
+    XCTAssertEqual(updatedMetrics.errorCount, 3);
+    
+    // A new session starts from scratch
+    [collector startSessionAtTime:10.];
+    [collector updateWithAccessLog:(AVPlayerItemAccessLog *)newAccessLog errorLog:(AVPlayerItemErrorLog *)newErrorLog];
+    
+    SRGMediaPlayerMetrics *newSessionMetrics = [collector metricsAtTime:11.];
+    XCTAssertEqual(newSessionMetrics.bitrateSwitchCount, 0);
+    XCTAssertEqual(newSessionMetrics.droppedVideoFrameCount, 1);
+    XCTAssertEqual(newSessionMetrics.errorCount, 2);
+}
+
+- (void)testNewSession
+{
+    SRGPlaybackMetricsCollector *collector = [[SRGPlaybackMetricsCollector alloc] init];
+    [collector startSessionAtTime:0.];
+    [collector recordReadyToPlayAtTime:1.];
+    [collector recordStallStartAtTime:10.];
+    
+    [collector startSessionAtTime:20.];
+    
+    SRGMediaPlayerMetrics *metrics = [collector metricsAtTime:30.];
+    XCTAssertEqual(metrics.prepareSystemUptime, 20.);
+    XCTAssertTrue(isnan(metrics.startupDuration));
+    XCTAssertEqual(metrics.stallCount, 0);
+    XCTAssertEqual(metrics.stallDuration, 0.);
+}
+
+@end
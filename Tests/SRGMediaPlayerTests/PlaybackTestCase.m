@@ -11,6 +11,11 @@
 @import MAKVONotificationCenter;
 @import SRGMediaPlayer;
 
+// Private framework headers
+#import "SRGMediaPlayerController+Private.h"
+#import "SRGPlaybackTrace.h"
+#import "SRGPlayer.h"
+
 static NSURL *OnDemandTestURL(void)
 {
     return [NSURL URLWithString:@"https://devstreaming-cdn.apple.com/videos/streaming/examples/bipbop_16x9/bipbop_16x9_variant.m3u8"];
@@ -1470,6 +1475,38 @@ static NSURL *AudioOverHTTPTestURL(void)
     [self waitForExpectationsWithTimeout:30. handler:nil];
 }
 
+- (void)testStaleSeekCompletion
+{
+    // Wait until the player is in the playing state to seek
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTestExpectation *seekFinishedExpectation = [self expectationWithDescription:@"Seek finished"];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerSeekNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqual(self.mediaPlayerController.playbackState, SRGMediaPlayerPlaybackStateSeeking);
+        
+        // A completion delivered for an older seek request must not end the seek being made
+        id<SRGPlayerDelegate> playerDelegate = (id<SRGPlayerDelegate>)self.mediaPlayerController;
+        [playerDelegate player:(SRGPlayer *)self.mediaPlayerController.player didSeekToTime:kCMTimeZero sequenceNumber:0];
+        XCTAssertEqual(self.mediaPlayerController.playbackState, SRGMediaPlayerPlaybackStateSeeking);
+        return YES;
+    }];
+    
+    [self.mediaPlayerController seekToPosition:[SRGPosition positionAtTimeInSeconds:30.] withCompletionHandler:^(BOOL finished) {
+        XCTAssertTrue(finished);
+        XCTAssertEqual(self.mediaPlayerController.playbackState, SRGMediaPlayerPlaybackStatePlaying);
+        [seekFinishedExpectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+}
+
 - (void)testSeekInterruptionSeries
 {
     XCTestExpectation *seekFinishedExpectation = [self expectationWithDescription:@"Seek finished"];
@@ -2615,6 +2652,432 @@ static NSURL *AudioOverHTTPTestURL(void)
     [self waitForExpectationsWithTimeout:30. handler:nil];
 }
 
+- (void)testSnapshot
+{
+    SRGMediaPlayerSnapshot *idleSnapshot = self.mediaPlayerController.snapshot;
+    XCTAssertEqual(idleSnapshot.playbackState, SRGMediaPlayerPlaybackStateIdle);
+    XCTAssertEqual(idleSnapshot.streamType, SRGMediaPlayerStreamTypeUnknown);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Snapshots are immutable
+    XCTAssertEqual(idleSnapshot.playbackState, SRGMediaPlayerPlaybackStateIdle);
+    
+    XCTestExpectation *snapshotExpectation = [self expectationWithDescription:@"Snapshot read from a background thread"];
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        SRGMediaPlayerSnapshot *snapshot = self.mediaPlayerController.snapshot;
+        XCTAssertEqual(snapshot.playbackState, SRGMediaPlayerPlaybackStatePlaying);
+        XCTAssertEqual(snapshot.streamType, SRGMediaPlayerStreamTypeOnDemand);
+        XCTAssertFalse(snapshot.live);
+        XCTAssertTrue(SRG_CMTIMERANGE_IS_NOT_EMPTY(snapshot.timeRange));
+        XCTAssertEqual(snapshot.effectivePlaybackRate, 1.f);
+        XCTAssertNil(snapshot.currentSegment);
+        
+        CMTime estimatedTime = [snapshot estimatedTimeAtSystemUptime:snapshot.systemUptime + 2.];
+        TestAssertAlmostEqual(estimatedTime, CMTimeGetSeconds(snapshot.time) + 2., 0.01);
+        
+        [snapshotExpectation fulfill];
+    });
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+}
+
+- (void)testPropertiesDidChangeNotification
+{
+    __block SRGMediaPlayerProperties streamTypeChangeProperties = 0;
+    [self expectationForSingleNotification:SRGMediaPlayerPropertiesDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        SRGMediaPlayerProperties changedProperties = [notification.userInfo[SRGMediaPlayerChangedPropertiesKey] unsignedIntegerValue];
+        XCTAssertNotEqual(changedProperties, 0);
+        
+        NSDictionary<NSNumber *, id> *previousValues = notification.userInfo[SRGMediaPlayerPreviousValuesKey];
+        NSDictionary<NSNumber *, id> *values = notification.userInfo[SRGMediaPlayerValuesKey];
+        XCTAssertEqual(previousValues.count, values.count);
+        
+        if (changedProperties & SRGMediaPlayerPropertyStreamType) {
+            XCTAssertEqualObjects(previousValues[@(SRGMediaPlayerPropertyStreamType)], @(SRGMediaPlayerStreamTypeUnknown));
+            XCTAssertEqualObjects(values[@(SRGMediaPlayerPropertyStreamType)], @(SRGMediaPlayerStreamTypeOnDemand));
+            streamTypeChangeProperties = changedProperties;
+        }
+        
+        return [values[@(SRGMediaPlayerPropertyPlaybackState)] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Changes made at the same time are reported together
+    XCTAssertTrue(streamTypeChangeProperties & SRGMediaPlayerPropertyTimeRange);
+}
+
+- (void)testTrace
+{
+    XCTAssertNil(self.mediaPlayerController.traceData);
+    
+    self.mediaPlayerController.traceCapacity = 64 * 1024;
+    XCTAssertEqual(self.mediaPlayerController.traceData.length, 0);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Replaying the trace leads to the same playback state
+    NSData *traceData = self.mediaPlayerController.traceData;
+    XCTAssertNotEqual(traceData.length, 0);
+    
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(traceData.bytes, traceData.length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    XCTAssertTrue(summary.complete);
+    XCTAssertEqual((SRGMediaPlayerPlaybackState)summary.state, SRGMediaPlayerPlaybackStatePlaying);
+    
+    self.mediaPlayerController.traceCapacity = 0;
+    XCTAssertNil(self.mediaPlayerController.traceData);
+}
+
+- (void)testTraceStartedDuringPlayback
+{
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // A small trace, which quickly discards its oldest records
+    self.mediaPlayerController.traceCapacity = 64;
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePaused;
+    }];
+    
+    [self.mediaPlayerController pause];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Replay starts from the state the trace was created or wrapped in
+    NSData *traceData = self.mediaPlayerController.traceData;
+    SRGPlaybackTraceReplaySummary summary = SRGPlaybackTraceReplay(traceData.bytes, traceData.length, SRGPlaybackStateMachineStateIdle, NULL, NULL);
+    XCTAssertTrue(summary.complete);
+    XCTAssertEqual((SRGMediaPlayerPlaybackState)summary.state, SRGMediaPlayerPlaybackStatePaused);
+}
+
+- (void)testMetrics
+{
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    SRGMediaPlayerMetrics *metrics = self.mediaPlayerController.metrics;
+    XCTAssertFalse(isnan(metrics.prepareSystemUptime));
+    XCTAssertGreaterThan(metrics.startupDuration, 0.);
+    XCTAssertEqual(metrics.stallCount, 0);
+    
+    [self.mediaPlayerController reset];
+    
+    // Metrics remain available after playback has been stopped
+    XCTAssertEqual(self.mediaPlayerController.metrics.startupDuration, metrics.startupDuration);
+}
+
+- (void)testFirstFrameMetrics
+{
+    // Ensure a view is available
+    XCTAssertNotNil(self.mediaPlayerController.view);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self expectationForElapsedTimeInterval:3. withHandler:nil];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTAssertFalse(isnan(self.mediaPlayerController.metrics.firstFrameDuration));
+    
+    // The first frame is recorded for each new item, even if the view was already ready for display
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self expectationForElapsedTimeInterval:3. withHandler:nil];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTAssertFalse(isnan(self.mediaPlayerController.metrics.firstFrameDuration));
+}
+
+- (void)testSeekMetrics
+{
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Scrubbing seeks are coalesced. The first seek is performed, the second one dropped in favor of the third one.
+    XCTestExpectation *seekExpectation1 = [self expectationWithDescription:@"Seek 1"];
+    [self.mediaPlayerController scrubToPosition:[SRGPosition positionAtTimeInSeconds:20.] withCompletionHandler:^(BOOL finished) {
+        XCTAssertTrue(finished);
+        [seekExpectation1 fulfill];
+    }];
+    
+    XCTestExpectation *seekExpectation2 = [self expectationWithDescription:@"Seek 2"];
+    [self.mediaPlayerController scrubToPosition:[SRGPosition positionAtTimeInSeconds:30.] withCompletionHandler:^(BOOL finished) {
+        XCTAssertFalse(finished);
+        [seekExpectation2 fulfill];
+    }];
+    
+    XCTestExpectation *seekExpectation3 = [self expectationWithDescription:@"Seek 3"];
+    [self.mediaPlayerController scrubToPosition:[SRGPosition positionAroundTimeInSeconds:40.] withCompletionHandler:^(BOOL finished) {
+        XCTAssertTrue(finished);
+        [seekExpectation3 fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    SRGMediaPlayerMetrics *metrics = self.mediaPlayerController.metrics;
+    XCTAssertEqual(metrics.supersededSeekCount, 0);
+    XCTAssertEqual(metrics.cancelledSeekDurationHistogram.count, 0);
+    XCTAssertEqual(metrics.exactSeekLatencyHistogram.count, 1);
+    XCTAssertEqual(metrics.tolerantSeekLatencyHistogram.count, 1);
+    XCTAssertEqual(metrics.seekDistanceHistogram.count, 2);
+    
+    // A single seek is perceived
+    XCTAssertEqual(metrics.seekLatencyHistogram.count, 1);
+}
+
+- (void)testStallRecoveryDefaults
+{
+    XCTAssertEqual(self.mediaPlayerController.stallRecoveryPolicy, SRGMediaPlayerStallRecoveryPolicyNudge);
+    XCTAssertEqual(self.mediaPlayerController.stallRecoveryDelay, SRGMediaPlayerDefaultStallRecoveryDelay);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTAssertNil(self.mediaPlayerController.lastStallStartDate);
+    XCTAssertNil(self.mediaPlayerController.lastStallEndDate);
+}
+
+- (void)testNoStallForCleanStart
+{
+    // Buffering when playback starts or after a seek is not a stall
+    id playbackStateObserver = [NSNotificationCenter.defaultCenter addObserverForName:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController queue:nil usingBlock:^(NSNotification * _Nonnull notification) {
+        if ([notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStateStalled) {
+            XCTFail(@"No stall is expected");
+        }
+    }];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTestExpectation *seekFinishedExpectation = [self expectationWithDescription:@"Seek finished"];
+    
+    [self.mediaPlayerController seekToPosition:[SRGPosition positionAtTimeInSeconds:300.] withCompletionHandler:^(BOOL finished) {
+        [seekFinishedExpectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self expectationForElapsedTimeInterval:3. withHandler:nil];
+    
+    [self waitForExpectationsWithTimeout:30. handler:^(NSError * _Nullable error) {
+        [NSNotificationCenter.defaultCenter removeObserver:playbackStateObserver];
+    }];
+    
+    XCTAssertEqual(self.mediaPlayerController.playbackState, SRGMediaPlayerPlaybackStatePlaying);
+    
+    SRGMediaPlayerMetrics *metrics = self.mediaPlayerController.metrics;
+    XCTAssertEqual(metrics.stallCount, 0);
+    XCTAssertEqual(metrics.stallDuration, 0.);
+    XCTAssertNil(self.mediaPlayerController.lastStallStartDate);
+}
+
+- (void)testWaitStallRecovery
+{
+    self.mediaPlayerController.stallRecoveryPolicy = SRGMediaPlayerStallRecoveryPolicyWait;
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePaused;
+    }];
+    
+    [self.mediaPlayerController pause];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Playback does not move while stalled. Nothing must be attempted to resume it
+    id playbackStateObserver = [NSNotificationCenter.defaultCenter addObserverForName:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController queue:nil usingBlock:^(NSNotification * _Nonnull notification) {
+        XCTFail(@"No playback state change is expected");
+    }];
+    
+    [self expectationForElapsedTimeInterval:3. withHandler:nil];
+    
+    [self.mediaPlayerController recoverFromStall];
+    
+    [self waitForExpectationsWithTimeout:30. handler:^(NSError * _Nullable error) {
+        [NSNotificationCenter.defaultCenter removeObserver:playbackStateObserver];
+    }];
+}
+
+- (void)testNudgeStallRecovery
+{
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePaused;
+    }];
+    
+    [self.mediaPlayerController pause];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // The player is asked to resume playback immediately
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController recoverFromStall];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+}
+
+- (void)testLowerBitrateStallRecovery
+{
+    self.mediaPlayerController.stallRecoveryPolicy = SRGMediaPlayerStallRecoveryPolicyLowerBitrate;
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Wait until a variant is played
+    [self expectationForElapsedTimeInterval:3. withHandler:nil];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    AVPlayerItem *playerItem = self.mediaPlayerController.player.currentItem;
+    double indicatedBitrate = playerItem.accessLog.events.lastObject.indicatedBitrate;
+    XCTAssertGreaterThan(indicatedBitrate, 0.);
+    XCTAssertEqual(playerItem.preferredPeakBitRate, 0.);
+    
+    // The peak bitrate is lowered further on each attempt
+    [self.mediaPlayerController recoverFromStall];
+    XCTAssertEqual(playerItem.preferredPeakBitRate, indicatedBitrate / 2.);
+    
+    [self.mediaPlayerController recoverFromStall];
+    XCTAssertEqual(playerItem.preferredPeakBitRate, indicatedBitrate / 4.);
+    
+    // The original value is restored once playback is stable
+    [self.mediaPlayerController restorePreferredPeakBitRate];
+    XCTAssertEqual(playerItem.preferredPeakBitRate, 0.);
+    
+    [self.mediaPlayerController restorePreferredPeakBitRate];
+    XCTAssertEqual(playerItem.preferredPeakBitRate, 0.);
+}
+
+- (void)testReloadStallRecovery
+{
+    self.mediaPlayerController.stallRecoveryPolicy = SRGMediaPlayerStallRecoveryPolicyReload;
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    SRGPosition *position = [SRGPosition positionAtTimeInSeconds:20.];
+    [self.mediaPlayerController playURL:OnDemandTestURL() atPosition:position withSegments:nil userInfo:nil];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    AVPlayer *player = self.mediaPlayerController.player;
+    AVPlayerItem *playerItem = player.currentItem;
+    NSTimeInterval prepareSystemUptime = self.mediaPlayerController.metrics.prepareSystemUptime;
+    
+    // The item is replaced on the same player, without the player or the media being created or prepared again
+    self.mediaPlayerController.playerCreationBlock = ^(AVPlayer * _Nonnull player) {
+        XCTFail(@"The player must be kept");
+    };
+    self.mediaPlayerController.playerDestructionBlock = ^(AVPlayer * _Nonnull player) {
+        XCTFail(@"The player must be kept");
+    };
+    
+    id playbackStateObserver = [NSNotificationCenter.defaultCenter addObserverForName:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController queue:nil usingBlock:^(NSNotification * _Nonnull notification) {
+        SRGMediaPlayerPlaybackState playbackState = [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue];
+        if (playbackState == SRGMediaPlayerPlaybackStatePreparing || playbackState == SRGMediaPlayerPlaybackStateIdle) {
+            XCTFail(@"The playback session must be kept");
+        }
+    }];
+    
+    [self expectationForElapsedTimeInterval:5. withHandler:nil];
+    
+    [self.mediaPlayerController recoverFromStall];
+    XCTAssertEqual(self.mediaPlayerController.player, player);
+    XCTAssertNotEqual(self.mediaPlayerController.player.currentItem, playerItem);
+    
+    [self waitForExpectationsWithTimeout:30. handler:^(NSError * _Nullable error) {
+        [NSNotificationCenter.defaultCenter removeObserver:playbackStateObserver];
+    }];
+    
+    // Playback resumes from the current position, with the same session and initial values
+    XCTAssertEqual(self.mediaPlayerController.playbackState, SRGMediaPlayerPlaybackStatePlaying);
+    XCTAssertNotEqual(self.mediaPlayerController.player.rate, 0.f);
+    XCTAssertGreaterThanOrEqual(CMTimeGetSeconds(self.mediaPlayerController.currentTime), 20.);
+    XCTAssertEqual(self.mediaPlayerController.metrics.prepareSystemUptime, prepareSystemUptime);
+    XCTAssertEqualObjects(self.mediaPlayerController.contentURL, OnDemandTestURL());
+    
+    self.mediaPlayerController.playerCreationBlock = nil;
+    self.mediaPlayerController.playerDestructionBlock = nil;
+}
+
 - (void)testPlaybackStateKeyValueObserving
 {
     [self keyValueObservingExpectationForObject:self.mediaPlayerController keyPath:@keypath(SRGMediaPlayerController.new, playbackState) expectedValue:@(SRGMediaPlayerPlaybackStatePreparing)];
@@ -2952,6 +3415,132 @@ static NSURL *AudioOverHTTPTestURL(void)
     }];
 }
 
+- (void)testPeriodicTimeObserversWithDifferentIntervals
+{
+    [self expectationForElapsedTimeInterval:5. withHandler:nil];
+    
+    NSMutableArray<NSString *> *events = [NSMutableArray array];
+    
+    id fastPeriodicTimeObserver = [self.mediaPlayerController addPeriodicTimeObserverForInterval:CMTimeMakeWithSeconds(0.5, NSEC_PER_SEC) queue:NULL usingBlock:^(CMTime time) {
+        [events addObject:@"fast"];
+    }];
+    id slowPeriodicTimeObserver = [self.mediaPlayerController addPeriodicTimeObserverForInterval:CMTimeMakeWithSeconds(2., NSEC_PER_SEC) queue:NULL usingBlock:^(CMTime time) {
+        [events addObject:@"slow"];
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:^(NSError * _Nullable error) {
+        [self.mediaPlayerController removePeriodicTimeObserver:fastPeriodicTimeObserver];
+        [self.mediaPlayerController removePeriodicTimeObserver:slowPeriodicTimeObserver];
+    }];
+    
+    NSUInteger fastCount = [events indexesOfObjectsPassingTest:^BOOL(NSString * _Nonnull event, NSUInteger idx, BOOL * _Nonnull stop) {
+        return [event isEqualToString:@"fast"];
+    }].count;
+    NSUInteger slowCount = events.count - fastCount;
+    XCTAssertTrue(slowCount > 0);
+    XCTAssertTrue(fastCount > slowCount);
+    
+    // Both observers are driven by the same clock and always executed in registration order
+    [events enumerateObjectsUsingBlock:^(NSString * _Nonnull event, NSUInteger idx, BOOL * _Nonnull stop) {
+        if ([event isEqualToString:@"slow"]) {
+            XCTAssertTrue(idx > 0 && [events[idx - 1] isEqualToString:@"fast"]);
+        }
+    }];
+}
+
+- (void)testPeriodicTimeObserverRemovedTwice
+{
+    XCTestExpectation *observerExpectation = [self expectationWithDescription:@"Periodic time observer fired"];
+    
+    id removedPeriodicTimeObserver = [self.mediaPlayerController addPeriodicTimeObserverForInterval:CMTimeMakeWithSeconds(1., NSEC_PER_SEC) queue:NULL usingBlock:^(CMTime time) {
+        XCTFail(@"Removed periodic time observers must not be fired");
+    }];
+    [self.mediaPlayerController removePeriodicTimeObserver:removedPeriodicTimeObserver];
+    
+    __block id periodicTimeObserver = nil;
+    
+    @weakify(self)
+    periodicTimeObserver = [self.mediaPlayerController addPeriodicTimeObserverForInterval:CMTimeMakeWithSeconds(1., NSEC_PER_SEC) queue:NULL usingBlock:^(CMTime time) {
+        @strongify(self)
+        [observerExpectation fulfill];
+        
+        // Do not fulfill the expectation more than once
+        [self.mediaPlayerController removePeriodicTimeObserver:periodicTimeObserver];
+    }];
+    XCTAssertNotEqualObjects(periodicTimeObserver, removedPeriodicTimeObserver);
+    
+    // The stale observer must not remove the observer which might have been registered in its place
+    [self.mediaPlayerController removePeriodicTimeObserver:removedPeriodicTimeObserver];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+}
+
+- (void)testRefreshFrequency
+{
+    XCTAssertEqual(self.mediaPlayerController.refreshFrequency, SRGMediaPlayerRefreshFrequencyNone);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // No user interface is attached
+    XCTAssertEqual(self.mediaPlayerController.refreshFrequency, SRGMediaPlayerRefreshFrequencyLow);
+    
+    [self keyValueObservingExpectationForObject:self.mediaPlayerController keyPath:@keypath(SRGMediaPlayerController.new, refreshFrequency) expectedValue:@(SRGMediaPlayerRefreshFrequencyNormal)];
+    
+    UIWindow *window = [[UIWindow alloc] initWithFrame:CGRectMake(0.f, 0.f, 320.f, 180.f)];
+    [window addSubview:self.mediaPlayerController.view];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // Nothing changes while an on-demand stream is paused
+    [self keyValueObservingExpectationForObject:self.mediaPlayerController keyPath:@keypath(SRGMediaPlayerController.new, refreshFrequency) expectedValue:@(SRGMediaPlayerRefreshFrequencyNone)];
+    
+    [self.mediaPlayerController pause];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self keyValueObservingExpectationForObject:self.mediaPlayerController keyPath:@keypath(SRGMediaPlayerController.new, refreshFrequency) expectedValue:@(SRGMediaPlayerRefreshFrequencyNormal)];
+    
+    [self.mediaPlayerController play];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self keyValueObservingExpectationForObject:self.mediaPlayerController keyPath:@keypath(SRGMediaPlayerController.new, refreshFrequency) expectedValue:@(SRGMediaPlayerRefreshFrequencyNone)];
+    
+    [self.mediaPlayerController reset];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    [self.mediaPlayerController.view removeFromSuperview];
+}
+
+- (void)testLivestreamRefreshFrequencyWhenPaused
+{
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:DVRTimestampTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // The DVR window keeps sliding while paused
+    [self keyValueObservingExpectationForObject:self.mediaPlayerController keyPath:@keypath(SRGMediaPlayerController.new, refreshFrequency) expectedValue:@(SRGMediaPlayerRefreshFrequencyLow)];
+    
+    [self.mediaPlayerController pause];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+}
+
 - (void)testDVRStreamDateMonotony
 {
     [self expectationForElapsedTimeInterval:20. withHandler:nil];
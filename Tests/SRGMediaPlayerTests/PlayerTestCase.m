@@ -0,0 +1,151 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+#import "TestMacros.h"
+
+@import libextobjc;
+
+// Private framework header
+#import "SRGPlayer.h"
+
+static NSURL *OnDemandTestURL(void)
+{
+    return [NSURL URLWithString:@"https://devstreaming-cdn.apple.com/videos/streaming/examples/bipbop_16x9/bipbop_16x9_variant.m3u8"];
+}
+
+@interface PlayerTestCase : MediaPlayerBaseTestCase <SRGPlayerDelegate>
+
+@property (nonatomic) SRGPlayer *player;
+
+// Delegate events received so far, in order, as "will <sequence number>" or "did <sequence number>"
+@property (nonatomic) NSMutableArray<NSString *> *events;
+
+@property (nonatomic, copy) void (^didSeekHandler)(NSUInteger sequenceNumber);
+
+@end
+
+@implementation PlayerTestCase
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.events = [NSMutableArray array];
+    
+    self.player = [SRGPlayer playerWithURL:OnDemandTestURL()];
+    self.player.delegate = self;
+}
+
+- (void)tearDown
+{
+    self.player = nil;
+    self.events = nil;
+    self.didSeekHandler = nil;
+}
+
+#pragma mark SRGPlayerDelegate protocol
+
+- (void)player:(SRGPlayer *)player willSeekToTime:(CMTime)time sequenceNumber:(NSUInteger)sequenceNumber
+{
+    XCTAssertTrue(NSThread.isMainThread);
+    [self.events addObject:[NSString stringWithFormat:@"will %@", @(sequenceNumber)]];
+}
+
+- (void)player:(SRGPlayer *)player didSeekToTime:(CMTime)time sequenceNumber:(NSUInteger)sequenceNumber
+{
+    XCTAssertTrue(NSThread.isMainThread);
+    [self.events addObject:[NSString stringWithFormat:@"did %@", @(sequenceNumber)]];
+    
+    if (self.didSeekHandler) {
+        self.didSeekHandler(sequenceNumber);
+    }
+}
+
+#pragma mark Tests
+
+- (void)testSeekFromBackgroundThread
+{
+    [self keyValueObservingExpectationForObject:self.player.currentItem keyPath:@keypath(AVPlayerItem.new, status) expectedValue:@(AVPlayerItemStatusReadyToPlay)];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    static const NSUInteger kSeekCount = 5;
+    
+    XCTestExpectation *seekFinishedExpectation = [self expectationWithDescription:@"Seek finished"];
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        for (NSUInteger i = 0; i < kSeekCount; ++i) {
+            CMTime time = CMTimeMakeWithSeconds(10. * (i + 1), NSEC_PER_SEC);
+            [self.player seekToTime:time toleranceBefore:kCMTimeZero toleranceAfter:kCMTimeZero completionHandler:^(BOOL finished) {
+                if (i == kSeekCount - 1) {
+                    XCTAssertTrue(finished);
+                    [seekFinishedExpectation fulfill];
+                }
+            }];
+        }
+    });
+    
+    XCTestExpectation *didSeekExpectation = [self expectationWithDescription:@"Did seek"];
+    self.didSeekHandler = ^(NSUInteger sequenceNumber) {
+        if (sequenceNumber == kSeekCount) {
+            [didSeekExpectation fulfill];
+        }
+    };
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    // All will seek events must have been received in request order, each did seek event after the corresponding
+    // will seek event
+    NSMutableArray<NSString *> *willEvents = [NSMutableArray array];
+    for (NSUInteger sequenceNumber = 1; sequenceNumber <= kSeekCount; ++sequenceNumber) {
+        NSString *willEvent = [NSString stringWithFormat:@"will %@", @(sequenceNumber)];
+        [willEvents addObject:willEvent];
+        
+        NSUInteger didIndex = [self.events indexOfObject:[NSString stringWithFormat:@"did %@", @(sequenceNumber)]];
+        if (didIndex != NSNotFound) {
+            XCTAssertLessThan([self.events indexOfObject:willEvent], didIndex);
+        }
+    }
+    
+    NSPredicate *willPredicate = [NSPredicate predicateWithFormat:@"SELF BEGINSWITH 'will'"];
+    XCTAssertEqualObjects([self.events filteredArrayUsingPredicate:willPredicate], willEvents);
+    XCTAssertEqualObjects(self.events.lastObject, ([NSString stringWithFormat:@"did %@", @(kSeekCount)]));
+    
+    TestAssertIndefiniteTime(self.player.seekStartTime);
+    TestAssertIndefiniteTime(self.player.seekTargetTime);
+}
+
+- (void)testSeekTimesFromBackgroundThread
+{
+    [self keyValueObservingExpectationForObject:self.player.currentItem keyPath:@keypath(AVPlayerItem.new, status) expectedValue:@(AVPlayerItemStatusReadyToPlay)];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTestExpectation *seekFinishedExpectation = [self expectationWithDescription:@"Seek finished"];
+    
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [self.player seekToTime:CMTimeMakeWithSeconds(30., NSEC_PER_SEC) toleranceBefore:kCMTimeZero toleranceAfter:kCMTimeZero completionHandler:^(BOOL finished) {
+            XCTAssertTrue(finished);
+            [seekFinishedExpectation fulfill];
+        }];
+    });
+    
+    // Seek times must still be available when the completion is delivered, even asynchronously
+    XCTestExpectation *didSeekExpectation = [self expectationWithDescription:@"Did seek"];
+    self.didSeekHandler = ^(NSUInteger sequenceNumber) {
+        TestAssertEqualTimeInSeconds(self.player.seekStartTime, 0);
+        TestAssertEqualTimeInSeconds(self.player.seekTargetTime, 30);
+        [didSeekExpectation fulfill];
+    };
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    TestAssertIndefiniteTime(self.player.seekStartTime);
+    TestAssertIndefiniteTime(self.player.seekTargetTime);
+}
+
+@end
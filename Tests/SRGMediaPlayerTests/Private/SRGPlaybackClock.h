@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlaybackClock.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlaybackHistogram.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlaybackInformation.h
\ No newline at end of file
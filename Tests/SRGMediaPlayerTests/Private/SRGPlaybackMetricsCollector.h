@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlaybackMetricsCollector.h
\ No newline at end of file
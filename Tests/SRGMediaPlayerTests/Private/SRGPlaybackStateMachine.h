@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlaybackStateMachine.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlaybackTrace.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGPlayer.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGSeekScheduler.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGSegmentDiff.h
\ No newline at end of file
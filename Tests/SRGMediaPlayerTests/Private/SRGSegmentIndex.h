@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGSegmentIndex.h
\ No newline at end of file
@@ -0,0 +1 @@
+../../../Sources/SRGMediaPlayer/SRGTimeDateMapping.h
\ No newline at end of file
@@ -0,0 +1,206 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+
+// Private framework header
+#import "SRGSeekScheduler.h"
+
+@interface SeekSchedulerTestCase : MediaPlayerBaseTestCase
+
+@property (nonatomic) SRGSeekScheduler *seekScheduler;
+
+// Completion handlers of the seeks performed so far, in order
+@property (nonatomic) NSMutableArray<void (^)(BOOL)> *seekCompletionHandlers;
+
+// Results of the scheduled seeks, by name
+@property (nonatomic) NSMutableDictionary<NSString *, NSNumber *> *results;
+
+@end
+
+@implementation SeekSchedulerTestCase
+
+#pragma mark Helpers
+
+- (void)scheduleSeekWithName:(NSString *)name
+{
+    [self.seekScheduler scheduleSeek:^(void (^completionHandler)(BOOL)) {
+        [self.seekCompletionHandlers addObject:completionHandler];
+    } withCompletionHandler:^(BOOL finished) {
+        XCTAssertNil(self.results[name], @"Completion handlers must be called once");
+        self.results[name] = @(finished);
+    }];
+}
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.seekScheduler = [[SRGSeekScheduler alloc] init];
+    self.seekCompletionHandlers = [NSMutableArray array];
+    self.results = [NSMutableDictionary dictionary];
+}
+
+#pragma mark Tests
+
+- (void)testSingleSeek
+{
+    [self scheduleSeekWithName:@"A"];
+    XCTAssertTrue(self.seekScheduler.seekInFlight);
+    XCTAssertFalse(self.seekScheduler.hasPendingSeek);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 1);
+    
+    self.seekCompletionHandlers[0](YES);
+    XCTAssertFalse(self.seekScheduler.seekInFlight);
+    XCTAssertEqualObjects(self.results, @{ @"A" : @YES });
+}
+
+- (void)testCoalescing
+{
+    [self scheduleSeekWithName:@"A"];
+    [self scheduleSeekWithName:@"B"];
+    [self scheduleSeekWithName:@"C"];
+    [self scheduleSeekWithName:@"D"];
+    
+    // Intermediate targets are dropped immediately
+    XCTAssertEqual(self.seekCompletionHandlers.count, 1);
+    XCTAssertTrue(self.seekScheduler.hasPendingSeek);
+    XCTAssertEqualObjects(self.results, (@{ @"B" : @NO, @"C" : @NO }));
+    
+    // The pending seek is performed when the seek in flight finishes
+    self.seekCompletionHandlers[0](YES);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 2);
+    XCTAssertTrue(self.seekScheduler.seekInFlight);
+    XCTAssertFalse(self.seekScheduler.hasPendingSeek);
+    
+    self.seekCompletionHandlers[1](YES);
+    XCTAssertFalse(self.seekScheduler.seekInFlight);
+    XCTAssertEqualObjects(self.results, (@{ @"A" : @YES, @"B" : @NO, @"C" : @NO, @"D" : @YES }));
+}
+
+- (void)testCancelledSeekInFlight
+{
+    [self scheduleSeekWithName:@"A"];
+    [self scheduleSeekWithName:@"B"];
+    
+    self.seekCompletionHandlers[0](NO);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 1);
+    XCTAssertFalse(self.seekScheduler.seekInFlight);
+    XCTAssertEqualObjects(self.results, (@{ @"A" : @NO, @"B" : @NO }));
+}
+
+- (void)testReset
+{
+    [self scheduleSeekWithName:@"A"];
+    [self scheduleSeekWithName:@"B"];
+    
+    [self.seekScheduler reset];
+    XCTAssertFalse(self.seekScheduler.seekInFlight);
+    XCTAssertEqualObjects(self.results, @{ @"B" : @NO });
+    
+    // New seeks are not blocked by the seek previously in flight, whose completion does not affect the scheduler
+    [self scheduleSeekWithName:@"C"];
+    XCTAssertEqual(self.seekCompletionHandlers.count, 2);
+    
+    self.seekCompletionHandlers[0](NO);
+    XCTAssertTrue(self.seekScheduler.seekInFlight);
+    
+    self.seekCompletionHandlers[1](YES);
+    XCTAssertEqualObjects(self.results, (@{ @"A" : @NO, @"B" : @NO, @"C" : @YES }));
+}
+
+- (void)testSeekFromCompletionHandler
+{
+    [self.seekScheduler scheduleSeek:^(void (^completionHandler)(BOOL)) {
+        [self.seekCompletionHandlers addObject:completionHandler];
+    } withCompletionHandler:^(BOOL finished) {
+        [self scheduleSeekWithName:@"C"];
+    }];
+    [self scheduleSeekWithName:@"B"];
+    
+    // B is performed before the completion handler of the first seek is called. C is then pending.
+    self.seekCompletionHandlers[0](YES);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 2);
+    XCTAssertTrue(self.seekScheduler.hasPendingSeek);
+    
+    self.seekCompletionHandlers[1](YES);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 3);
+    
+    self.seekCompletionHandlers[2](YES);
+    XCTAssertEqualObjects(self.results, (@{ @"B" : @YES, @"C" : @YES }));
+}
+
+- (void)testSeekFromDroppedSeekCompletionHandler
+{
+    [self scheduleSeekWithName:@"A"];
+    [self.seekScheduler scheduleSeek:^(void (^completionHandler)(BOOL)) {
+        [self.seekCompletionHandlers addObject:completionHandler];
+    } withCompletionHandler:^(BOOL finished) {
+        XCTAssertFalse(finished);
+        [self scheduleSeekWithName:@"D"];
+    }];
+    
+    // B is dropped when C is scheduled. The seek scheduled from its completion handler replaces C, which is dropped
+    // in turn, instead of being lost.
+    [self scheduleSeekWithName:@"C"];
+    XCTAssertTrue(self.seekScheduler.hasPendingSeek);
+    XCTAssertEqualObjects(self.results, @{ @"C" : @NO });
+    
+    self.seekCompletionHandlers[0](YES);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 2);
+    
+    self.seekCompletionHandlers[1](YES);
+    XCTAssertFalse(self.seekScheduler.seekInFlight);
+    XCTAssertEqualObjects(self.results, (@{ @"A" : @YES, @"C" : @NO, @"D" : @YES }));
+}
+
+- (void)testSeekFromResetDroppedSeekCompletionHandler
+{
+    [self scheduleSeekWithName:@"A"];
+    [self.seekScheduler scheduleSeek:^(void (^completionHandler)(BOOL)) {
+        [self.seekCompletionHandlers addObject:completionHandler];
+    } withCompletionHandler:^(BOOL finished) {
+        [self scheduleSeekWithName:@"C"];
+    }];
+    
+    // The seek scheduled when B is dropped is performed immediately, since A is not waited for anymore
+    [self.seekScheduler reset];
+    XCTAssertEqual(self.seekCompletionHandlers.count, 2);
+    XCTAssertTrue(self.seekScheduler.seekInFlight);
+    XCTAssertFalse(self.seekScheduler.hasPendingSeek);
+    
+    self.seekCompletionHandlers[1](YES);
+    XCTAssertEqualObjects(self.results, @{ @"C" : @YES });
+}
+
+- (void)testImmediateSeek
+{
+    [self scheduleSeekWithName:@"A"];
+    [self scheduleSeekWithName:@"B"];
+    
+    // The pending seek is dropped and the seek in flight superseded
+    [self.seekScheduler performSeekImmediately:^(void (^completionHandler)(BOOL)) {
+        [self.seekCompletionHandlers addObject:completionHandler];
+    } withCompletionHandler:^(BOOL finished) {
+        self.results[@"C"] = @(finished);
+    }];
+    XCTAssertEqual(self.seekCompletionHandlers.count, 2);
+    XCTAssertTrue(self.seekScheduler.seekInFlight);
+    XCTAssertEqualObjects(self.results, @{ @"B" : @NO });
+    
+    // Seeks scheduled afterwards are coalesced behind the immediate seek, unaffected by the superseded one
+    [self scheduleSeekWithName:@"D"];
+    self.seekCompletionHandlers[0](NO);
+    XCTAssertTrue(self.seekScheduler.hasPendingSeek);
+    
+    self.seekCompletionHandlers[1](YES);
+    XCTAssertEqual(self.seekCompletionHandlers.count, 3);
+    
+    self.seekCompletionHandlers[2](YES);
+    XCTAssertEqualObjects(self.results, (@{ @"A" : @NO, @"B" : @NO, @"C" : @YES, @"D" : @YES }));
+}
+
+@end
@@ -15,6 +15,8 @@ NS_ASSUME_NONNULL_BEGIN
 + (Segment *)blockedSegmentWithTimeRange:(CMTimeRange)timeRange;
 + (Segment *)hiddenSegmentWithTimeRange:(CMTimeRange)timeRange;
 
++ (Segment *)segmentWithTimeRange:(CMTimeRange)timeRange childSegments:(NSArray<Segment *> *)childSegments;
+
 + (Segment *)segmentFromDate:(NSDate *)fromDate toDate:(NSDate *)toDate;
 
 @end
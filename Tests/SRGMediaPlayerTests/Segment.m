@@ -11,6 +11,7 @@
 @property (nonatomic) SRGMarkRange *srg_markRange;
 @property (nonatomic, getter=srg_isBlocked) BOOL srg_blocked;
 @property (nonatomic, getter=srg_isHidden) BOOL srg_hidden;
+@property (nonatomic) NSArray<id<SRGSegment>> *srg_childSegments;
 
 @end
 
@@ -45,6 +46,14 @@
     return segment;
 }
 
++ (Segment *)segmentWithTimeRange:(CMTimeRange)timeRange childSegments:(NSArray<Segment *> *)childSegments
+{
+    SRGMarkRange *markRange = [SRGMarkRange rangeFromTimeRange:timeRange];
+    Segment *segment = [self segmentWithMarkRange:markRange];
+    segment.srg_childSegments = childSegments;
+    return segment;
+}
+
 + (Segment *)segmentFromDate:(NSDate *)fromDate toDate:(NSDate *)toDate
 {
     SRGMarkRange *markRange = [SRGMarkRange rangeFromDate:fromDate toDate:toDate];
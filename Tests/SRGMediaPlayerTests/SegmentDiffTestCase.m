@@ -0,0 +1,156 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+#import "Segment.h"
+
+@import SRGMediaPlayer;
+
+// Private framework header
+#import "SRGSegmentDiff.h"
+
+static Segment *SegmentAtTimeInSeconds(NSTimeInterval seconds)
+{
+    return [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(seconds, NSEC_PER_SEC), CMTimeMakeWithSeconds(1., NSEC_PER_SEC))];
+}
+
+@interface SegmentDiffTestCase : MediaPlayerBaseTestCase
+
+@end
+
+@implementation SegmentDiffTestCase
+
+#pragma mark Tests
+
+- (void)testIdenticalLists
+{
+    Segment *segment1 = SegmentAtTimeInSeconds(1.);
+    Segment *segment2 = SegmentAtTimeInSeconds(2.);
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:@[ segment1, segment2 ] segments:@[ segment1, segment2 ]];
+    XCTAssertFalse(segmentDiff.hasChanges);
+}
+
+- (void)testInsertionsAndRemovals
+{
+    Segment *segment1 = SegmentAtTimeInSeconds(1.);
+    Segment *segment2 = SegmentAtTimeInSeconds(2.);
+    Segment *segment3 = SegmentAtTimeInSeconds(3.);
+    Segment *segment4 = SegmentAtTimeInSeconds(4.);
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:@[ segment1, segment2, segment3 ] segments:@[ segment2, segment3, segment4 ]];
+    
+    XCTAssertTrue(segmentDiff.hasChanges);
+    XCTAssertEqualObjects(segmentDiff.removedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(segmentDiff.insertedIndexes, [NSIndexSet indexSetWithIndex:2]);
+    XCTAssertEqual(segmentDiff.updatedIndexes.count, 0);
+    XCTAssertEqual(segmentDiff.movedIndexes.count, 0);
+}
+
+- (void)testMoves
+{
+    Segment *segment1 = SegmentAtTimeInSeconds(1.);
+    Segment *segment2 = SegmentAtTimeInSeconds(2.);
+    Segment *segment3 = SegmentAtTimeInSeconds(3.);
+    Segment *segment4 = SegmentAtTimeInSeconds(4.);
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:@[ segment1, segment2, segment3, segment4 ] segments:@[ segment4, segment1, segment2, segment3 ]];
+    
+    // A single move is sufficient
+    XCTAssertEqual(segmentDiff.insertedIndexes.count, 0);
+    XCTAssertEqual(segmentDiff.removedIndexes.count, 0);
+    XCTAssertEqualObjects(segmentDiff.movedIndexes, @{ @3 : @0 });
+}
+
+- (void)testUpdates
+{
+    CMTimeRange timeRange = CMTimeRangeMake(CMTimeMakeWithSeconds(1., NSEC_PER_SEC), CMTimeMakeWithSeconds(1., NSEC_PER_SEC));
+    Segment *segment = [Segment segmentWithTimeRange:timeRange];
+    Segment *blockedSegment = [Segment blockedSegmentWithTimeRange:timeRange];
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:@[ segment ] segments:@[ blockedSegment ]];
+    
+    XCTAssertEqualObjects(segmentDiff.updatedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqual(segmentDiff.insertedIndexes.count, 0);
+    XCTAssertEqual(segmentDiff.removedIndexes.count, 0);
+    
+    XCTAssertNil([segmentDiff segmentEqualToSegment:segment]);
+    XCTAssertEqual([segmentDiff segmentEqualToSegment:[Segment blockedSegmentWithTimeRange:timeRange]], blockedSegment);
+}
+
+- (void)testRecreatedSegments
+{
+    // Segments recreated with the same mark range and status are updated in place, so that the new objects are used
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:@[ SegmentAtTimeInSeconds(1.), SegmentAtTimeInSeconds(2.) ]
+                                                                          segments:@[ SegmentAtTimeInSeconds(1.), SegmentAtTimeInSeconds(2.) ]];
+    XCTAssertTrue(segmentDiff.hasChanges);
+    XCTAssertEqualObjects(segmentDiff.updatedIndexes, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+    XCTAssertEqual(segmentDiff.insertedIndexes.count, 0);
+    XCTAssertEqual(segmentDiff.removedIndexes.count, 0);
+    XCTAssertEqual(segmentDiff.movedIndexes.count, 0);
+}
+
+- (void)testUpdatesAndMoves
+{
+    CMTimeRange timeRange = CMTimeRangeMake(CMTimeMakeWithSeconds(3., NSEC_PER_SEC), CMTimeMakeWithSeconds(1., NSEC_PER_SEC));
+    Segment *segment1 = SegmentAtTimeInSeconds(1.);
+    Segment *segment2 = SegmentAtTimeInSeconds(2.);
+    SRGSegmentDiff *segmentDiff = [[SRGSegmentDiff alloc] initWithPreviousSegments:@[ segment1, segment2, [Segment segmentWithTimeRange:timeRange] ]
+                                                                          segments:@[ [Segment blockedSegmentWithTimeRange:timeRange], segment1, segment2 ]];
+    
+    XCTAssertEqualObjects(segmentDiff.updatedIndexes, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(segmentDiff.movedIndexes, @{ @2 : @0 });
+}
+
+- (void)testNotifications
+{
+    Segment *segment1 = SegmentAtTimeInSeconds(1.);
+    Segment *segment2 = [Segment hiddenSegmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(2., NSEC_PER_SEC), CMTimeMakeWithSeconds(1., NSEC_PER_SEC))];
+    
+    SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+    mediaPlayerController.segments = @[ segment1 ];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerSegmentsDidChangeNotification object:mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerInsertedIndexesKey], [NSIndexSet indexSetWithIndex:1]);
+        return YES;
+    }];
+    
+    // Hidden segments are not visible
+    id visibleSegmentsObserver = [NSNotificationCenter.defaultCenter addObserverForName:SRGMediaPlayerVisibleSegmentsDidChangeNotification object:mediaPlayerController queue:nil usingBlock:^(NSNotification * _Nonnull notification) {
+        XCTFail(@"Visible segments must not change");
+    }];
+    
+    mediaPlayerController.segments = @[ segment1, segment2 ];
+    
+    [self waitForExpectationsWithTimeout:5. handler:^(NSError * _Nullable error) {
+        [NSNotificationCenter.defaultCenter removeObserver:visibleSegmentsObserver];
+    }];
+}
+
+- (void)testRecreatedSegmentsNotifications
+{
+    SRGMediaPlayerController *mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+    mediaPlayerController.segments = @[ SegmentAtTimeInSeconds(1.), SegmentAtTimeInSeconds(2.) ];
+    
+    NSArray<Segment *> *segments = @[ SegmentAtTimeInSeconds(1.), SegmentAtTimeInSeconds(2.) ];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerSegmentsDidChangeNotification object:mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerUpdatedIndexesKey], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+        XCTAssertEqual([notification.userInfo[SRGMediaPlayerInsertedIndexesKey] count], 0);
+        XCTAssertEqual([notification.userInfo[SRGMediaPlayerRemovedIndexesKey] count], 0);
+        return YES;
+    }];
+    [self expectationForSingleNotification:SRGMediaPlayerVisibleSegmentsDidChangeNotification object:mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerUpdatedIndexesKey], [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+        
+        // Observers must find the new segment objects
+        XCTAssertEqual(mediaPlayerController.visibleSegments.firstObject, segments.firstObject);
+        XCTAssertEqual(mediaPlayerController.visibleSegments.lastObject, segments.lastObject);
+        return YES;
+    }];
+    
+    mediaPlayerController.segments = segments;
+    
+    [self waitForExpectationsWithTimeout:5. handler:nil];
+}
+
+@end
@@ -0,0 +1,224 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+#import "Segment.h"
+
+@import SRGMediaPlayer;
+
+// Private framework header
+#import "SRGSegmentIndex.h"
+
+static SRGSegmentIndex *SegmentIndexWithSegments(NSArray<id<SRGSegment>> *segments)
+{
+    NSMutableArray<NSValue *> *timeRanges = [NSMutableArray array];
+    NSMutableArray<id<SRGSegment>> *childSegments = [NSMutableArray array];
+    for (id<SRGSegment> segment in segments) {
+        [timeRanges addObject:[NSValue valueWithCMTimeRange:[segment.srg_markRange timeRangeForMediaPlayerController:nil]]];
+        if ([segment respondsToSelector:@selector(srg_childSegments)]) {
+            [childSegments addObjectsFromArray:segment.srg_childSegments];
+        }
+    }
+    SRGSegmentIndex *childSegmentIndex = (childSegments.count != 0) ? SegmentIndexWithSegments(childSegments.copy) : nil;
+    return [[SRGSegmentIndex alloc] initWithSegments:segments timeRanges:timeRanges.copy childSegmentIndex:childSegmentIndex];
+}
+
+static CMTime TimeInSeconds(NSTimeInterval seconds)
+{
+    return CMTimeMakeWithSeconds(seconds, NSEC_PER_SEC);
+}
+
+@interface SegmentIndexTestCase : MediaPlayerBaseTestCase
+
+@end
+
+@implementation SegmentIndexTestCase
+
+#pragma mark Tests
+
+- (void)testEmptyIndex
+{
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[]);
+    XCTAssertNil([segmentIndex segmentForTime:kCMTimeZero]);
+    XCTAssertNil([segmentIndex segmentForTime:TimeInSeconds(10.)]);
+    XCTAssertNil([segmentIndex segmentForTime:kCMTimeInvalid]);
+}
+
+- (void)testDisjointSegments
+{
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(3.))];
+    Segment *segment2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(3.))];
+    Segment *segment3 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(8.), TimeInSeconds(2.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment3, segment1, segment2 ]);
+    
+    XCTAssertNil([segmentIndex segmentForTime:TimeInSeconds(1.)]);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(2.)], segment1);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(4.9)], segment1);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(5.)], segment2);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(8.)], segment3);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(9.9)], segment3);
+    XCTAssertNil([segmentIndex segmentForTime:TimeInSeconds(10.)]);
+    XCTAssertNil([segmentIndex segmentForTime:TimeInSeconds(100.)]);
+}
+
+- (void)testOverlappingSegments
+{
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(10.))];
+    Segment *segment2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(0.), TimeInSeconds(20.))];
+    Segment *segment3 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(12.), TimeInSeconds(10.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment1, segment2, segment3 ]);
+    
+    // The first matching segment in list order wins
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(1.)], segment2);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(5.)], segment1);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(13.)], segment1);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(15.)], segment2);
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(21.)], segment3);
+    XCTAssertNil([segmentIndex segmentForTime:TimeInSeconds(22.)]);
+}
+
+- (void)testEmptySegments
+{
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), kCMTimeZero)];
+    Segment *segment2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(2.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment1, segment2 ]);
+    
+    XCTAssertEqual([segmentIndex segmentForTime:TimeInSeconds(5.)], segment2);
+}
+
+- (void)testBoundaryTimes
+{
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(3.))];
+    Segment *segment2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(3.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment1, segment2 ]);
+    
+    NSArray<NSValue *> *expectedBoundaryTimes = @[ [NSValue valueWithCMTime:TimeInSeconds(2.)], [NSValue valueWithCMTime:TimeInSeconds(5.)], [NSValue valueWithCMTime:TimeInSeconds(8.)] ];
+    XCTAssertEqualObjects(segmentIndex.boundaryTimes, expectedBoundaryTimes);
+    
+    XCTAssertEqual(CMTimeCompare([segmentIndex boundaryTimeAfterTime:TimeInSeconds(1.)], TimeInSeconds(2.)), 0);
+    XCTAssertEqual(CMTimeCompare([segmentIndex boundaryTimeAfterTime:TimeInSeconds(2.)], TimeInSeconds(5.)), 0);
+    XCTAssertEqual(CMTimeCompare([segmentIndex boundaryTimeAfterTime:TimeInSeconds(4.99)], TimeInSeconds(5.)), 0);
+    XCTAssertFalse(CMTIME_IS_VALID([segmentIndex boundaryTimeAfterTime:TimeInSeconds(8.)]));
+}
+
+- (void)testBlockedRuns
+{
+    Segment *segment1 = [Segment blockedSegmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(3.))];
+    Segment *segment2 = [Segment blockedSegmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(3.))];
+    Segment *segment3 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(8.), TimeInSeconds(2.))];
+    Segment *segment4 = [Segment blockedSegmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(10.), TimeInSeconds(2.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment2, segment1, segment3, segment4 ]);
+    
+    CMTimeRange blockedTimeRange = [segmentIndex blockedTimeRangeForTime:TimeInSeconds(3.)];
+    XCTAssertTrue(CMTimeRangeEqual(blockedTimeRange, CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(6.))));
+    XCTAssertEqualObjects([segmentIndex blockedSegmentsInTimeRange:blockedTimeRange], (@[ segment1, segment2 ]));
+    
+    XCTAssertFalse(CMTIMERANGE_IS_VALID([segmentIndex blockedTimeRangeForTime:TimeInSeconds(1.)]));
+    XCTAssertFalse(CMTIMERANGE_IS_VALID([segmentIndex blockedTimeRangeForTime:TimeInSeconds(9.)]));
+    XCTAssertTrue(CMTimeRangeEqual([segmentIndex blockedTimeRangeForTime:TimeInSeconds(11.)], CMTimeRangeMake(TimeInSeconds(10.), TimeInSeconds(2.))));
+}
+
+- (void)testBlockedRunsWithOverlappingSegments
+{
+    // The unblocked segment comes first and therefore wins where segments overlap
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(4.), TimeInSeconds(2.))];
+    Segment *segment2 = [Segment blockedSegmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(6.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment1, segment2 ]);
+    
+    XCTAssertTrue(CMTimeRangeEqual([segmentIndex blockedTimeRangeForTime:TimeInSeconds(3.)], CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(2.))));
+    XCTAssertFalse(CMTIMERANGE_IS_VALID([segmentIndex blockedTimeRangeForTime:TimeInSeconds(5.)]));
+    XCTAssertTrue(CMTimeRangeEqual([segmentIndex blockedTimeRangeForTime:TimeInSeconds(7.)], CMTimeRangeMake(TimeInSeconds(6.), TimeInSeconds(2.))));
+}
+
+- (void)testTimeRangeForSegment
+{
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(3.))];
+    Segment *segment2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(3.))];
+    Segment *segment3 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(3.))];
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ segment1, segment2 ]);
+    
+    XCTAssertTrue(CMTimeRangeEqual([segmentIndex timeRangeForSegment:segment1], CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(3.))));
+    XCTAssertTrue(CMTimeRangeEqual([segmentIndex timeRangeForSegment:segment2], CMTimeRangeMake(TimeInSeconds(5.), TimeInSeconds(3.))));
+    
+    // Segments are matched by identity
+    XCTAssertFalse(CMTIMERANGE_IS_VALID([segmentIndex timeRangeForSegment:segment3]));
+    XCTAssertFalse(segmentIndex.dateDependent);
+}
+
+- (void)testDateDependentIndex
+{
+    NSDate *date = NSDate.date;
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(3.))];
+    Segment *segment2 = [Segment segmentFromDate:date toDate:[date dateByAddingTimeInterval:10.]];
+    SRGSegmentIndex *segmentIndex = [[SRGSegmentIndex alloc] initWithSegments:@[ segment1, segment2 ]
+                                                                   timeRanges:@[ [NSValue valueWithCMTimeRange:[segment1.srg_markRange timeRangeForMediaPlayerController:nil]], [NSValue valueWithCMTimeRange:kCMTimeRangeZero] ]];
+    XCTAssertTrue(segmentIndex.dateDependent);
+}
+
+- (void)testSegmentChain
+{
+    Segment *highlight1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(2.), TimeInSeconds(2.))];
+    Segment *highlight2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(6.), TimeInSeconds(2.))];
+    Segment *chapter1 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(0.), TimeInSeconds(10.)) childSegments:@[ highlight1, highlight2 ]];
+    
+    Segment *highlight3 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(12.), TimeInSeconds(3.))];
+    Segment *chapter2 = [Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(10.), TimeInSeconds(10.)) childSegments:@[ highlight3 ]];
+    
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(@[ chapter1, chapter2 ]);
+    XCTAssertNotNil(segmentIndex.childSegmentIndex);
+    
+    XCTAssertEqualObjects([segmentIndex segmentChainForTime:TimeInSeconds(1.)], @[ chapter1 ]);
+    XCTAssertEqualObjects([segmentIndex segmentChainForTime:TimeInSeconds(3.)], (@[ chapter1, highlight1 ]));
+    XCTAssertEqualObjects([segmentIndex segmentChainForTime:TimeInSeconds(5.)], @[ chapter1 ]);
+    XCTAssertEqualObjects([segmentIndex segmentChainForTime:TimeInSeconds(7.)], (@[ chapter1, highlight2 ]));
+    XCTAssertEqualObjects([segmentIndex segmentChainForTime:TimeInSeconds(13.)], (@[ chapter2, highlight3 ]));
+    XCTAssertEqualObjects([segmentIndex segmentChainForTime:TimeInSeconds(25.)], @[]);
+    
+    XCTAssertEqual([segmentIndex parentSegmentForSegment:highlight2], chapter1);
+    XCTAssertEqual([segmentIndex parentSegmentForSegment:highlight3], chapter2);
+    XCTAssertNil([segmentIndex parentSegmentForSegment:chapter1]);
+    
+    XCTAssertTrue(CMTimeRangeEqual([segmentIndex timeRangeForSegment:highlight3], CMTimeRangeMake(TimeInSeconds(12.), TimeInSeconds(3.))));
+    
+    // Boundaries of all levels are merged
+    NSArray<NSValue *> *expectedBoundaryTimes = @[ [NSValue valueWithCMTime:TimeInSeconds(0.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(2.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(4.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(6.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(8.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(10.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(12.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(15.)],
+                                                   [NSValue valueWithCMTime:TimeInSeconds(20.)] ];
+    XCTAssertEqualObjects(segmentIndex.boundaryTimes, expectedBoundaryTimes);
+    XCTAssertEqual(CMTimeCompare([segmentIndex boundaryTimeAfterTime:TimeInSeconds(10.)], TimeInSeconds(12.)), 0);
+}
+
+- (void)testLinearLookupEquivalence
+{
+    NSMutableArray<id<SRGSegment>> *segments = [NSMutableArray array];
+    for (NSInteger i = 0; i < 500; ++i) {
+        NSTimeInterval start = arc4random_uniform(10000) / 10.;
+        NSTimeInterval duration = arc4random_uniform(200) / 10.;
+        [segments addObject:[Segment segmentWithTimeRange:CMTimeRangeMake(TimeInSeconds(start), TimeInSeconds(duration))]];
+    }
+    SRGSegmentIndex *segmentIndex = SegmentIndexWithSegments(segments.copy);
+    
+    for (NSInteger i = 0; i < 2000; ++i) {
+        CMTime time = TimeInSeconds(arc4random_uniform(10500) / 10.);
+        
+        id<SRGSegment> expectedSegment = nil;
+        for (id<SRGSegment> segment in segments) {
+            if (CMTimeRangeContainsTime([segment.srg_markRange timeRangeForMediaPlayerController:nil], time)) {
+                expectedSegment = segment;
+                break;
+            }
+        }
+        XCTAssertEqual([segmentIndex segmentForTime:time], expectedSegment);
+    }
+}
+
+@end
@@ -10,7 +10,9 @@
 
 @import SRGMediaPlayer;
 
-// Private framework header
+// Private framework headers
+#import "SRGMediaPlayerController+Private.h"
+#import "SRGPlayer.h"
 #import "SRGSegment+Private.h"
 
 OBJC_EXPORT BOOL SRGMediaPlayerAreEqualSegments(id<SRGSegment> segment1, id<SRGSegment> segment2);
@@ -90,6 +92,9 @@ static NSURL *SegmentsLiveTimestampTestURL(void)
     Segment *segment2 = [Segment hiddenSegmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(5., NSEC_PER_SEC), CMTimeMakeWithSeconds(4., NSEC_PER_SEC))];
     [self.mediaPlayerController playURL:SegmentsOnDemandTestURL() atPosition:nil withSegments:@[segment1, segment2] userInfo:nil];
     XCTAssertEqual(self.mediaPlayerController.visibleSegments.count, 1);
+    
+    XCTAssertEqual([self.mediaPlayerController visibleIndexForSegment:segment1], 0);
+    XCTAssertEqual([self.mediaPlayerController visibleIndexForSegment:segment2], NSNotFound);
 }
 
 - (void)testSegmentPlayback
@@ -365,6 +370,7 @@ static NSURL *SegmentsLiveTimestampTestURL(void)
     [self expectationForSingleNotification:SRGMediaPlayerWillSkipBlockedSegmentNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
         id<SRGSegment> segment = notification.userInfo[SRGMediaPlayerSegmentKey];
         XCTAssertEqualObjects(segment, segment1);
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerSkippedSegmentsKey], (@[ segment1, segment2 ]));
         TestAssertEqualTimeInSeconds([notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue], 2);
         XCTAssertFalse([notification.userInfo[SRGMediaPlayerSelectedKey] boolValue]);
         return YES;
@@ -373,6 +379,7 @@ static NSURL *SegmentsLiveTimestampTestURL(void)
     [self expectationForSingleNotification:SRGMediaPlayerDidSkipBlockedSegmentNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
         id<SRGSegment> segment = notification.userInfo[SRGMediaPlayerSegmentKey];
         XCTAssertEqualObjects(segment, segment1);
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerSkippedSegmentsKey], (@[ segment1, segment2 ]));
         TestAssertEqualTimeInSeconds([notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue], 2);
         XCTAssertFalse([notification.userInfo[SRGMediaPlayerSelectedKey] boolValue]);
         return YES;
@@ -605,6 +612,123 @@ static NSURL *SegmentsLiveTimestampTestURL(void)
     XCTAssertNil(self.mediaPlayerController.selectedSegment);
 }
 
+- (void)testSegmentTransitionObserver
+{
+    Segment *segment = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(2., NSEC_PER_SEC), CMTimeMakeWithSeconds(3., NSEC_PER_SEC))];
+    
+    XCTestExpectation *startExpectation = [self expectationWithDescription:@"Segment started"];
+    
+    __block NSInteger count = 0;
+    id observer = [self.mediaPlayerController addSegmentTransitionObserverUsingBlock:^(SRGSegmentTransition transition) {
+        ++count;
+        if (count == 1) {
+            XCTAssertNil(transition.previousSegment);
+            XCTAssertEqual(transition.segment, segment);
+            XCTAssertFalse(transition.selected);
+            XCTAssertFalse(transition.interrupted);
+            XCTAssertEqual(transition.transitionCount, 1);
+            XCTAssertTrue(isnan(transition.lastPlaybackTimeIntervalSinceReferenceDate));
+            TestAssertEqualTimeInSeconds(transition.lastPlaybackTime, 2);
+            [startExpectation fulfill];
+        }
+    }];
+    
+    [self.mediaPlayerController playURL:SegmentsOnDemandTestURL() atPosition:nil withSegments:@[segment] userInfo:nil];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [self.mediaPlayerController removeSegmentTransitionObserver:observer];
+    
+    // No more transitions must be received after removal
+    [self expectationForSingleNotification:SRGMediaPlayerSegmentDidEndNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return YES;
+    }];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    [self expectationForElapsedTimeInterval:1. withHandler:nil];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    XCTAssertEqual(count, 1);
+}
+
+- (void)testSegmentTransitionObserverOverBlockedSegment
+{
+    Segment *segment1 = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(2., NSEC_PER_SEC), CMTimeMakeWithSeconds(3., NSEC_PER_SEC))];
+    Segment *segment2 = [Segment blockedSegmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(5., NSEC_PER_SEC), CMTimeMakeWithSeconds(4., NSEC_PER_SEC))];
+    Segment *segment3 = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(9., NSEC_PER_SEC), CMTimeMakeWithSeconds(4., NSEC_PER_SEC))];
+    
+    XCTestExpectation *startExpectation = [self expectationWithDescription:@"Segment 1 started"];
+    XCTestExpectation *transitionExpectation = [self expectationWithDescription:@"Transition over blocked segment"];
+    
+    // Ending segment 1, skipping the blocked segment and starting segment 3 must be reported as a single transition
+    __block NSInteger count = 0;
+    [self.mediaPlayerController addSegmentTransitionObserverUsingBlock:^(SRGSegmentTransition transition) {
+        ++count;
+        if (count == 1) {
+            XCTAssertNil(transition.previousSegment);
+            XCTAssertEqual(transition.segment, segment1);
+            [startExpectation fulfill];
+        }
+        else if (count == 2) {
+            XCTAssertEqual(transition.previousSegment, segment1);
+            XCTAssertEqual(transition.segment, segment3);
+            XCTAssertFalse(transition.selected);
+            XCTAssertEqual(transition.transitionCount, 2);
+            TestAssertEqualTimeInSeconds(transition.lastPlaybackTime, 5);
+            [transitionExpectation fulfill];
+        }
+        else {
+            XCTFail(@"Unexpected transition");
+        }
+    }];
+    
+    [self.mediaPlayerController playURL:SegmentsOnDemandTestURL() atPosition:nil withSegments:@[segment1, segment2, segment3] userInfo:nil];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+}
+
+- (void)testChildSegmentPlayback
+{
+    Segment *childSegment = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(4., NSEC_PER_SEC), CMTimeMakeWithSeconds(2., NSEC_PER_SEC))];
+    Segment *segment = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(2., NSEC_PER_SEC), CMTimeMakeWithSeconds(10., NSEC_PER_SEC)) childSegments:@[childSegment]];
+    [self.mediaPlayerController playURL:SegmentsOnDemandTestURL() atPosition:nil withSegments:@[segment] userInfo:nil];
+    
+    [self expectationForSingleNotification:SRGMediaPlayerSegmentDidStartNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerSegmentKey], segment);
+        return YES;
+    }];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    XCTAssertEqualObjects(self.mediaPlayerController.currentSegment, segment);
+    XCTAssertNil(self.mediaPlayerController.currentChildSegment);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerChildSegmentDidStartNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerSegmentKey], childSegment);
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerParentSegmentKey], segment);
+        XCTAssertNil(notification.userInfo[SRGMediaPlayerPreviousSegmentKey]);
+        TestAssertEqualTimeInSeconds([notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue], 4);
+        return YES;
+    }];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    XCTAssertEqualObjects(self.mediaPlayerController.currentSegment, segment);
+    XCTAssertEqualObjects(self.mediaPlayerController.currentChildSegment, childSegment);
+    XCTAssertEqualObjects([self.mediaPlayerController segmentChainForTime:self.mediaPlayerController.currentTime], (@[segment, childSegment]));
+    
+    [self expectationForSingleNotification:SRGMediaPlayerChildSegmentDidEndNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerSegmentKey], childSegment);
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerParentSegmentKey], segment);
+        XCTAssertNil(notification.userInfo[SRGMediaPlayerNextSegmentKey]);
+        XCTAssertFalse([notification.userInfo[SRGMediaPlayerInterruptionKey] boolValue]);
+        TestAssertEqualTimeInSeconds([notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue], 6);
+        return YES;
+    }];
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    XCTAssertEqualObjects(self.mediaPlayerController.currentSegment, segment);
+    XCTAssertNil(self.mediaPlayerController.currentChildSegment);
+}
+
 - (void)testSeekIntoSegmentWithoutSelection
 {
     Segment *segment = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(200., NSEC_PER_SEC), CMTimeMakeWithSeconds(60., NSEC_PER_SEC))];
@@ -638,6 +762,38 @@ static NSURL *SegmentsLiveTimestampTestURL(void)
     XCTAssertNil(self.mediaPlayerController.selectedSegment);
 }
 
+- (void)testSeekOutOfSegmentFromBackgroundThread
+{
+    Segment *segment = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(10., NSEC_PER_SEC), CMTimeMakeWithSeconds(60., NSEC_PER_SEC))];
+    
+    // Wait until the player is playing in the segment
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:SegmentsOnDemandTestURL() atPosition:[SRGPosition positionAtTimeInSeconds:20.] withSegments:@[segment] userInfo:nil];
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    XCTAssertEqualObjects(self.mediaPlayerController.currentSegment, segment);
+    
+    // The last playback time must be the one before the seek, even if the seek completion is delivered asynchronously
+    [self expectationForSingleNotification:SRGMediaPlayerSegmentDidEndNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        XCTAssertEqualObjects(notification.userInfo[SRGMediaPlayerSegmentKey], segment);
+        TestAssertEqualTimeInSeconds([notification.userInfo[SRGMediaPlayerLastPlaybackTimeKey] CMTimeValue], 20);
+        return YES;
+    }];
+    
+    SRGPlayer *player = (SRGPlayer *)self.mediaPlayerController.player;
+    dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [player seekToTime:CMTimeMakeWithSeconds(200., NSEC_PER_SEC) toleranceBefore:kCMTimeZero toleranceAfter:kCMTimeZero completionHandler:^(BOOL finished) {}];
+    });
+    
+    [self waitForExpectationsWithTimeout:20. handler:nil];
+    
+    XCTAssertNil(self.mediaPlayerController.currentSegment);
+}
+
 - (void)testSeekIntoSegmentWithSelection
 {
     Segment *segment = [Segment segmentWithTimeRange:CMTimeRangeMake(CMTimeMakeWithSeconds(200., NSEC_PER_SEC), CMTimeMakeWithSeconds(60., NSEC_PER_SEC))];
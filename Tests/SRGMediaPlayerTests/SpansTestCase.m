@@ -0,0 +1,133 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+
+@import SRGMediaPlayer;
+
+static NSURL *OnDemandTestURL(void)
+{
+    return [NSURL URLWithString:@"https://devstreaming-cdn.apple.com/videos/streaming/examples/bipbop_16x9/bipbop_16x9_variant.m3u8"];
+}
+
+@interface SpanRecorder : NSObject <SRGMediaPlayerSpanBackend>
+
+@property (nonatomic) NSMutableDictionary<NSNumber *, NSString *> *openSpans;
+@property (nonatomic) NSMutableArray<NSString *> *closedSpanNames;
+
+@end
+
+@implementation SpanRecorder
+
+- (instancetype)init
+{
+    if (self = [super init]) {
+        self.openSpans = [NSMutableDictionary dictionary];
+        self.closedSpanNames = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)beginSpanWithName:(const char *)name identifier:(uint64_t)identifier
+{
+    @synchronized (self) {
+        self.openSpans[@(identifier)] = @(name);
+    }
+}
+
+- (void)endSpanWithName:(const char *)name identifier:(uint64_t)identifier
+{
+    @synchronized (self) {
+        NSAssert([self.openSpans[@(identifier)] isEqualToString:@(name)], @"Span must have been opened with the same name");
+        self.openSpans[@(identifier)] = nil;
+        [self.closedSpanNames addObject:@(name)];
+    }
+}
+
+@end
+
+@interface SpansTestCase : MediaPlayerBaseTestCase
+
+@property (nonatomic) SRGMediaPlayerController *mediaPlayerController;
+
+@end
+
+@implementation SpansTestCase
+
+#pragma mark Setup and teardown
+
+- (void)setUp
+{
+    self.mediaPlayerController = [[SRGMediaPlayerController alloc] init];
+}
+
+- (void)tearDown
+{
+    SRGMediaPlayerSetSpanBackend(nil);
+    
+    [self.mediaPlayerController reset];
+    self.mediaPlayerController = nil;
+}
+
+#pragma mark Tests
+
+- (void)testDisabledByDefault
+{
+    XCTAssertNil(SRGMediaPlayerSpanBackend());
+}
+
+- (void)testPlayback
+{
+    SpanRecorder *recorder = [[SpanRecorder alloc] init];
+    SRGMediaPlayerSetSpanBackend(recorder);
+    
+    [self expectationForSingleNotification:SRGMediaPlayerPlaybackStateDidChangeNotification object:self.mediaPlayerController handler:^BOOL(NSNotification * _Nonnull notification) {
+        return [notification.userInfo[SRGMediaPlayerPlaybackStateKey] integerValue] == SRGMediaPlayerPlaybackStatePlaying;
+    }];
+    
+    [self.mediaPlayerController playURL:OnDemandTestURL()];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    XCTestExpectation *seekExpectation = [self expectationWithDescription:@"Seek"];
+    [self.mediaPlayerController seekToPosition:[SRGPosition positionAtTimeInSeconds:20.] withCompletionHandler:^(BOOL finished) {
+        [seekExpectation fulfill];
+    }];
+    
+    [self waitForExpectationsWithTimeout:30. handler:nil];
+    
+    @synchronized (recorder) {
+        XCTAssertEqual(recorder.openSpans.count, 0);
+        XCTAssertTrue([recorder.closedSpanNames containsObject:@"prepareToPlay"]);
+        XCTAssertTrue([recorder.closedSpanNames containsObject:@"updatePlaybackInformation"]);
+        XCTAssertTrue([recorder.closedSpanNames containsObject:@"seek"]);
+    }
+}
+
+- (void)testChromeTrace
+{
+    NSURL *fileURL = [NSURL fileURLWithPath:[NSTemporaryDirectory() stringByAppendingPathComponent:@"SpansTestCase.json"]];
+    SRGChromeTraceSpanBackend *backend = [[SRGChromeTraceSpanBackend alloc] initWithFileURL:fileURL];
+    XCTAssertNotNil(backend);
+    
+    [backend beginSpanWithName:"outer" identifier:1];
+    [backend beginSpanWithName:"inner \"quoted\"" identifier:2];
+    [backend endSpanWithName:"inner \"quoted\"" identifier:2];
+    [backend endSpanWithName:"outer" identifier:1];
+    [backend close];
+    
+    // Spans received after closing are discarded
+    [backend beginSpanWithName:"late" identifier:3];
+    
+    NSData *data = [NSData dataWithContentsOfURL:fileURL];
+    NSArray<NSDictionary *> *events = [NSJSONSerialization JSONObjectWithData:data options:0 error:NULL];
+    XCTAssertEqual(events.count, 4);
+    XCTAssertEqualObjects(events[1][@"name"], @"inner \"quoted\"");
+    XCTAssertEqualObjects([events valueForKey:@"ph"], (@[ @"b", @"b", @"e", @"e" ]));
+    XCTAssertEqualObjects([events valueForKey:@"id"], (@[ @1, @2, @2, @1 ]));
+}
+
+@end
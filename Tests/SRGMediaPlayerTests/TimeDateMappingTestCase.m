@@ -0,0 +1,120 @@
+//
+//  Copyright (c) SRG SSR. All rights reserved.
+//
+//  License information is available from the LICENSE file.
+//
+
+#import "MediaPlayerBaseTestCase.h"
+
+@import SRGMediaPlayer;
+
+// Private framework header
+#import "SRGTimeDateMapping.h"
+
+static CMTime TimeInSeconds(NSTimeInterval seconds)
+{
+    return CMTimeMakeWithSeconds(seconds, NSEC_PER_SEC);
+}
+
+@interface TimeDateMappingTestCase : MediaPlayerBaseTestCase
+
+@end
+
+@implementation TimeDateMappingTestCase
+
+#pragma mark Tests
+
+- (void)testEmptyMapping
+{
+    SRGTimeDateMapping *timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:0.5];
+    XCTAssertEqual(timeDateMapping.count, 0);
+    XCTAssertTrue(isnan([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(10.)]));
+    XCTAssertFalse(CMTIME_IS_VALID([timeDateMapping timeForTimeIntervalSinceReferenceDate:1000.]));
+}
+
+- (void)testLinearMapping
+{
+    SRGTimeDateMapping *timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:0.5];
+    XCTAssertTrue([timeDateMapping addSampleWithTime:TimeInSeconds(10.) timeIntervalSinceReferenceDate:1000.]);
+    
+    // Consistent samples are discarded
+    XCTAssertFalse([timeDateMapping addSampleWithTime:TimeInSeconds(20.) timeIntervalSinceReferenceDate:1010.2]);
+    XCTAssertEqual(timeDateMapping.count, 1);
+    
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(0.)], 990., 0.001);
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(30.)], 1020., 0.001);
+    XCTAssertEqualWithAccuracy(CMTimeGetSeconds([timeDateMapping timeForTimeIntervalSinceReferenceDate:1025.]), 35., 0.001);
+    
+    // Invalid samples are ignored
+    XCTAssertFalse([timeDateMapping addSampleWithTime:kCMTimeIndefinite timeIntervalSinceReferenceDate:1000.]);
+    XCTAssertFalse([timeDateMapping addSampleWithTime:TimeInSeconds(40.) timeIntervalSinceReferenceDate:NAN]);
+}
+
+- (void)testDiscontinuity
+{
+    SRGTimeDateMapping *timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:0.5];
+    XCTAssertTrue([timeDateMapping addSampleWithTime:TimeInSeconds(0.) timeIntervalSinceReferenceDate:1000.]);
+    
+    // Dates jump 60 seconds forward at 100 seconds
+    XCTAssertTrue([timeDateMapping addSampleWithTime:TimeInSeconds(100.) timeIntervalSinceReferenceDate:1160.]);
+    XCTAssertEqual(timeDateMapping.count, 2);
+    
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(50.)], 1050., 0.001);
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(150.)], 1210., 0.001);
+    
+    XCTAssertEqualWithAccuracy(CMTimeGetSeconds([timeDateMapping timeForTimeIntervalSinceReferenceDate:1050.]), 50., 0.001);
+    XCTAssertEqualWithAccuracy(CMTimeGetSeconds([timeDateMapping timeForTimeIntervalSinceReferenceDate:1210.]), 150., 0.001);
+    
+    // Dates within the gap are mapped to the discontinuity
+    XCTAssertEqualWithAccuracy(CMTimeGetSeconds([timeDateMapping timeForTimeIntervalSinceReferenceDate:1130.]), 100., 0.001);
+}
+
+- (void)testDrift
+{
+    SRGTimeDateMapping *timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:0.5];
+    
+    // One second of drift per hour, sampled every 10 minutes over 24 hours
+    for (NSInteger i = 0; i <= 144; ++i) {
+        NSTimeInterval time = i * 600.;
+        [timeDateMapping addSampleWithTime:TimeInSeconds(time) timeIntervalSinceReferenceDate:1000. + time * (1. + 1. / 3600.)];
+    }
+    
+    // Only samples needed to stay within tolerance are retained
+    XCTAssertTrue(timeDateMapping.count < 145);
+    
+    for (NSInteger i = 0; i <= 24; ++i) {
+        NSTimeInterval time = i * 3600.;
+        XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(time)], 1000. + time * (1. + 1. / 3600.), 0.6);
+    }
+}
+
+- (void)testOutOfOrderSamples
+{
+    SRGTimeDateMapping *timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:0.5];
+    XCTAssertTrue([timeDateMapping addSampleWithTime:TimeInSeconds(100.) timeIntervalSinceReferenceDate:2100.]);
+    XCTAssertTrue([timeDateMapping addSampleWithTime:TimeInSeconds(0.) timeIntervalSinceReferenceDate:1000.]);
+    XCTAssertEqual(timeDateMapping.count, 2);
+    
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(10.)], 1010., 0.001);
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(110.)], 2110., 0.001);
+}
+
+- (void)testSampleRemoval
+{
+    SRGTimeDateMapping *timeDateMapping = [[SRGTimeDateMapping alloc] initWithTolerance:0.5];
+    [timeDateMapping addSampleWithTime:TimeInSeconds(0.) timeIntervalSinceReferenceDate:1000.];
+    [timeDateMapping addSampleWithTime:TimeInSeconds(100.) timeIntervalSinceReferenceDate:1200.];
+    [timeDateMapping addSampleWithTime:TimeInSeconds(200.) timeIntervalSinceReferenceDate:1400.];
+    XCTAssertEqual(timeDateMapping.count, 3);
+    
+    XCTAssertFalse([timeDateMapping removeSamplesBeforeTime:TimeInSeconds(50.)]);
+    XCTAssertEqual(timeDateMapping.count, 3);
+    
+    // The sample anchoring the specified time is kept
+    XCTAssertTrue([timeDateMapping removeSamplesBeforeTime:TimeInSeconds(150.)]);
+    XCTAssertEqual(timeDateMapping.count, 2);
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(150.)], 1250., 0.001);
+    XCTAssertEqualWithAccuracy([timeDateMapping timeIntervalSinceReferenceDateForTime:TimeInSeconds(250.)], 1450., 0.001);
+}
+
+@end